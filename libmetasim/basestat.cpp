@@ -25,14 +25,8 @@
 
 namespace MetaSim {
     double BaseStat::_TDistr[MAX_DISTR];
-    size_t BaseStat::_totalNumOfExp = 0;
-    size_t BaseStat::_expNum = 0;
-    bool BaseStat::_endOfSim = 0;
-    bool BaseStat::_initFlag = false;
-    Tick BaseStat::_transitory = 0;
     bool TableOutput::_created = false;
     string TableOutput::_fname;
-    BaseStat::List BaseStat::_statList;
 
     // A bunch of customary exception messages
     const char *const EFFECTIVE_ATTACH = "Unhandled attach()!";
@@ -55,20 +49,23 @@ namespace MetaSim {
         {1.708, 2.060},  {1.706, 2.056}, {1.703, 2.052}, {1.701, 2.048},
         {1.699, 2.045},  {1.697, 2.042}};
 
-    BaseStat::BaseStat(std::string n) : _name(n) {
-        _statList.push_back(this);
+    BaseStat::BaseStat(std::string n) :
+        _ctx(&SimulationContext::current()),
+        _name(n) {
+        _ctx->_statList.push_back(this);
     }
 
     BaseStat::~BaseStat() {
-        _statList.remove(this);
+        _ctx->_statList.remove(this);
     }
 
     void BaseStat::init(size_t n) {
-        _totalNumOfExp = n;
-        _endOfSim = false;
-        _initFlag = true;
+        SimulationContext &ctx = SimulationContext::current();
+        ctx._totalNumOfExp = n;
+        ctx._endOfSim = false;
+        ctx._initFlag = true;
 
-        for (auto & stat : _statList) {
+        for (auto & stat : ctx._statList) {
             stat->init();
         }
         // for_each(_statList.begin(), _statList.end(),
@@ -77,15 +74,15 @@ namespace MetaSim {
 
     void BaseStat::init() {
         _exper.clear();
-        _expNum = 0;
+        _ctx->_expNum = 0;
     }
 
     void BaseStat::setTransitory(Tick t) {
-        _transitory = t;
+        SimulationContext::current()._transitory = t;
     }
 
     bool BaseStat::chkTransitory() {
-        if (SIMUL.getTime() >= _transitory)
+        if (SIMUL.getTime() >= getTransitory())
             return false;
         else
             return true;
@@ -110,21 +107,23 @@ namespace MetaSim {
     // Collect all the results
     //
     void BaseStat::endRun() {
-        for_each(_statList.begin(), _statList.end(),
+        SimulationContext &ctx = SimulationContext::current();
+        for_each(ctx._statList.begin(), ctx._statList.end(),
                  std::mem_fn(&BaseStat::collect));
-        if (++_expNum >= MAX_RUN)
+        if (++ctx._expNum >= MAX_RUN)
             throw Exc(TOO_MUCH_RUNS);
     }
 
     void BaseStat::endSim() {
-        _endOfSim = true;
+        SimulationContext::current()._endOfSim = true;
     }
 
     //
     // Initialize all the stat objs and increment expnum
     //
     void BaseStat::newRun() {
-        for_each(_statList.begin(), _statList.end(),
+        SimulationContext &ctx = SimulationContext::current();
+        for_each(ctx._statList.begin(), ctx._statList.end(),
                  std::mem_fn(&BaseStat::initValue));
     }
 
@@ -132,13 +131,13 @@ namespace MetaSim {
     // Returns the mean value calculated over all the experiments
     //
     double BaseStat::getMean() {
-        if (!_endOfSim)
+        if (!_ctx->_endOfSim)
             throw Exc(GET);
-        if (!_initFlag)
+        if (!_ctx->_initFlag)
             throw Exc(NO_INIT);
 
         double sum = accumulate(_exper.begin(), _exper.end(), 0.0);
-        sum /= _expNum;
+        sum /= _ctx->_expNum;
 
         return sum;
     }
@@ -170,33 +169,33 @@ namespace MetaSim {
         double sum = 0;
         double mu; // the mean
 
-        if (!_endOfSim)
+        if (!_ctx->_endOfSim)
             throw Exc(GET);
-        if (!_initFlag)
+        if (!_ctx->_initFlag)
             throw Exc(NO_INIT);
-        if (_expNum < 3)
+        if (_ctx->_expNum < 3)
             throw Exc(NEED_3);
 
         mu = getMean();
 
         sum = accumulate(_exper.begin(), _exper.end(), 0.0, V(mu));
-        return sqrt(sum / ((_expNum - 1) * _expNum));
+        return sqrt(sum / ((_ctx->_expNum - 1) * _ctx->_expNum));
     }
 
     double BaseStat::getConfInterval(CONFIDENCE_INTERVAL c) {
         double mu; // the mean
         double s; // the variance
 
-        if (!_endOfSim)
+        if (!_ctx->_endOfSim)
             throw Exc(GET);
-        if (!_initFlag)
+        if (!_ctx->_initFlag)
             throw Exc(NO_INIT);
-        if (_expNum < 3)
+        if (_ctx->_expNum < 3)
             throw Exc(NEED_3);
 
         mu = getMean();
         s = getVariance();
-        return t_student(c, (unsigned int) _expNum - 1) * s;
+        return t_student(c, (unsigned int) _ctx->_expNum - 1) * s;
     }
 
     void BaseStat::printAll() {
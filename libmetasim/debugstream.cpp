@@ -37,6 +37,7 @@ namespace MetaSim {
     }
 
     void DebugStream::setStream(std::ostream &o) {
+        _os->flush();
         if (_autodelete)
             delete _os;
         _autodelete = false;
@@ -44,6 +45,7 @@ namespace MetaSim {
     }
 
     void DebugStream::setStream(const std::string &filename) {
+        _os->flush();
         if (_autodelete)
             delete _os;
         _autodelete = true;
@@ -69,7 +71,7 @@ namespace MetaSim {
         }
     }
 
-    void DebugStream::enter(std::string s) {
+    void DebugStream::enter(const std::string &s) {
         _dbgStack.push_back(_isDebug);
         std::vector<std::string>::iterator i =
             find(_dbgLevels.begin(), _dbgLevels.end(), s);
@@ -81,11 +83,15 @@ namespace MetaSim {
         _isIndenting = true;
     }
 
-    void DebugStream::enter(std::string s, std::string header) {
+    void DebugStream::enter(const std::string &s, const std::string &h) {
         enter(s);
+        header(h);
+    }
+
+    void DebugStream::header(const std::string &h) {
         if (filter()) {
             indent();
-            (*_os) << header << std::endl;
+            (*_os) << h << '\n';
             resetIndent();
             _indentLevel++;
         }
@@ -24,23 +24,24 @@ namespace MetaSim {
 
     using std::map;
 
-    map<int, Entity *> Entity::_globMap;
-    map<string, Entity *> Entity::_index;
-    int Entity::_IDcount = 0;
-
     void Entity::_init() {
+        _ctx = &SimulationContext::current();
+
+        auto &index = _ctx->_index;
+        auto &idcount = _ctx->_IDcount;
+
         if (_name == "") {
             std::stringstream ss;
-            ss << _IDcount + 1;
+            ss << idcount + 1;
             _name = string(demangle_compiler_name(typeid(*this).name())) + ss.str();
         }
 
-        if (_index.find(_name) != _index.end())
+        if (index.find(_name) != index.end())
             throw Exc("Creating an entity with the same name " + _name);
 
-        _IDcount++;
-        _ID = _IDcount;
-        _globMap[_ID] = this;
+        idcount++;
+        _ID = idcount;
+        _ctx->_globMap[_ID] = this;
 
         DBGENTER(_ENTITY_DBG_LEV);
 
@@ -48,7 +49,7 @@ namespace MetaSim {
         DBGPRINT("Entity type: ", demangle_compiler_name(typeid(*this).name()));
         DBGPRINT("Entity name: ", _name);
 
-        _index[_name] = this;
+        index[_name] = this;
     }
 
     Entity::Entity(const string &n) : _name(n) {
@@ -56,13 +57,13 @@ namespace MetaSim {
     }
 
     Entity::~Entity() {
-        _globMap.erase(_ID);
-        _index.erase(_name);
+        _ctx->_globMap.erase(_ID);
+        _ctx->_index.erase(_name);
     }
 
     Entity::Entity(const Entity &obj) : _name("") {
         std::stringstream ss;
-        ss << obj._name << "_copy_" << _IDcount + 1;
+        ss << obj._name << "_copy_" << SimulationContext::current()._IDcount + 1;
         _name = ss.str();
         _init();
     }
@@ -70,9 +71,10 @@ namespace MetaSim {
     void Entity::callNewRun() {
         typedef map<int, Entity *>::iterator EI;
 
-        EI p = _globMap.begin();
+        auto &globMap = SimulationContext::current()._globMap;
+        EI p = globMap.begin();
 
-        while (p != _globMap.end()) {
+        while (p != globMap.end()) {
             DBGENTER(_ENTITY_DBG_LEV);
             DBGPRINT("Calling the newRun() of ", p->second->getID());
 
@@ -84,8 +86,9 @@ namespace MetaSim {
     void Entity::callEndRun() {
         typedef map<int, Entity *>::iterator EI;
 
-        EI p = _globMap.begin();
-        while (p != _globMap.end()) {
+        auto &globMap = SimulationContext::current()._globMap;
+        EI p = globMap.begin();
+        while (p != globMap.end()) {
             p->second->endRun();
             p++;
         }
@@ -96,8 +99,9 @@ namespace MetaSim {
 
         typedef map<string, Entity *>::iterator NI;
 
-        NI i = _index.find(n);
-        if (i != _index.end())
+        auto &index = SimulationContext::current()._index;
+        NI i = index.find(n);
+        if (i != index.end())
             res = (*i).second;
         return res;
     }
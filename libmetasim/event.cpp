@@ -11,6 +11,7 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <typeinfo>
@@ -23,26 +24,23 @@
 // #include <metasim/demangle.hpp>
 
 namespace MetaSim {
-    /** ------------------------------------------------------------
-     * Initialize static members of class Event
-     * ------------------------------------------------------------
-     */
-    Event::EventQueue Event::_eventQueue;
-
-    long Event::counter = 0;
-
     /**
      * Constructor for Event.
      */
     Event::Event(const std::string &name, int p) :
-        _name(name),
+        Event(intern_string(name), p) {}
+
+    Event::Event(const std::string *name, int p) :
+        _ctx(NULL),
         _order(0),
         _isInQueue(false),
+        _queueHandle(0),
         _particles(),
         _time(MAXTICK),
         _lastTime(MAXTICK),
         _priority(p),
         _std_priority(p),
+        _name(name),
         _disposable(false) {}
 
     // Event::Event(int p) : Event(demangle_compiler_name(typeid(*this).name()),
@@ -54,8 +52,10 @@ namespace MetaSim {
 
     // Copy constructor
     Event::Event(const Event &e) :
+        _ctx(NULL),
         _order(0),
         _isInQueue(false),
+        _queueHandle(0),
         _particles(),
         _time(MAXTICK),
         _lastTime(MAXTICK),
@@ -108,22 +108,17 @@ namespace MetaSim {
 
         setTime(myTime);
 
-        _order = counter++;
+        _ctx = &SimulationContext::current();
+        _order = _ctx->_eventCounter++;
 
-        std::pair<EventQueue::iterator, bool> p;
-        p = _eventQueue.insert(this);
-
-        if (!p.second) {
-            std::stringstream str;
-            str << "Time: " << SIMUL.getTime() << " -- Posting event"
-                << toString() // demangle_compiler_name(typeid(*this).name())
-                << " Already in queue!, at time = " << myTime;
-            throw Exc(str.str());
-        }
+        _ctx->_eventQueue->insert(this);
 
         _isInQueue = true;
         _disposable = disp;
 
+        if (_ctx->_profiler.isEnabled())
+            _ctx->_profiler.onPost(*this);
+
         DBGENTER(_EVENT_DBG_LEV);
         print();
     }
@@ -133,10 +128,24 @@ namespace MetaSim {
         DBGENTER(_EVENT_DBG_LEV);
         print();
 
-        _eventQueue.erase(this);
-        _isInQueue = false;
+        if (_isInQueue && _ctx->_profiler.isEnabled())
+            _ctx->_profiler.onDrop(*this);
+        extract();
     };
 
+    void Event::extract() {
+        if (_isInQueue)
+            _ctx->_eventQueue->erase(this);
+        _isInQueue = false;
+    }
+
+    void Event::setEventQueue(std::unique_ptr<EventQueue> q) {
+        SimulationContext &ctx = SimulationContext::current();
+        if (!ctx._eventQueue->empty())
+            throw Exc("Cannot replace the event queue while not empty");
+        ctx.setEventQueue(std::move(q));
+    }
+
     void Event::process(bool disp) {
         DBGENTER(_EVENT_DBG_LEV);
         drop();
@@ -166,6 +175,12 @@ namespace MetaSim {
         // restore old priority
         restorePriority();
 
+        Profiler &prof = _ctx->_profiler;
+        if (prof.isEnabled()) {
+            profiledAction(prof);
+            return;
+        }
+
         // the doit(), probe() and record() could raise
         // arbitrary exception...  hence, I can't specify the
         // exception type in the interface!
@@ -184,9 +199,29 @@ namespace MetaSim {
         }
     }
 
+    // same as the second part of action(), but measuring the
+    // time spent in the handler and in the probes
+    void Event::profiledAction(Profiler &prof) {
+        typedef std::chrono::steady_clock clock;
+
+        auto t0 = clock::now();
+        doit();
+        auto t1 = clock::now();
+        for (auto &p : _particles)
+            p->probe();
+        auto t2 = clock::now();
+
+        prof.onFire(*this,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        t1 - t0).count(),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        t2 - t1).count(),
+                    _particles.size());
+    }
+
     // DEBUG!!! Prints events data on the dbg stream.
     void Event::print() {
-        DBGPRINT("t=[", _time, "] prio=[", _priority, "] event_type=", _name,
+        DBGPRINT("t=[", _time, "] prio=[", _priority, "] event_type=", *_name,
                  " event=", toString());
     }
 
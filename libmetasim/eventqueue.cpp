@@ -0,0 +1,331 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <limits>
+
+#include <metasim/event.hpp>
+#include <metasim/eventqueue.hpp>
+
+#ifndef METASIM_EVENT_QUEUE_DEFAULT
+#define METASIM_EVENT_QUEUE_DEFAULT "heap"
+#endif
+
+namespace MetaSim {
+
+    // ------------------------------------------------------------
+    // EventQueue
+    // ------------------------------------------------------------
+
+    std::unique_ptr<EventQueue> EventQueue::create(const std::string &type) {
+        const std::string t = type.empty() ? defaultType() : type;
+
+        if (t == "set")
+            return std::make_unique<SetEventQueue>();
+        if (t == "heap")
+            return std::make_unique<HeapEventQueue>();
+        if (t == "calendar")
+            return std::make_unique<CalendarEventQueue>();
+
+        throw Exc("Unknown event queue type: " + t);
+    }
+
+    std::string EventQueue::defaultType() {
+        return METASIM_EVENT_QUEUE_DEFAULT;
+    }
+
+    EventQueue::Entry EventQueue::makeEntry(Event *e) {
+        return Entry{e->_time, e->_priority, e->_order, e};
+    }
+
+    std::size_t &EventQueue::handle(Event *e) {
+        return e->_queueHandle;
+    }
+
+    // ------------------------------------------------------------
+    // SetEventQueue
+    // ------------------------------------------------------------
+
+    void SetEventQueue::insert(Event *e) {
+        if (!_set.insert(makeEntry(e)).second)
+            throw Exc("Event " + e->toString() + " already in queue");
+    }
+
+    void SetEventQueue::erase(Event *e) {
+        if (_set.erase(makeEntry(e)) == 0)
+            throw Exc("Event " + e->toString() + " not in queue");
+    }
+
+    Event *SetEventQueue::front() {
+        if (_set.empty())
+            return NULL;
+        return _set.begin()->event;
+    }
+
+    bool SetEventQueue::empty() const {
+        return _set.empty();
+    }
+
+    std::size_t SetEventQueue::size() const {
+        return _set.size();
+    }
+
+    std::vector<Event *> SetEventQueue::getEvents() const {
+        std::vector<Event *> v;
+        v.reserve(_set.size());
+        for (const auto &e : _set)
+            v.push_back(e.event);
+        return v;
+    }
+
+    // ------------------------------------------------------------
+    // HeapEventQueue
+    // ------------------------------------------------------------
+
+    void HeapEventQueue::place(std::size_t pos, const Entry &e) {
+        _heap[pos] = e;
+        handle(e.event) = pos;
+    }
+
+    void HeapEventQueue::siftUp(std::size_t pos, Entry e) {
+        while (pos > 0) {
+            std::size_t parent = (pos - 1) / ARITY;
+            if (!(e < _heap[parent]))
+                break;
+            place(pos, _heap[parent]);
+            pos = parent;
+        }
+        place(pos, e);
+    }
+
+    void HeapEventQueue::siftDown(std::size_t pos, Entry e) {
+        const std::size_t n = _heap.size();
+
+        while (true) {
+            std::size_t first = pos * ARITY + 1;
+            if (first >= n)
+                break;
+
+            std::size_t last = std::min(first + ARITY, n);
+            std::size_t best = first;
+            for (std::size_t c = first + 1; c < last; ++c)
+                if (_heap[c] < _heap[best])
+                    best = c;
+
+            if (!(_heap[best] < e))
+                break;
+            place(pos, _heap[best]);
+            pos = best;
+        }
+        place(pos, e);
+    }
+
+    void HeapEventQueue::insert(Event *e) {
+        _heap.emplace_back();
+        siftUp(_heap.size() - 1, makeEntry(e));
+    }
+
+    void HeapEventQueue::erase(Event *e) {
+        std::size_t pos = handle(e);
+        if (pos >= _heap.size() || _heap[pos].event != e)
+            throw Exc("Event " + e->toString() + " not in queue");
+
+        Entry last = _heap.back();
+        _heap.pop_back();
+        if (pos == _heap.size())
+            return;
+
+        if (pos > 0 && last < _heap[(pos - 1) / ARITY])
+            siftUp(pos, last);
+        else
+            siftDown(pos, last);
+    }
+
+    Event *HeapEventQueue::front() {
+        if (_heap.empty())
+            return NULL;
+        return _heap.front().event;
+    }
+
+    bool HeapEventQueue::empty() const {
+        return _heap.empty();
+    }
+
+    std::size_t HeapEventQueue::size() const {
+        return _heap.size();
+    }
+
+    std::vector<Event *> HeapEventQueue::getEvents() const {
+        std::vector<Entry> sorted(_heap);
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<Event *> v;
+        v.reserve(sorted.size());
+        for (const auto &e : sorted)
+            v.push_back(e.event);
+        return v;
+    }
+
+    // ------------------------------------------------------------
+    // CalendarEventQueue
+    // ------------------------------------------------------------
+
+    CalendarEventQueue::CalendarEventQueue() :
+        _buckets(MIN_BUCKETS),
+        _width(1),
+        _size(0),
+        _cursor(0),
+        _cursorStart(0),
+        _cursorValid(false) {}
+
+    void CalendarEventQueue::insert(Event *e) {
+        Entry entry = makeEntry(e);
+
+        // Inserting before the interval of the last search (e.g.,
+        // after the time has been reset for a new run)
+        if (_cursorValid && entry.time < _cursorStart)
+            _cursorValid = false;
+
+        auto &b = _buckets[bucketOf(entry.time)];
+        auto it = std::lower_bound(b.begin(), b.end(), entry, later);
+        b.insert(it, entry);
+
+        if (++_size > 2 * _buckets.size())
+            resize(2 * _buckets.size());
+    }
+
+    void CalendarEventQueue::erase(Event *e) {
+        Entry entry = makeEntry(e);
+
+        auto &b = _buckets[bucketOf(entry.time)];
+        auto it = std::lower_bound(b.begin(), b.end(), entry, later);
+        if (it == b.end() || it->event != e)
+            throw Exc("Event " + e->toString() + " not in queue");
+        b.erase(it);
+
+        if (--_size < _buckets.size() / 4 && _buckets.size() > MIN_BUCKETS)
+            resize(_buckets.size() / 2);
+    }
+
+    Event *CalendarEventQueue::front() {
+        if (_size == 0)
+            return NULL;
+
+        const std::size_t nb = _buckets.size();
+        const Tick::impl_t maxstart =
+            std::numeric_limits<Tick::impl_t>::max() - _width;
+
+        // Scan at most one year from the last position
+        if (_cursorValid) {
+            Tick::impl_t start = _cursorStart;
+            for (std::size_t k = 0; k < nb; ++k) {
+                std::size_t i = (_cursor + k) & (nb - 1);
+                const auto &b = _buckets[i];
+                if (!b.empty() && b.back().time - start < _width) {
+                    _cursor = i;
+                    _cursorStart = start;
+                    return b.back().event;
+                }
+                if (start > maxstart)
+                    break;
+                start += _width;
+            }
+        }
+
+        // Direct search among the first event of each bucket
+        const Entry *min = NULL;
+        for (const auto &b : _buckets)
+            if (!b.empty() && (min == NULL || b.back() < *min))
+                min = &b.back();
+
+        _cursor = bucketOf(min->time);
+        _cursorStart = min->time - min->time % _width;
+        _cursorValid = true;
+        return min->event;
+    }
+
+    bool CalendarEventQueue::empty() const {
+        return _size == 0;
+    }
+
+    std::size_t CalendarEventQueue::size() const {
+        return _size;
+    }
+
+    std::vector<Event *> CalendarEventQueue::getEvents() const {
+        std::vector<Entry> sorted;
+        sorted.reserve(_size);
+        for (const auto &b : _buckets)
+            sorted.insert(sorted.end(), b.begin(), b.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<Event *> v;
+        v.reserve(sorted.size());
+        for (const auto &e : sorted)
+            v.push_back(e.event);
+        return v;
+    }
+
+    Tick::impl_t
+        CalendarEventQueue::estimateWidth(const std::vector<Entry> &sorted) const {
+        // Average separation of the earliest events, ignoring events
+        // with the same time and then the gaps much larger than the
+        // average, as in the original paper
+        const std::size_t samples = std::min<std::size_t>(sorted.size(), 25);
+
+        Tick::impl_t sum = 0;
+        std::size_t count = 0;
+        for (std::size_t i = 1; i < samples; ++i) {
+            Tick::impl_t gap = sorted[i].time - sorted[i - 1].time;
+            if (gap > 0) {
+                sum += gap;
+                ++count;
+            }
+        }
+        if (count == 0)
+            return _width;
+
+        Tick::impl_t avg = sum / count;
+        sum = 0;
+        count = 0;
+        for (std::size_t i = 1; i < samples; ++i) {
+            Tick::impl_t gap = sorted[i].time - sorted[i - 1].time;
+            if (gap > 0 && gap <= 2 * avg) {
+                sum += gap;
+                ++count;
+            }
+        }
+        if (count > 0)
+            avg = sum / count;
+
+        return std::max<Tick::impl_t>(1, 3 * avg);
+    }
+
+    void CalendarEventQueue::resize(std::size_t nbuckets) {
+        std::vector<Entry> all;
+        all.reserve(_size);
+        for (const auto &b : _buckets)
+            all.insert(all.end(), b.begin(), b.end());
+        std::sort(all.begin(), all.end());
+
+        _width = estimateWidth(all);
+        _buckets.assign(nbuckets, {});
+
+        // Visiting in reverse order keeps each bucket sorted
+        for (auto it = all.rbegin(); it != all.rend(); ++it)
+            _buckets[bucketOf(it->time)].push_back(*it);
+
+        _cursorValid = false;
+    }
+
+} // namespace MetaSim
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <metasim/basetype.hpp>
+#include <metasim/simcontext.hpp>
 
 namespace MetaSim {
 
@@ -91,10 +92,14 @@ namespace MetaSim {
     private:
         static const int MAX_DISTR = 10000;
         static double _TDistr[MAX_DISTR];
-        static size_t _totalNumOfExp;
-        static size_t _expNum;
-        static bool _endOfSim;
-        static List _statList;
+
+        /// Merges the results of parallel replications.
+        friend class ReplicationRunner;
+
+        /// The context this stat object belongs to. The list of
+        /// all the stat objects and the number of runs are kept in
+        /// the SimulationContext.
+        SimulationContext *_ctx;
 
     protected:
         /**
@@ -124,20 +129,18 @@ namespace MetaSim {
         /** called at the end of the run, puts the current
             value in the array of experiments. */
         inline void collect() {
-            if (_exper.size() <= _expNum)
+            if (_exper.size() <= _ctx->_expNum)
                 _exper.push_back(_val);
             else
-                _exper[_expNum] = _val;
+                _exper[_ctx->_expNum] = _val;
         }
 
         // System-Wide data & functions needed to be visible
         // also to other kind of stats!
-        /// lenght of the transitory.
-        static Tick _transitory;
-
-        /// used to see if the base stat class has been
-        /// initialized. (???)
-        static bool _initFlag;
+        /// lenght of the transitory (of the current context).
+        static Tick getTransitory() {
+            return SimulationContext::current()._transitory;
+        }
 
         /// t-student function
         static double get_t_perc(double alpha);
@@ -155,10 +158,10 @@ namespace MetaSim {
 
         typedef List::const_iterator iterator;
         static inline iterator begin() {
-            return _statList.begin();
+            return SimulationContext::current()._statList.begin();
         }
         static inline iterator end() {
-            return _statList.end();
+            return SimulationContext::current()._statList.end();
         }
 
         /**
@@ -212,8 +215,8 @@ namespace MetaSim {
            Returns the data collected in the last run
         */
         inline double getLastValue() {
-            if (_expNum > 0)
-                return _exper[_expNum - 1];
+            if (_ctx->_expNum > 0)
+                return _exper[_ctx->_expNum - 1];
             else
                 return 0;
         }
@@ -240,7 +243,7 @@ namespace MetaSim {
 
         // debug!!
         inline size_t getExpNum() {
-            return _expNum;
+            return _ctx->_expNum;
         }
         static void printAll();
         void print();
@@ -71,14 +71,20 @@ namespace MetaSim {
          *  the next call to enter(), every output on the debug stream
          *  is considered belonging to the current debug level.
          */
-        void enter(std::string s);
+        void enter(const std::string &s);
 
         /**
          *  Enters in the specified debug level and output the header string.
          *  From this point until the next call to enter(), every output on the
          *  debug stream is considered in the the current debug level.
          */
-        void enter(std::string s, std::string header);
+        void enter(const std::string &s, const std::string &header);
+
+        /**
+         *  Outputs the header string of the current debug level, if
+         *  enabled, and indents the following output.
+         */
+        void header(const std::string &h);
 
         /**
          *  Exits from the current debug level.
@@ -104,7 +110,7 @@ namespace MetaSim {
 
     /** Template definition of operator << on DebugStream */
     template <class T>
-    inline DebugStream &operator<<(DebugStream &s, T obj) {
+    inline DebugStream &operator<<(DebugStream &s, const T &obj) {
         if (s.filter()) {
             s.indent();
             s.getStream() << obj;
@@ -128,12 +134,14 @@ namespace std {
        \ingroup metasim_util
 
        Specialization of std::endl: must be in namespace std
-       to override the standard std::endl() function
+       to override the standard std::endl() function.
+
+       The stream is not flushed, to keep the debug output buffered.
     */
     inline MetaSim::DebugStream &endl(MetaSim::DebugStream &s) {
         if (s.filter()) {
             s.resetIndent();
-            s.getStream() << std::endl;
+            s.getStream() << '\n';
         }
         return s;
     }
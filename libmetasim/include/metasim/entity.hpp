@@ -34,6 +34,7 @@
 
 #include <metasim/baseexc.hpp>
 #include <metasim/basetype.hpp>
+#include <metasim/simcontext.hpp>
 
 namespace MetaSim {
     using std::string;
@@ -75,19 +76,14 @@ namespace MetaSim {
 
     private:
         /**
-    It contains pairs <ID, pointer to entity>. It's
-    used mainly to keep track of all the entities
-    present in the system. */
-        static std::map<int, Entity *> _globMap;
-
-        /**
-           It contains pairs <string, pointer to entity>. It
-           is used to refer entities by name. The string must
-           be unique!! */
-        static std::map<std::string, Entity *> _index;
-
-        /// counter for assigning unique IDs to entities
-        static int _IDcount;
+           The context this entity is registered in. The
+           registry (pairs <ID, pointer to entity> and pairs
+           <name, pointer to entity>) and the counter for
+           assigning unique IDs are kept in the
+           SimulationContext; names must be unique only within
+           the same context.
+        */
+        SimulationContext *_ctx;
 
         /// unique ID for the entity
         int _ID;
@@ -132,8 +128,9 @@ namespace MetaSim {
             to that ID, or NULL if it doesn't exist an object
             with that ID. */
         static inline Entity *getPointer(int id) {
-            std::map<int, Entity *>::const_iterator p = _globMap.find(id);
-            if (p == _globMap.end())
+            const auto &globMap = SimulationContext::current()._globMap;
+            std::map<int, Entity *>::const_iterator p = globMap.find(id);
+            if (p == globMap.end())
                 return NULL;
             else
                 return p->second;
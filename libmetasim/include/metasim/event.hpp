@@ -1,15 +1,18 @@
 #ifndef __EVENT_HPP__
 #define __EVENT_HPP__
 
-#include <deque>
 #include <iosfwd>
 #include <limits>
 #include <metasim/memory.hpp>
 #include <typeinfo>
+#include <vector>
 
 #include <metasim/basestat.hpp>
+#include <metasim/eventqueue.hpp>
 #include <metasim/particle.hpp>
 #include <metasim/plist.hpp>
+#include <metasim/pool.hpp>
+#include <metasim/simcontext.hpp>
 #include <metasim/simul.hpp>
 #include <metasim/trace.hpp>
 
@@ -29,7 +32,7 @@ namespace MetaSim {
         need to derive a class from this, overriding the virtual
         doit() method.
 
-        This class also inclides a static qevent queue, where all
+        Each SimulationContext includes an event queue, where all
         "active" events are enqueued. To insert an event in the
         queue, you can call the post() method specyfing a
         triggering time. Events are ordered in the queue by
@@ -91,18 +94,26 @@ namespace MetaSim {
             bool operator()(Event *e1, Event *e2) const;
         };
 
-        typedef priority_list<Event *, Cmp> EventQueue;
+        /// The queue backends read the ordering key and the
+        /// handle of the events.
+        friend class EventQueue;
 
-        /**
-           Event queue. This is the global event queue, used
-           by the simulation engine.
-        */
-        static EventQueue _eventQueue;
+        /// The simulation engine extracts the events to be fired.
+        friend class Simulation;
+
+        /// Removes the event from the queue (if any) without
+        /// counting it as dropped.
+        void extract();
+
+        /// The part of action() that calls the handler and the
+        /// probes, when the profiler is enabled.
+        void profiledAction(Profiler &prof);
 
         /**
-           counter for fifo insertion
+           The context whose event queue contains this event
+           (meaningful only while the event is in the queue).
         */
-        static long counter;
+        SimulationContext *_ctx;
 
         /**
            number of fifo insertion
@@ -112,10 +123,14 @@ namespace MetaSim {
         /// Tells if the element is in the event queue;
         bool _isInQueue;
 
+        /// Position of the event inside the queue backend, its
+        /// meaning depends on the backend.
+        std::size_t _queueHandle;
+
         /// A queue of all the statistical object. All these
         /// objects will be "invoked" after the event handler
         /// (doit()) has been processed.
-        std::deque<std::unique_ptr<ParticleInterface>> _particles;
+        std::vector<std::unique_ptr<ParticleInterface>> _particles;
 
         /// Triggering time of the event.
         Tick _time;
@@ -137,7 +152,9 @@ namespace MetaSim {
 
         int _std_priority;
 
-        std::string _name;
+        /// Name of the event, shared by all the events with the
+        /// same name.
+        const std::string *_name;
 
         /// We hide operator= to avoid improper use.
         Event &operator=(Event &);
@@ -174,9 +191,30 @@ namespace MetaSim {
         // Event(int p = _DEFAULT_PRIORITY);
         Event(const std::string & name, int p = _DEFAULT_PRIORITY);
 
+        /**
+            Same as above, with a name already returned by
+            intern_string(). Events created at a high rate (e.g.
+            disposable ones) intern their name once, in a static,
+            and use this constructor.
+        */
+        Event(const std::string *name, int p = _DEFAULT_PRIORITY);
+
         /// Destructor.
         virtual ~Event();
 
+        /**
+            Events are allocated from the SmallObjectPool, so that
+            creating and disposing events (see post()) does not
+            call the global allocator in steady state.
+        */
+        static void *operator new(std::size_t size) {
+            return SmallObjectPool::allocate(size);
+        }
+
+        static void operator delete(void *p, std::size_t size) noexcept {
+            SmallObjectPool::deallocate(p, size);
+        }
+
         /**
             Inserts the event into the event queue. If the
             event is already in the event queue, an exception
@@ -216,16 +254,31 @@ namespace MetaSim {
         virtual void drop();
 
         /**
-            Returns the first event in the event queue.  This
+            Returns the first event in the event queue of the
+            current context.  This
             function is used by the main simulation engine and
             should never be called directly by any other
             object. The event is not extracted from the queue
         */
         static inline Event *getFirst() {
-            if (_eventQueue.empty())
-                return NULL;
-            else
-                return _eventQueue.front();
+            return SimulationContext::current()._eventQueue->front();
+        }
+
+        /**
+            Replaces the event queue backend of the current
+            context. The current queue must be empty, hence this function must be called
+            before starting the simulation (or between two
+            simulations). Throws an exception otherwise.
+
+            @see Simulation::setEventQueue
+        */
+        static void setEventQueue(std::unique_ptr<EventQueue> q);
+
+        /**
+            Returns the event queue backend of the current context.
+        */
+        static const EventQueue &getEventQueue() {
+            return *SimulationContext::current()._eventQueue;
         }
 
         /**
@@ -339,14 +392,12 @@ namespace MetaSim {
             for debugging
         */
         static void printQueue() {
-            EventQueue::iterator it;
-
-            for (it = _eventQueue.begin(); it != _eventQueue.end(); it++)
-                (*it)->print();
+            for (Event *e : SimulationContext::current()._eventQueue->getEvents())
+                e->print();
         }
 
         virtual std::string toString() const {
-            return _name;
+            return *_name;
         }
     };
 
@@ -0,0 +1,230 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __EVENTQUEUE_HPP__
+#define __EVENTQUEUE_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <metasim/baseexc.hpp>
+#include <metasim/tick.hpp>
+
+namespace MetaSim {
+
+    class Event;
+
+    /**
+        \ingroup metasim_ee
+
+        Abstract interface of the global event queue.
+
+        The simulation engine only needs to insert an event, remove
+        an arbitrary event and peek the first one. Different
+        implementations of this interface trade memory layout and
+        complexity in different ways; all of them must order events
+        exactly like Event::Cmp does, that is by triggering time,
+        then by priority and finally by posting order, so that the
+        outcome of a simulation does not depend on the backend.
+
+        An event that is in the queue cannot change its time or
+        priority: backends are allowed to cache the ordering key of
+        the event at insertion time.
+
+        Backends are selected by name through create(). The default
+        one is chosen at configure time (METASIM_EVENT_QUEUE CMake
+        cache variable) and can be replaced before starting the
+        simulation with Simulation::setEventQueue().
+    */
+    class EventQueue {
+    public:
+        /**
+           \ingroup metasim_exc
+
+           Exceptions for the EventQueue classes.
+        */
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "EventQueue",
+                const std::string md = "eventqueue.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        virtual ~EventQueue() = default;
+
+        /// Inserts an event, which must not be in the queue already.
+        virtual void insert(Event *e) = 0;
+
+        /// Removes an event, which must be in the queue.
+        virtual void erase(Event *e) = 0;
+
+        /// Returns the first event without removing it, or NULL
+        /// if the queue is empty.
+        virtual Event *front() = 0;
+
+        virtual bool empty() const = 0;
+
+        virtual std::size_t size() const = 0;
+
+        /// Returns all the queued events in order. Expensive, to be
+        /// used only for debugging.
+        virtual std::vector<Event *> getEvents() const = 0;
+
+        /// Name of the backend, as accepted by create().
+        virtual std::string getName() const = 0;
+
+        /**
+           Creates a new empty queue. Recognized types are "set",
+           "heap" and "calendar"; an empty string selects the
+           default backend.
+        */
+        static std::unique_ptr<EventQueue> create(const std::string &type = "");
+
+        /// Name of the backend chosen at configure time.
+        static std::string defaultType();
+
+    protected:
+        /**
+           Ordering key of a queued event. It is copied out of the
+           event when the event is inserted, so that comparisons do
+           not need to dereference event pointers.
+        */
+        struct Entry {
+            Tick::impl_t time;
+            int priority;
+            unsigned long order;
+            Event *event;
+
+            bool operator<(const Entry &o) const {
+                if (time != o.time)
+                    return time < o.time;
+                if (priority != o.priority)
+                    return priority < o.priority;
+                return order < o.order;
+            }
+        };
+
+        static Entry makeEntry(Event *e);
+
+        /// Backend-specific position of the event in the queue.
+        static std::size_t &handle(Event *e);
+    };
+
+    /**
+        The original backend: a balanced binary tree (std::set)
+        of ordering keys.
+    */
+    class SetEventQueue : public EventQueue {
+    public:
+        void insert(Event *e) override;
+        void erase(Event *e) override;
+        Event *front() override;
+        bool empty() const override;
+        std::size_t size() const override;
+        std::vector<Event *> getEvents() const override;
+        std::string getName() const override {
+            return "set";
+        }
+
+    private:
+        std::set<Entry> _set;
+    };
+
+    /**
+        Implicit d-ary min-heap stored in a contiguous array of
+        ordering keys. Every event records its position in the
+        array, hence an arbitrary event can be removed in O(log n)
+        without searching for it.
+    */
+    class HeapEventQueue : public EventQueue {
+    public:
+        /// Number of children of each node. Four children keep a
+        /// whole family in a single cache line.
+        static const std::size_t ARITY = 4;
+
+        void insert(Event *e) override;
+        void erase(Event *e) override;
+        Event *front() override;
+        bool empty() const override;
+        std::size_t size() const override;
+        std::vector<Event *> getEvents() const override;
+        std::string getName() const override {
+            return "heap";
+        }
+
+    private:
+        std::vector<Entry> _heap;
+
+        void place(std::size_t pos, const Entry &e);
+        void siftUp(std::size_t pos, Entry e);
+        void siftDown(std::size_t pos, Entry e);
+    };
+
+    /**
+        Calendar queue (R. Brown, 1988). Events are hashed on their
+        triggering time into an array of buckets, each one covering
+        an interval of the same width; each bucket is kept sorted.
+        The number of buckets follows the number of queued events
+        and the width is re-estimated from the spacing of the
+        earliest events on each resize. When the events are dense
+        in the near future, as with periodic real-time workloads,
+        insertion and extraction cost O(1) on average.
+    */
+    class CalendarEventQueue : public EventQueue {
+    public:
+        CalendarEventQueue();
+
+        void insert(Event *e) override;
+        void erase(Event *e) override;
+        Event *front() override;
+        bool empty() const override;
+        std::size_t size() const override;
+        std::vector<Event *> getEvents() const override;
+        std::string getName() const override {
+            return "calendar";
+        }
+
+    private:
+        static const std::size_t MIN_BUCKETS = 16;
+
+        /// Each bucket is sorted in decreasing order, so its first
+        /// event is at the back
+        std::vector<std::vector<Entry>> _buckets;
+        Tick::impl_t _width;
+        std::size_t _size;
+
+        /// Bucket where the last search for the first event
+        /// stopped, and the start of the interval it covered
+        std::size_t _cursor;
+        Tick::impl_t _cursorStart;
+        bool _cursorValid;
+
+        static bool later(const Entry &a, const Entry &b) {
+            return b < a;
+        }
+
+        std::size_t bucketOf(Tick::impl_t t) const {
+            return std::size_t(t / _width) & (_buckets.size() - 1);
+        }
+
+        void resize(std::size_t nbuckets);
+        Tick::impl_t estimateWidth(const std::vector<Entry> &sorted) const;
+    };
+
+} // namespace MetaSim
+
+#endif
@@ -21,6 +21,7 @@
 #define __PARTICLE_HPP__
 
 #include <metasim/memory.hpp>
+#include <metasim/pool.hpp>
 
 namespace MetaSim {
 
@@ -42,6 +43,15 @@ namespace MetaSim {
         virtual void probe() = 0;
 
         virtual void clone_to(Event &e) = 0;
+
+        /// Particles are allocated from the SmallObjectPool.
+        static void *operator new(std::size_t size) {
+            return SmallObjectPool::allocate(size);
+        }
+
+        static void operator delete(void *p, std::size_t size) noexcept {
+            SmallObjectPool::deallocate(p, size);
+        }
     };
 
     /**
@@ -0,0 +1,150 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PARTITION_HPP__
+#define __PARTITION_HPP__
+
+#include <vector>
+
+#include <metasim/baseexc.hpp>
+#include <metasim/simcontext.hpp>
+#include <metasim/tick.hpp>
+
+namespace MetaSim {
+
+    class Event;
+
+    /**
+        \ingroup metasim_ee
+
+        Executes a simulation partitioned in loosely coupled
+        parts, one thread per part, with a conservative
+        synchronization protocol.
+
+        Each partition is a SimulationContext with its own event
+        queue, entities and statistics. The partitions only
+        interact by sending events to each other with send(),
+        and the model guarantees a <i>lookahead</i> L: an event
+        executed at time t never sends an event for a time
+        earlier than t + L.
+
+        The simulation advances in time windows. If T is the
+        time of the earliest event in all the partitions, all
+        the events before T + L are safe and the partitions
+        execute them in parallel. Then, at the barrier, the
+        events sent during the window are posted in their
+        destination partition, in a fixed order (by sending
+        partition, then in sending order), and the next window
+        starts. Hence, the result does not depend on the
+        number of threads nor on their timing. Partitions that
+        never interact (e.g., the CPUs of a partitioned system
+        without shared resources) can use MAXTICK as lookahead,
+        and run in a single window.
+
+        Each partition executes its events in the same order
+        as a sequential run of the partition alone would. Only
+        the relative order of simultaneous events of different
+        partitions is lost, so outputs shared among partitions
+        (e.g., a single trace file) must be kept separate.
+
+        In rtsim, a partitioned System built with the parallel
+        option (rtsim --parallel) runs each CPU in its own
+        partition.
+
+        @code
+        std::vector<std::unique_ptr<SimulationContext>> ctx;
+        for (int i = 0; i < 8; ++i) {
+            ctx.emplace_back(new SimulationContext());
+            SimulationContext::Scope scope(*ctx.back());
+            build_partition(i);
+        }
+        PartitionedRunner runner(ctx_pointers, lookahead);
+        runner.run(100000);
+        @endcode
+    */
+    class PartitionedRunner {
+    public:
+        /**
+           \ingroup metasim_exc
+
+           Exceptions for the PartitionedRunner class.
+        */
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "PartitionedRunner",
+                const std::string md = "partition.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /**
+           @param partitions The contexts of the partitions, in a
+           fixed order; the models must have been already built
+           in each one of them.
+           @param lookahead The minimum delay of the events sent
+           between partitions; it must be positive.
+        */
+        PartitionedRunner(const std::vector<SimulationContext *> &partitions,
+                          Tick lookahead);
+
+        /**
+           Executes one run of all the partitions, including all
+           the events before endTick. Each partition is
+           initialized and finalized as in Simulation::run(), and
+           so are its statistics.
+        */
+        void run(Tick endTick);
+
+        /**
+           Posts event e at time t in the given partition, at the
+           end of the current window. Must be called from an
+           event handler of a partition of this runner, and t
+           must respect the lookahead. The event is owned by the
+           runner until it is posted (disposable events are
+           deleted if the run ends before).
+        */
+        void send(int partition, Event *e, Tick t, bool disposable = false);
+
+        /// Returns the index of the partition executing on the
+        /// calling thread, or -1.
+        static int getPartition();
+
+        /// Returns the number of windows of the last run.
+        unsigned long getWindows() const {
+            return _windows;
+        }
+
+    private:
+        struct Message {
+            int dest;
+            Event *evt;
+            Tick time;
+            bool disposable;
+        };
+
+        Tick nextWindow(Tick endTick);
+        void deliver();
+
+        std::vector<SimulationContext *> _parts;
+        Tick _lookahead;
+        unsigned long _windows;
+
+        /// _outbox[i] is written only by partition i.
+        std::vector<std::vector<Message>> _outbox;
+
+        static thread_local int _current;
+    };
+
+} // namespace MetaSim
+
+#endif
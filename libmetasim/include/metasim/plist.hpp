@@ -25,7 +25,12 @@
 #ifndef __PLIST_HPP__
 #define __PLIST_HPP__
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <set>
+#include <utility>
 
 #include <metasim/baseexc.hpp>
 
@@ -124,4 +129,361 @@ public:
     }
 };
 
+/**
+   \ingroup metasim_util
+
+   Priority List with rank access. It has the same interface as
+   priority_list, but it is built on a balanced tree (a treap)
+   where each node also stores the size of its subtree, so that
+   the n-th element (at()) and the rank of an element (rank())
+   are found in O(log n) time, instead of walking the list.
+
+   As for priority_list, the ordering of an element must not
+   change while it is in the list. Elements cannot be modified
+   through the iterators, and the iterators are invalidated only
+   when the element they point to is erased.
+*/
+template <class T, class Compare = std::less<T>>
+class indexed_priority_list {
+    struct Node {
+        T value;
+        Node *left;
+        Node *right;
+        Node *parent;
+        std::size_t size;
+        std::uint32_t prio;
+    };
+
+public:
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T &const_reference;
+
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const_iterator() : _list(nullptr), _node(nullptr) {}
+
+        reference operator*() const {
+            return _node->value;
+        }
+        pointer operator->() const {
+            return &_node->value;
+        }
+
+        const_iterator &operator++() {
+            _node = next(_node);
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Decrementing end() gives the last element
+        const_iterator &operator--() {
+            _node = _node == nullptr ? rightmost(_list->_root) : prev(_node);
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return _node == other._node;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return _node != other._node;
+        }
+
+    private:
+        friend class indexed_priority_list;
+
+        const_iterator(const indexed_priority_list *list, Node *node) :
+            _list(list),
+            _node(node) {}
+
+        const indexed_priority_list *_list;
+        Node *_node;
+    };
+
+    // As for std::set, the elements are never modifiable
+    typedef const_iterator iterator;
+
+    indexed_priority_list() = default;
+
+    indexed_priority_list(const indexed_priority_list &other) :
+        _cmp(other._cmp) {
+        for (const auto &x : other)
+            insert(x);
+    }
+
+    indexed_priority_list(indexed_priority_list &&other) noexcept :
+        _root(other._root),
+        _cmp(std::move(other._cmp)),
+        _seed(other._seed) {
+        other._root = nullptr;
+    }
+
+    indexed_priority_list &operator=(indexed_priority_list other) {
+        std::swap(_root, other._root);
+        std::swap(_cmp, other._cmp);
+        std::swap(_seed, other._seed);
+        return *this;
+    }
+
+    ~indexed_priority_list() {
+        clear();
+    }
+
+    const_iterator begin() const {
+        return {this, leftmost(_root)};
+    }
+    const_iterator end() const {
+        return {this, nullptr};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    std::pair<iterator, bool> insert(const_reference x) {
+        Node *found = lookup(x);
+        if (found != nullptr)
+            return {{this, found}, false};
+
+        Node *n = new Node{x, nullptr, nullptr, nullptr, 1, nextPrio()};
+        _root = insert(_root, n);
+        _root->parent = nullptr;
+        return {{this, n}, true};
+    }
+
+    void erase(const_reference x) {
+        Node *n = lookup(x);
+        if (n == nullptr)
+            return;
+
+        Node *m = merge(n->left, n->right);
+        Node *p = n->parent;
+        if (m != nullptr)
+            m->parent = p;
+        if (p == nullptr)
+            _root = m;
+        else if (p->left == n)
+            p->left = m;
+        else
+            p->right = m;
+
+        for (; p != nullptr; p = p->parent)
+            update(p);
+        delete n;
+    }
+
+    const_iterator find(const_reference x) const {
+        return {this, lookup(x)};
+    }
+
+    bool contains(const_reference x) const {
+        return lookup(x) != nullptr;
+    }
+
+    /// Returns an iterator to the (n+1)-th element (0 == first),
+    /// or end() if the list has less than n+1 elements.
+    const_iterator at(size_type n) const {
+        Node *t = _root;
+        while (t != nullptr) {
+            size_type l = size(t->left);
+            if (n < l) {
+                t = t->left;
+            } else if (n == l) {
+                break;
+            } else {
+                n -= l + 1;
+                t = t->right;
+            }
+        }
+        return {this, t};
+    }
+
+    /// Returns the number of elements that precede x in the list.
+    size_type rank(const_reference x) const {
+        size_type r = 0;
+        for (Node *t = _root; t != nullptr;) {
+            if (_cmp(t->value, x)) {
+                r += size(t->left) + 1;
+                t = t->right;
+            } else {
+                t = t->left;
+            }
+        }
+        return r;
+    }
+
+    const_reference front() const {
+        return *begin();
+    }
+    const_reference back() const {
+        return *(--end());
+    }
+    bool empty() const {
+        return _root == nullptr;
+    }
+    void clear() {
+        destroy(_root);
+        _root = nullptr;
+    }
+    size_type size() const {
+        return size(_root);
+    }
+
+private:
+    Node *_root = nullptr;
+    Compare _cmp;
+
+    /// State of the generator of the node priorities, which only
+    /// affect the shape of the tree
+    std::uint32_t _seed = 2463534242u;
+
+    std::uint32_t nextPrio() {
+        // xorshift32
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+        return _seed;
+    }
+
+    static size_type size(const Node *t) {
+        return t == nullptr ? 0 : t->size;
+    }
+
+    static void update(Node *t) {
+        t->size = 1 + size(t->left) + size(t->right);
+    }
+
+    static Node *leftmost(Node *t) {
+        if (t != nullptr)
+            while (t->left != nullptr)
+                t = t->left;
+        return t;
+    }
+
+    static Node *rightmost(Node *t) {
+        if (t != nullptr)
+            while (t->right != nullptr)
+                t = t->right;
+        return t;
+    }
+
+    static Node *next(Node *t) {
+        if (t->right != nullptr)
+            return leftmost(t->right);
+        while (t->parent != nullptr && t->parent->right == t)
+            t = t->parent;
+        return t->parent;
+    }
+
+    static Node *prev(Node *t) {
+        if (t->left != nullptr)
+            return rightmost(t->left);
+        while (t->parent != nullptr && t->parent->left == t)
+            t = t->parent;
+        return t->parent;
+    }
+
+    Node *lookup(const_reference x) const {
+        Node *t = _root;
+        while (t != nullptr) {
+            if (_cmp(x, t->value))
+                t = t->left;
+            else if (_cmp(t->value, x))
+                t = t->right;
+            else
+                break;
+        }
+        return t;
+    }
+
+    // The caller links the returned node to its parent
+    static Node *rotateRight(Node *t) {
+        Node *l = t->left;
+        t->left = l->right;
+        if (t->left != nullptr)
+            t->left->parent = t;
+        l->right = t;
+        t->parent = l;
+        update(t);
+        update(l);
+        return l;
+    }
+
+    static Node *rotateLeft(Node *t) {
+        Node *r = t->right;
+        t->right = r->left;
+        if (t->right != nullptr)
+            t->right->parent = t;
+        r->left = t;
+        t->parent = r;
+        update(t);
+        update(r);
+        return r;
+    }
+
+    // Inserts n in the subtree t, returns the new root of the subtree
+    Node *insert(Node *t, Node *n) {
+        if (t == nullptr)
+            return n;
+
+        if (_cmp(n->value, t->value)) {
+            t->left = insert(t->left, n);
+            t->left->parent = t;
+            if (t->left->prio > t->prio)
+                return rotateRight(t);
+        } else {
+            t->right = insert(t->right, n);
+            t->right->parent = t;
+            if (t->right->prio > t->prio)
+                return rotateLeft(t);
+        }
+        update(t);
+        return t;
+    }
+
+    // Merges two subtrees, all the elements of a precede those of b
+    static Node *merge(Node *a, Node *b) {
+        if (a == nullptr)
+            return b;
+        if (b == nullptr)
+            return a;
+
+        if (a->prio > b->prio) {
+            a->right = merge(a->right, b);
+            a->right->parent = a;
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        b->left->parent = b;
+        update(b);
+        return b;
+    }
+
+    static void destroy(Node *t) {
+        if (t == nullptr)
+            return;
+        destroy(t->left);
+        destroy(t->right);
+        delete t;
+    }
+};
+
 #endif // __PLIST_HPP__
@@ -0,0 +1,99 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __POOL_HPP__
+#define __POOL_HPP__
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace MetaSim {
+
+    /**
+        \ingroup metasim_util
+
+        Arena allocator for small objects that are created and
+        destroyed at a high rate during the simulation, like
+        disposable events and particles.
+
+        Memory is obtained in large chunks and carved in blocks of
+        the same size class (a multiple of GRANULARITY bytes).
+        Freed blocks are recycled through one free list per size
+        class, hence in steady state allocating an object costs a
+        couple of pointer operations and no call to the global
+        allocator. Free lists are thread-local, so that
+        simulations running in different threads do not contend
+        on them. When a thread exits, its lists are handed back
+        to a shared list, from which the other threads refill
+        before asking for a new chunk. Chunks are never given
+        back: the arena grows up to the peak number of objects
+        alive at the same time.
+
+        Objects larger than MAX_SIZE go to the global allocator.
+
+        Classes opt in by defining their own operator new and
+        operator delete (the sized version) on top of this
+        allocator, see Event and ParticleInterface. When the
+        library is built with METASIM_NO_POOL defined, all requests
+        are forwarded to the global allocator, which is useful
+        with memory debuggers.
+    */
+    class SmallObjectPool {
+    public:
+        static const std::size_t GRANULARITY = 16;
+        static const std::size_t MAX_SIZE = 512;
+        static const std::size_t CHUNK_SIZE = 64 * 1024;
+
+        static void *allocate(std::size_t size);
+        static void deallocate(void *p, std::size_t size) noexcept;
+
+        /// Hands the free lists of the calling thread back to the
+        /// shared list, called when the thread exits
+        static void release() noexcept;
+
+    private:
+        struct Block {
+            Block *next;
+        };
+
+        static const std::size_t NUM_CLASSES = MAX_SIZE / GRANULARITY;
+
+        static thread_local Block *_free[NUM_CLASSES];
+
+        /// Set once the lists of the thread have been handed back
+        static thread_local bool _exited;
+
+        /// Blocks handed back by the threads that exited
+        static std::mutex _orphans_mtx;
+        static Block *_orphans[NUM_CLASSES];
+
+        static void *refill(std::size_t cls);
+    };
+
+    /**
+        \ingroup metasim_util
+
+        Returns a pointer to a unique, never destroyed, copy of the
+        string. Used to share the names of the objects that are
+        created many times with the same name (e.g., events).
+
+        Each thread caches the strings it has interned, so the
+        shared table is locked only the first time a thread sees a
+        string.
+    */
+    const std::string *intern_string(const std::string &s);
+
+} // namespace MetaSim
+
+#endif
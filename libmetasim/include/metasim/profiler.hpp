@@ -0,0 +1,176 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __PROFILER_HPP__
+#define __PROFILER_HPP__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include <metasim/baseexc.hpp>
+#include <metasim/tick.hpp>
+
+namespace MetaSim {
+
+    class Event;
+
+    /**
+        \ingroup metasim_util
+
+        Collects statistics on the event engine itself, to find
+        out where a simulation spends its time. Unlike the debug
+        stream, it is available in release builds too.
+
+        For each concrete Event class (as given by typeid) it
+        counts the number of posts, drops (removals from the
+        queue other than firing) and fires, and measures the
+        wall-clock time spent in doit() and in the probes of the
+        particles attached to the events. It also samples the
+        depth of the event queue and counts the number of events
+        executed at each simulated tick.
+
+        There is one profiler for each SimulationContext. It is
+        disabled by default: in that case the event engine only
+        pays for testing a flag on post, drop and fire.
+
+        @code
+        Profiler &prof = SIMUL.getProfiler();
+        prof.setOutput("profile.json");   // or .csv
+        prof.enable();
+        SIMUL.run(100000);                // the report is dumped here
+        @endcode
+    */
+    class Profiler {
+    public:
+        /**
+           \ingroup metasim_exc
+
+           Exceptions for the Profiler class.
+        */
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message, const std::string cl = "Profiler",
+                const std::string md = "profiler.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /// Counters of one event class. Times are in nanoseconds.
+        struct EventStats {
+            std::string name;
+            uint64_t posts = 0;
+            uint64_t drops = 0;
+            uint64_t fires = 0;
+            uint64_t doitTime = 0;
+            uint64_t probes = 0;
+            uint64_t probeTime = 0;
+        };
+
+        Profiler();
+
+        /// Enables or disables the profiler at run-time.
+        void enable(bool e = true) {
+            _enabled = e;
+        }
+
+        bool isEnabled() const {
+            return _enabled;
+        }
+
+        /// Clears all the collected data.
+        void reset();
+
+        /// The queue depth is sampled once every n fired events
+        /// (default 1).
+        void setSamplingPeriod(unsigned int n);
+
+        /**
+           Sets the file where the report is written at the end
+           of Simulation::run(), if the profiler is enabled. The
+           report is in JSON format if the name ends with
+           ".json", in CSV format otherwise. An empty name (the
+           default) disables the automatic dump.
+        */
+        void setOutput(const std::string &fname) {
+            _output = fname;
+        }
+
+        const std::string &getOutput() const {
+            return _output;
+        }
+
+        /// Returns the counters of each event class, sorted by
+        /// decreasing time spent in doit().
+        std::vector<EventStats> getEventStats() const;
+
+        uint64_t getFires() const {
+            return _fires;
+        }
+        uint64_t getTicks() const {
+            return _ticks;
+        }
+        uint64_t getMaxEventsPerTick() const {
+            return _maxPerTick;
+        }
+        double getMeanQueueDepth() const;
+        std::size_t getMaxQueueDepth() const {
+            return _maxDepth;
+        }
+
+        /// Writes the report in CSV format: one line per event
+        /// class, followed by the global counters.
+        void printCSV(std::ostream &os) const;
+
+        /// Writes the report in JSON format.
+        void printJSON(std::ostream &os) const;
+
+        /// Writes the report on a file, see setOutput().
+        void dump(const std::string &fname) const;
+
+        /// Called by the event engine, only when enabled.
+        void onPost(const Event &e);
+        void onDrop(const Event &e);
+        void onFire(const Event &e, uint64_t doitTime, uint64_t probeTime,
+                    std::size_t nprobes);
+        void onStep(const Tick &t, std::size_t depth);
+
+    private:
+        EventStats &getStats(const Event &e);
+
+        bool _enabled;
+        unsigned int _samplingPeriod;
+        std::string _output;
+
+        std::unordered_map<std::type_index, EventStats> _stats;
+
+        uint64_t _fires;
+
+        // Events per simulated tick
+        Tick _lastTick;
+        uint64_t _ticks;
+        uint64_t _inTick;
+        uint64_t _maxPerTick;
+
+        // Queue depth samples
+        unsigned int _toSample;
+        uint64_t _depthSamples;
+        double _depthSum;
+        std::size_t _maxDepth;
+    };
+
+} // namespace MetaSim
+
+#endif
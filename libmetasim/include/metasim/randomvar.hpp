@@ -14,6 +14,7 @@
 #ifndef __RANDOMVAR_HPP__
 #define __RANDOMVAR_HPP__
 
+#include <cstdint>
 #include <fstream>
 #include <iosfwd>
 #include <metasim/memory.hpp>
@@ -73,12 +74,14 @@ namespace MetaSim {
         */
         RandomGen(RandNum s);
 
+        virtual ~RandomGen() = default;
+
         /** Initialize the generator with seed s */
-        void init(RandNum s);
+        virtual void init(RandNum s);
 
         /** extract the next random number from the
-            sequence */
-        RandNum sample();
+            sequence, in [1, M - 1] */
+        virtual RandNum sample();
 
         /** Returns the current sequence number. */
         RandNum getCurrSeed() {
@@ -92,6 +95,48 @@ namespace MetaSim {
         }
     };
 
+    class SimulationContext;
+
+    /**
+        A counter-based generator (Philox4x32-10), that computes
+        the n-th number of a stream directly from the key (seed,
+        run, stream, n), with no state besides the counter n.
+
+        Each stream is independent from the others, hence
+        entities that draw from their own stream (see
+        RandomVar::setStream()) obtain the same numbers no matter
+        how their draws are interleaved with the ones of other
+        entities, i.e., regardless of event ordering, batching
+        or parallel execution.
+
+        The seed is the one of the standard generator of the
+        context (RandomVar::init()), and the run is the number of
+        runs started in the context since then; every stream
+        restarts from its first number at each new run.
+    */
+    class PhiloxGen : public RandomGen {
+    public:
+        /// Creates the generator of the given stream, in the
+        /// current context
+        PhiloxGen(uint64_t stream);
+
+        /// Restarts the generator on stream s
+        void init(RandNum s) override;
+
+        RandNum sample() override;
+
+        /// The Philox4x32-10 bijection, exposed for testing:
+        /// encrypts the counter ctr with the key
+        static void philox(uint32_t ctr[4], const uint32_t key[2]);
+
+    private:
+        SimulationContext *_ctx;
+        uint64_t _stream;
+        unsigned long _epoch;
+        uint64_t _draw;
+        uint32_t _block[4];
+    };
+
     /**
        The basic abstract class for random variables.
     */
@@ -100,17 +145,19 @@ namespace MetaSim {
         static RandNum _seed;
         static RandNum _xn;
 
-        /// Default generator.
-        static RandomGen _stdgen;
-
-        /** Pointer to the current generator (used by the next
-            RandomVar object to be created. */
-        static RandomGen *_pstdgen;
+        // The default generator and the pointer to the
+        // generator used by the next RandomVar object to be
+        // created are kept in the SimulationContext, so that
+        // simulations running in different threads do not
+        // share the same sequence.
 
         /** The current random generator (used by this
             object). By default, it is equal to _pstdgen */
         RandomGen *_gen;
 
+        /// The generator of the stream of this object, if any
+        std::unique_ptr<RandomGen> _ownGen;
+
     public:
         typedef std::string BASE_KEY_TYPE;
 
@@ -157,11 +204,9 @@ namespace MetaSim {
 
         virtual ~RandomVar();
 
-        /// Initialize the standard generator with a given
-        /// seed
-        static inline void init(RandNum s) {
-            _pstdgen->init(s);
-        }
+        /// Initialize the standard generator (of the current
+        /// context) with a given seed
+        static void init(RandNum s);
 
         /// Change the standard generator
         static RandomGen *changeGenerator(RandomGen *g);
@@ -169,6 +214,20 @@ namespace MetaSim {
         /// Restore the standard generator
         static void restoreGenerator();
 
+        /**
+           Makes this variable draw from its own stream of a
+           PhiloxGen, instead of the shared generator. The stream
+           identifier must be unique in the context and must not
+           depend on the order of events (e.g., derive it from
+           the ID of the entity that owns the variable). A copy
+           of the variable gets a generator on the same stream.
+        */
+        void setStream(uint64_t stream);
+
+        /// Starts a new run of the random streams of the current
+        /// context; called by Simulation::initSingleRun()
+        static void newRun();
+
         /**
             This method must be overloaded in each derived
             class to return a double according to the propoer
@@ -223,10 +282,49 @@ namespace MetaSim {
 
     /**
         This class implements an uniform distribution, between min
-        and max. */
+        and max.
+
+        By default, the variable draws its sample the first time
+        get() is called, and then keeps returning it. The same
+        holds for the distributions derived from this class,
+        which transform that sample.
+
+        With setBlockSize(n), instead, every call to get() returns
+        a new variate. Variates are generated n at a time: the
+        uniform samples are drawn first, then transformed with a
+        single loop over the whole block (see transform()), which
+        the compiler can vectorize. The sequence only depends on
+        the generator of the variable (e.g., its own stream, see
+        RandomVar::setStream()) and on n.
+    */
     class UniformVar : public RandomVar {
         double _min, _max, generatedValue = 0.0;
 
+        std::vector<double> _block;
+        std::size_t _blockPos = 0;
+
+    protected:
+        /**
+           Transforms in place n uniform samples in [min, max)
+           into samples of this distribution. The uniform
+           distribution leaves them as they are.
+        */
+        virtual void transform(double * /* buf */, std::size_t /* n */) {}
+
+        /// Returns the next variate of the block in v; false
+        /// when the block mode is disabled.
+        bool fromBlock(double &v) {
+            if (_block.empty())
+                return false;
+            if (_blockPos == _block.size())
+                refill();
+            v = _block[_blockPos++];
+            return true;
+        }
+
+    private:
+        void refill();
+
     public:
         UniformVar(double min, double max) :
             RandomVar(),
@@ -238,6 +336,12 @@ namespace MetaSim {
         static std::unique_ptr<UniformVar>
             createInstance(std::vector<std::string> &par);
 
+        /**
+           Enables the generation of blocks of n variates (0
+           disables it). Pending variates are discarded.
+        */
+        virtual void setBlockSize(std::size_t n);
+
         double get() override;
         double getMaximum() override { // throw(MaxException) override {
             return _max;
@@ -257,6 +361,10 @@ namespace MetaSim {
 
         CLONEABLE(RandomVar, ExponentialVar, override)
 
+    protected:
+        void transform(double *buf, std::size_t n) override;
+
+    public:
         static std::unique_ptr<ExponentialVar>
             createInstance(std::vector<std::string> &par);
 
@@ -286,6 +394,10 @@ namespace MetaSim {
 
         CLONEABLE(RandomVar, WeibullVar, override)
 
+    protected:
+        void transform(double *buf, std::size_t n) override;
+
+    public:
         static std::unique_ptr<WeibullVar>
             createInstance(std::vector<std::string> &par);
 
@@ -309,6 +421,10 @@ namespace MetaSim {
 
         CLONEABLE(RandomVar, ParetoVar, override)
 
+    protected:
+        void transform(double *buf, std::size_t n) override;
+
+    public:
         static std::unique_ptr<ParetoVar>
             createInstance(std::vector<std::string> &par);
 
@@ -340,6 +456,13 @@ namespace MetaSim {
 
         CLONEABLE(RandomVar, NormalVar, override)
 
+    protected:
+        /// Box-Muller on pairs of samples; blocks have an even size
+        void transform(double *buf, std::size_t n) override;
+
+    public:
+        void setBlockSize(std::size_t n) override;
+
         static std::unique_ptr<NormalVar>
             createInstance(std::vector<std::string> &par);
 
@@ -363,6 +486,10 @@ namespace MetaSim {
 
         CLONEABLE(RandomVar, PoissonVar, override)
 
+    protected:
+        void transform(double *buf, std::size_t n) override;
+
+    public:
         static std::unique_ptr<PoissonVar>
             createInstance(std::vector<std::string> &par);
 
@@ -0,0 +1,118 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __REPLICATION_HPP__
+#define __REPLICATION_HPP__
+
+#include <functional>
+#include <memory>
+
+#include <metasim/baseexc.hpp>
+#include <metasim/randomvar.hpp>
+#include <metasim/tick.hpp>
+
+namespace MetaSim {
+
+    /**
+        \ingroup metasim_ee
+
+        Runs the replications of a simulation in parallel.
+
+        Simulation::run(length, runs) executes the replications
+        one after the other. Since a replication only depends on
+        the state of the model after Entity::newRun() and on the
+        random sequence, replications can run in parallel on
+        copies of the model, provided that each replication starts
+        from its own seed.
+
+        The model is described by a factory function, which
+        creates all the entities, events and statistical objects
+        in the current context and returns an object that keeps
+        them alive. Each worker thread creates its own
+        SimulationContext, builds a copy of the model with the
+        factory, and executes the replications it is assigned.
+        Replication number r always starts by re-seeding the
+        default random generator with getSeed(seed, r), so the
+        results do not depend on the number of workers nor on
+        which worker executes which replication.
+
+        At the end, the sample collected by each statistical
+        object in each replication is merged, in replication
+        order, into the statistical objects of the calling
+        thread's current context, which must have been created
+        by the same factory (or anyway in the same order). Then,
+        getMean(), getConfInterval(), etc. can be used on them
+        exactly as after a sequential Simulation::run().
+
+        @code
+        auto model = build_model();      // stats to be read later
+        ReplicationRunner runner(build_model, 8);
+        runner.run(100000, 30);
+        std::cout << stat.getMean() << std::endl;
+        @endcode
+    */
+    class ReplicationRunner {
+    public:
+        /**
+           \ingroup metasim_exc
+
+           Exceptions for the ReplicationRunner class.
+        */
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "ReplicationRunner",
+                const std::string md = "replication.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /// Builds the model in the current context and returns
+        /// an object that owns it.
+        typedef std::function<std::shared_ptr<void>()> ModelFactory;
+
+        /**
+           @param factory The function that builds the model.
+           @param workers The number of worker threads; 0 means
+           one per hardware thread.
+        */
+        ReplicationRunner(ModelFactory factory, unsigned int workers = 0);
+
+        /**
+           Executes nRuns replications, each one of length
+           endTick, and merges the results in the statistical
+           objects of the current context. Like
+           Simulation::run(), 2 runs are not allowed and become 3.
+           Exceptions raised by a worker are re-thrown here.
+
+           @param endTick Length of each replication.
+           @param nRuns Number of replications.
+           @param seed Base seed of the random sequences.
+        */
+        void run(Tick endTick, int nRuns, RandNum seed = 1);
+
+        /// Returns the seed of replication r, a valid seed for a
+        /// RandomGen different for each (seed, r) pair.
+        static RandNum getSeed(RandNum seed, int r);
+
+        unsigned int getWorkers() const {
+            return _workers;
+        }
+
+    private:
+        ModelFactory _factory;
+        unsigned int _workers;
+    };
+
+} // namespace MetaSim
+
+#endif
@@ -0,0 +1,174 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef __SIMCONTEXT_HPP__
+#define __SIMCONTEXT_HPP__
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <metasim/profiler.hpp>
+#include <metasim/randomvar.hpp>
+#include <metasim/tick.hpp>
+
+namespace MetaSim {
+
+    class BaseStat;
+    class Entity;
+    class Event;
+    class EventQueue;
+    class Simulation;
+
+    /**
+        \ingroup metasim_ee
+
+        All the state of one simulation: the event queue, the
+        registry of the entities, the list of statistical objects,
+        the default random generator and the Simulation engine
+        itself (which also owns the debug stream).
+
+        Every thread has a <i>current</i> context. Entities, events
+        and statistics use the current context when they are
+        created (or, for events, when they are posted), and the
+        static functions of Event, Entity and BaseStat operate on
+        the current context. Unless another context is installed
+        with install() or with a Scope object, the current context
+        is the default one, which is what SIMUL refers to.
+
+        Hence, to run several independent simulations in parallel,
+        each thread creates its own context, installs it, builds
+        the simulation model and runs it:
+
+        @code
+        std::thread t([] {
+            SimulationContext ctx;
+            SimulationContext::Scope scope(ctx);
+
+            // create entities, events and statistics
+
+            SIMUL.run(10000);
+        });
+        @endcode
+
+        A context must outlive every object created within it.
+        Objects must not be shared between contexts.
+    */
+    class SimulationContext {
+    public:
+        /**
+            Installs a context as the current one for the calling
+            thread, restoring the previous one on destruction.
+        */
+        class Scope {
+        public:
+            Scope(SimulationContext &ctx) : _prev(install(&ctx)) {}
+            ~Scope() {
+                install(_prev);
+            }
+
+        private:
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+            SimulationContext *_prev;
+        };
+
+        /**
+            Creates a new, empty, context.
+
+            @param queue The name of the event queue backend (see
+            EventQueue::create()).
+        */
+        SimulationContext(const std::string &queue = "");
+        ~SimulationContext();
+
+        /// The simulation engine of this context.
+        Simulation &getSimulation() {
+            return *_simulation;
+        }
+
+        /// The event queue of this context.
+        EventQueue &getEventQueue() {
+            return *_eventQueue;
+        }
+
+        /// The event engine profiler of this context.
+        Profiler &getProfiler() {
+            return _profiler;
+        }
+
+        /// Replaces the event queue backend, see Event::setEventQueue().
+        void setEventQueue(std::unique_ptr<EventQueue> q);
+
+        /// The current context of the calling thread.
+        static SimulationContext &current() {
+            return _current ? *_current : getDefault();
+        }
+
+        /// The process-wide default context.
+        static SimulationContext &getDefault();
+
+        /**
+            Installs a context as the current one for the calling
+            thread. A NULL pointer re-installs the default
+            context. Returns the previously installed context.
+        */
+        static SimulationContext *install(SimulationContext *ctx);
+
+    private:
+        SimulationContext(const SimulationContext &) = delete;
+        SimulationContext &operator=(const SimulationContext &) = delete;
+
+        friend class BaseStat;
+        friend class Entity;
+        friend class Event;
+        friend class PhiloxGen;
+        friend class RandomVar;
+
+        static thread_local SimulationContext *_current;
+
+        // Event engine
+        std::unique_ptr<EventQueue> _eventQueue;
+        unsigned long _eventCounter;
+        Profiler _profiler;
+
+        // Entities registry
+        std::map<int, Entity *> _globMap;
+        std::map<std::string, Entity *> _index;
+        int _IDcount;
+
+        // Statistics
+        std::list<BaseStat *> _statList;
+        size_t _totalNumOfExp;
+        size_t _expNum;
+        bool _endOfSim;
+        bool _initFlag;
+        Tick _transitory;
+
+        // Random generators
+        RandomGen _stdgen;
+        RandomGen *_pstdgen;
+
+        // Key of the counter-based streams
+        RandNum _streamSeed;
+        unsigned long _streamRun;
+        unsigned long _streamEpoch;
+
+        std::unique_ptr<Simulation> _simulation;
+    };
+
+} // namespace MetaSim
+
+#endif
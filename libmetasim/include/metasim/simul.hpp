@@ -14,10 +14,16 @@
 #ifndef __SIMUL_HPP__
 #define __SIMUL_HPP__
 
+#include <vector>
+
+#include <sys/types.h>
+
+#include <metasim/baseexc.hpp>
 #include <metasim/basestat.hpp>
 #include <metasim/debugstream.hpp>
 #include <metasim/entity.hpp>
 #include <metasim/event.hpp>
+#include <metasim/simcontext.hpp>
 
 namespace MetaSim {
 
@@ -26,7 +32,32 @@ namespace MetaSim {
     /**
         \ingroup metasim_ee
 
-        This singleton implements the simulation engine and some
+        An object that wants to perform some work once at the end
+        of a batch of simultaneous events, rather than once for
+        each event of the batch (see Simulation::setBatching()).
+
+        A typical user is a kernel, which needs to take a single
+        scheduling decision after all the tasks arriving at the
+        same time have been inserted in its ready queue.
+    */
+    class BatchHook {
+        friend class Simulation;
+
+        bool _batchPending = false;
+        unsigned long _batchOrder = 0;
+
+    public:
+        virtual ~BatchHook() = default;
+
+        /// Called by the simulation engine at the end of the
+        /// batch in which the hook has been requested.
+        virtual void onEndOfBatch() = 0;
+    };
+
+    /**
+        \ingroup metasim_ee
+
+        This class implements the simulation engine and some
         debugging facilities. The main function is <i>run(Tick
         lenght, size_t runs)</i> that is responsible for running
         the simulation for one or more times.
@@ -34,17 +65,46 @@ namespace MetaSim {
         The <i>getTime()</i> returns the current globalTime in the
         simulation; the dbg object is used for debugging output.
 
+        There is one Simulation object for each SimulationContext;
+        getInstance() (and the SIMUL macro) returns the one of the
+        current context of the calling thread. The functions that
+        advance the simulation install their own context as the
+        current one while they run.
+
         @author Giuseppe Lipari, Gerardo Lamastra
     */
     //@{
     class Simulation {
-        Simulation();
+        friend class SimulationContext;
+
+        Simulation(SimulationContext &ctx);
         Simulation(const Simulation &);
 
-        static Simulation *instance_;
+        SimulationContext &_ctx;
 
     public:
-        static Simulation &getInstance();
+        /**
+           \ingroup metasim_exc
+
+           Exceptions for the Simulation class.
+        */
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "Simulation",
+                const std::string md = "simul.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /// Returns the simulation of the current context.
+        static Simulation &getInstance() {
+            return SimulationContext::current().getSimulation();
+        }
+
+        /// Returns the context this simulation belongs to.
+        SimulationContext &getContext() {
+            return _ctx;
+        }
 
         /**
            Enters the <i>lev</i> debug level.
@@ -64,7 +124,7 @@ namespace MetaSim {
 
            @see DebugStream
         */
-        void dbgEnter(std::string lev, std::string header);
+        void dbgEnter(const std::string &lev, const char *header);
 
         /**
            Exits from the current debug level.
@@ -106,6 +166,64 @@ namespace MetaSim {
         */
         void run(Tick length, int runs = 1);
 
+        /**
+           Selects the event queue backend, by name ("set",
+           "heap" or "calendar", see EventQueue::create()). An
+           empty string selects the backend chosen at configure
+           time.
+
+           The event queue must be empty, hence this function
+           must be called before posting any event, that is
+           before run() and before any entity is initialized.
+
+           @param type The name of the event queue backend.
+        */
+        void setEventQueue(const std::string &type);
+
+        /**
+           Enables or disables the batched stepping mode.
+
+           In batched mode, run() and run_to() advance the
+           simulation with sim_batch() instead of sim_step():
+           all the events with the same time and priority
+           are executed as a single batch, in the usual order,
+           and at the end of the batch the BatchHook objects
+           requested with deferToEndOfBatch() are invoked, once
+           each. The mode is disabled by default.
+        */
+        void setBatching(bool b) {
+            _batching = b;
+        }
+
+        bool isBatching() const {
+            return _batching;
+        }
+
+        /**
+           Requests hook->onEndOfBatch() to be called at the end
+           of the batch being executed. Requesting the same hook
+           more than once in a batch has no further effect,
+           except that hooks are invoked in the order of their
+           last request (as if each request dropped and reposted
+           an event).
+
+           @return false if no batch is being executed (e.g.,
+           batched mode is disabled); in that case nothing is
+           recorded and the caller must do its work immediately.
+        */
+        bool deferToEndOfBatch(BatchHook *hook);
+
+        /**
+           Returns the profiler of the event engine. If it is
+           enabled and an output file has been set, the report
+           is written at the end of run().
+
+           @see Profiler
+        */
+        Profiler &getProfiler() {
+            return _ctx.getProfiler();
+        }
+
         /**
            Returns the current simulation time.
         */
@@ -131,6 +249,20 @@ namespace MetaSim {
         */
         const Tick sim_step();
 
+        /**
+           Executes one batch of events, i.e. all the events
+           with the same time and priority as the first event in
+           the queue, including the ones posted with that time
+           and priority while the batch is executed. Then calls
+           the hooks requested during the batch.
+
+           Events are extracted one at a time, like in
+           sim_step(), so that an event of the batch can still
+           drop or re-post another event of the same batch. It
+           returns the time of the batch.
+        */
+        const Tick sim_batch();
+
         /**
            Function to help testing and debugging.
 
@@ -167,6 +299,83 @@ namespace MetaSim {
         */
         void initSingleRun();
 
+        /**
+           Performs one complete simulation run, from
+           initSingleRun() to endSingleRun(), stopping after the
+           first event at or past endTick. Statistics must have
+           been initialized with initRuns().
+
+           Normally, this function is called from the
+           Simulation::run() and from the ReplicationRunner.
+        */
+        void singleRun(Tick endTick);
+
+        /**
+           Continues the current run, started with
+           initSingleRun() (and possibly advanced with
+           run_to()), stopping after the first event at or
+           past endTick, then calls endSingleRun().
+        */
+        void continueRun(Tick endTick);
+
+        /**
+           Executes all the events whose time is strictly less
+           than limit, and returns the time of the last one. It
+           does not throw when the queue becomes empty. Used to
+           advance a partition of a PartitionedRunner up to the
+           end of a time window.
+        */
+        const Tick advance(const Tick &limit);
+
+        /**
+           Checkpoints the whole simulation by forking the
+           process, then both processes continue from the
+           current state. Returns 0 in the child and the pid of
+           the child in the parent, like fork(2).
+
+           The child gets a copy-on-write image of everything:
+           event queue, entities, statistics and random
+           generators. Hence, it can change some parameter of the
+           model (a frequency, a budget, a placement, ...) and
+           continue the simulation, while the parent keeps the
+           checkpoint and can fork again other variants, which
+           share the same simulated prefix:
+
+           @code
+           SIMUL.initRuns();
+           SIMUL.initSingleRun();
+           SIMUL.run_to(warmup);              // common prefix
+
+           std::vector<pid_t> children;
+           for (int i = 0; i < nvariants; ++i) {
+               pid_t pid = SIMUL.fork();
+               if (pid == 0) {
+                   apply_variant(i);          // e.g., change an OPP
+                   SIMUL.continueRun(length);
+                   // save results (traces, stats) somewhere
+                   return 0;                  // from main()
+               }
+               children.push_back(pid);
+           }
+           for (pid_t pid : children)
+               Simulation::waitFork(pid);
+           @endcode
+
+           The children must write their results to different
+           files. Since only the calling thread survives in the
+           child, do not fork while other threads are running
+           (e.g., during a ReplicationRunner::run()). It cannot
+           be called from within an event handler in batched mode.
+        */
+        pid_t fork();
+
+        /**
+           Waits for a process created with fork() and returns
+           its exit status. Throws an exception if the child
+           terminated abnormally.
+        */
+        static int waitFork(pid_t pid);
+
         /**
            Function to help testing and debugging.
         */
@@ -194,15 +403,23 @@ namespace MetaSim {
 
         const Tick getNextEventTime();
 
+        /// Calls the hooks requested in the last batch.
+        void endBatch();
+
         size_t numRuns;
         size_t actRuns;
         Tick globTime;
         bool end;
+
+        bool _batching;
+        bool _inBatch;
+        unsigned long _batchCounter;
+        std::vector<BatchHook *> _batchHooks;
     };
 
     class DbgObj {
     public:
-        DbgObj(const std::string &x, const std::string &y) {
+        DbgObj(const std::string &x, const char *y) {
             Simulation::getInstance().dbgEnter(x, y);
         }
         ~DbgObj() {
@@ -250,9 +467,19 @@ void __dbgprintln_variadic(MetaSim::DebugStream &out, Args &&...args) {
 // NOTE: not using ##__VA_ARGS__ because only valid in GNU C/C++ (C++20 has a
 // fix for this but we target C++17) and we require at least one argument to be
 // printed.
-#define DBGPRINT(...) __dbgprintln_variadic(SIMUL.dbg, __VA_ARGS__)
+//
+// The arguments are evaluated only if the current debug level is enabled.
+#define DBGPRINT(...)                                                          \
+    do {                                                                       \
+        if (SIMUL.dbg.filter())                                                \
+            __dbgprintln_variadic(SIMUL.dbg, __VA_ARGS__);                     \
+    } while (0)
 #define DBGVAR(x) DBGPRINT("  --> ", #x, " = ", x)
 
+// True if the output of the current debug level is enabled, to guard longer
+// debug-only computations
+#define DBGENABLED() (SIMUL.dbg.filter())
+
 template <class X>
 void __print_elem__(const X &obj) {
     MetaSim::SIMUL.dbg << "--> " << obj << std::endl;
@@ -285,6 +512,7 @@ void __print_set__(T const &x) {
 // #define DBGPRINT_6(x, y, z, w, r, s)
 
 #define DBGVAR(x)
+#define DBGENABLED() false
 
 #define DBGVECTOR(x)
 
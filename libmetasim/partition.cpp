@@ -0,0 +1,182 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <metasim/basestat.hpp>
+#include <metasim/event.hpp>
+#include <metasim/partition.hpp>
+#include <metasim/simul.hpp>
+
+namespace MetaSim {
+
+    thread_local int PartitionedRunner::_current = -1;
+
+    PartitionedRunner::PartitionedRunner(
+        const std::vector<SimulationContext *> &partitions, Tick lookahead) :
+        _parts(partitions),
+        _lookahead(lookahead),
+        _windows(0),
+        _outbox(partitions.size()) {
+        if (_parts.empty())
+            throw Exc("At least one partition is needed");
+        if (_lookahead <= 0)
+            throw Exc("The lookahead must be positive");
+    }
+
+    int PartitionedRunner::getPartition() {
+        return _current;
+    }
+
+    void PartitionedRunner::send(int partition, Event *e, Tick t,
+                                 bool disposable) {
+        if (_current < 0 || size_t(_current) >= _parts.size())
+            throw Exc("send() must be called from a partition");
+        if (partition < 0 || size_t(partition) >= _parts.size())
+            throw Exc("No such partition");
+        if (t - SIMUL.getTime() < _lookahead)
+            throw Exc("The event violates the lookahead");
+
+        _outbox[_current].push_back({partition, e, t, disposable});
+    }
+
+    // Returns the end of the next window, or endTick if there is
+    // nothing left to do before endTick
+    Tick PartitionedRunner::nextWindow(Tick endTick) {
+        Tick first = MAXTICK;
+        for (SimulationContext *ctx : _parts) {
+            SimulationContext::Scope scope(*ctx);
+            Event *e = Event::getFirst();
+            if (e != NULL && e->getTime() < first)
+                first = e->getTime();
+        }
+
+        if (first >= endTick || endTick - first <= _lookahead)
+            return endTick;
+        return first + _lookahead;
+    }
+
+    void PartitionedRunner::deliver() {
+        for (auto &box : _outbox) {
+            for (Message &m : box) {
+                SimulationContext::Scope scope(*_parts[m.dest]);
+                m.evt->post(m.time, m.disposable);
+            }
+            box.clear();
+        }
+    }
+
+    void PartitionedRunner::run(Tick endTick) {
+        const size_t n = _parts.size();
+
+        _windows = 0;
+        for (SimulationContext *ctx : _parts) {
+            Simulation &sim = ctx->getSimulation();
+            sim.initRuns();
+            sim.initSingleRun();
+        }
+
+        // Workers wait for a new generation, execute their partition
+        // up to the end of the window, and signal completion
+        std::mutex mtx;
+        std::condition_variable start, done;
+        unsigned long generation = 0;
+        size_t running = 0;
+        bool quit = false;
+        Tick window = 0;
+        std::vector<std::exception_ptr> errors(n);
+
+        auto worker = [&](int i) {
+            _current = i;
+            unsigned long seen = 0;
+            std::unique_lock<std::mutex> lock(mtx);
+            for (;;) {
+                start.wait(lock, [&] { return quit || generation != seen; });
+                if (quit)
+                    break;
+                seen = generation;
+                Tick w = window;
+                lock.unlock();
+
+                try {
+                    _parts[i]->getSimulation().advance(w);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+
+                lock.lock();
+                if (--running == 0)
+                    done.notify_one();
+            }
+            _current = -1;
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < n; ++i)
+            threads.emplace_back(worker, int(i));
+
+        std::exception_ptr error;
+        try {
+            Tick w;
+            do {
+                w = nextWindow(endTick);
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    window = w;
+                    running = n;
+                    ++generation;
+                    start.notify_all();
+                    done.wait(lock, [&] { return running == 0; });
+                }
+                ++_windows;
+
+                for (auto &e : errors)
+                    if (e)
+                        std::rethrow_exception(e);
+
+                deliver();
+            } while (w < endTick);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+            start.notify_all();
+        }
+        for (auto &t : threads)
+            t.join();
+
+        // Events sent but not delivered because of an error
+        for (auto &box : _outbox) {
+            for (Message &m : box)
+                if (m.disposable)
+                    delete m.evt;
+            box.clear();
+        }
+
+        for (SimulationContext *ctx : _parts) {
+            SimulationContext::Scope scope(*ctx);
+            ctx->getSimulation().endSingleRun();
+            BaseStat::endSim();
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+} // namespace MetaSim
@@ -0,0 +1,157 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <metasim/pool.hpp>
+
+namespace MetaSim {
+
+    thread_local SmallObjectPool::Block
+        *SmallObjectPool::_free[SmallObjectPool::NUM_CLASSES] = {};
+
+    thread_local bool SmallObjectPool::_exited = false;
+
+    std::mutex SmallObjectPool::_orphans_mtx;
+
+    SmallObjectPool::Block
+        *SmallObjectPool::_orphans[SmallObjectPool::NUM_CLASSES] = {};
+
+    namespace {
+        // Hands the free lists of a thread back to the pool when the
+        // thread exits, constructed by the first refill() of the thread
+        struct ThreadExit {
+            ~ThreadExit() {
+                SmallObjectPool::release();
+            }
+        };
+
+        thread_local ThreadExit thread_exit;
+    } // namespace
+
+    void *SmallObjectPool::allocate(std::size_t size) {
+#ifndef METASIM_NO_POOL
+        if (size > 0 && size <= MAX_SIZE) {
+            std::size_t cls = (size - 1) / GRANULARITY;
+            Block *b = _free[cls];
+            if (b == nullptr)
+                return refill(cls);
+            _free[cls] = b->next;
+            return b;
+        }
+#endif
+        return ::operator new(size);
+    }
+
+    void SmallObjectPool::deallocate(void *p, std::size_t size) noexcept {
+        if (p == nullptr)
+            return;
+#ifndef METASIM_NO_POOL
+        if (size > 0 && size <= MAX_SIZE) {
+            std::size_t cls = (size - 1) / GRANULARITY;
+            Block *b = static_cast<Block *>(p);
+
+            // Objects destroyed during the exit of the thread, after its
+            // lists were handed back
+            if (_exited) {
+                std::lock_guard<std::mutex> lock(_orphans_mtx);
+                b->next = _orphans[cls];
+                _orphans[cls] = b;
+                return;
+            }
+
+            b->next = _free[cls];
+            _free[cls] = b;
+            return;
+        }
+#endif
+        ::operator delete(p);
+    }
+
+    void SmallObjectPool::release() noexcept {
+        std::lock_guard<std::mutex> lock(_orphans_mtx);
+        for (std::size_t cls = 0; cls < NUM_CLASSES; ++cls) {
+            Block *head = _free[cls];
+            if (head == nullptr)
+                continue;
+
+            Block *tail = head;
+            while (tail->next != nullptr)
+                tail = tail->next;
+            tail->next = _orphans[cls];
+            _orphans[cls] = head;
+            _free[cls] = nullptr;
+        }
+        _exited = true;
+    }
+
+    void *SmallObjectPool::refill(std::size_t cls) {
+        // Makes sure that the lists are handed back at thread exit
+        (void) &thread_exit;
+
+        // Blocks left by the threads that exited come first
+        {
+            std::lock_guard<std::mutex> lock(_orphans_mtx);
+            Block *b = _orphans[cls];
+            if (b != nullptr) {
+                _orphans[cls] = nullptr;
+                _free[cls] = b->next;
+                return b;
+            }
+        }
+
+        const std::size_t bsize = (cls + 1) * GRANULARITY;
+        const std::size_t n = CHUNK_SIZE / bsize;
+
+        // Chunks are never released, blocks may still be in use by
+        // objects that outlive the thread that allocated them
+        char *chunk = static_cast<char *>(::operator new(n * bsize));
+
+        // The first block is returned, the others are linked
+        Block *head = nullptr;
+        for (std::size_t i = n - 1; i > 0; --i) {
+            Block *b = reinterpret_cast<Block *>(chunk + i * bsize);
+            b->next = head;
+            head = b;
+        }
+        _free[cls] = head;
+
+        return chunk;
+    }
+
+    const std::string *intern_string(const std::string &s) {
+        static std::mutex mtx;
+        static auto *table = new std::unordered_set<std::string>();
+
+        // Each thread caches the names it has already seen, so that only
+        // the first lookup of a name takes the lock
+        thread_local std::unordered_map<std::string, const std::string *>
+            cache;
+
+        auto it = cache.find(s);
+        if (it != cache.end())
+            return it->second;
+
+        const std::string *interned;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            interned = &*table->insert(s).first;
+        }
+        cache.emplace(s, interned);
+        return interned;
+    }
+
+} // namespace MetaSim
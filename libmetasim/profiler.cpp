@@ -0,0 +1,191 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <fstream>
+#include <typeinfo>
+
+#include <metasim/demangle.hpp>
+#include <metasim/event.hpp>
+#include <metasim/profiler.hpp>
+
+namespace MetaSim {
+
+    // Event names are C++ type names, which may contain commas
+    static std::string csv_field(const std::string &s) {
+        std::string r = "\"";
+        for (char c : s)
+            r += (c == '"') ? std::string("\"\"") : std::string(1, c);
+        return r + "\"";
+    }
+
+    static std::string json_string(const std::string &s) {
+        std::string r = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r + "\"";
+    }
+
+    Profiler::Profiler() : _enabled(false), _samplingPeriod(1) {
+        reset();
+    }
+
+    void Profiler::reset() {
+        _stats.clear();
+        _fires = 0;
+        _lastTick = MAXTICK;
+        _ticks = 0;
+        _inTick = 0;
+        _maxPerTick = 0;
+        _toSample = 0;
+        _depthSamples = 0;
+        _depthSum = 0;
+        _maxDepth = 0;
+    }
+
+    void Profiler::setSamplingPeriod(unsigned int n) {
+        if (n == 0)
+            throw Exc("The sampling period must be positive");
+        _samplingPeriod = n;
+        _toSample = 0;
+    }
+
+    Profiler::EventStats &Profiler::getStats(const Event &e) {
+        auto it = _stats.find(std::type_index(typeid(e)));
+        if (it == _stats.end()) {
+            it = _stats.emplace(std::type_index(typeid(e)), EventStats()).first;
+            it->second.name = demangle_compiler_name(typeid(e).name());
+        }
+        return it->second;
+    }
+
+    void Profiler::onPost(const Event &e) {
+        ++getStats(e).posts;
+    }
+
+    void Profiler::onDrop(const Event &e) {
+        ++getStats(e).drops;
+    }
+
+    void Profiler::onFire(const Event &e, uint64_t doitTime,
+                          uint64_t probeTime, std::size_t nprobes) {
+        EventStats &s = getStats(e);
+        ++s.fires;
+        s.doitTime += doitTime;
+        s.probes += nprobes;
+        s.probeTime += probeTime;
+    }
+
+    void Profiler::onStep(const Tick &t, std::size_t depth) {
+        ++_fires;
+
+        if (t != _lastTick) {
+            _lastTick = t;
+            ++_ticks;
+            _inTick = 0;
+        }
+        _maxPerTick = std::max(_maxPerTick, ++_inTick);
+
+        if (_toSample == 0) {
+            ++_depthSamples;
+            _depthSum += depth;
+            _maxDepth = std::max(_maxDepth, depth);
+            _toSample = _samplingPeriod;
+        }
+        --_toSample;
+    }
+
+    std::vector<Profiler::EventStats> Profiler::getEventStats() const {
+        std::vector<EventStats> v;
+        for (auto &p : _stats)
+            v.push_back(p.second);
+
+        // Ties broken by name, so that the report is reproducible
+        std::sort(v.begin(), v.end(),
+                  [](const EventStats &a, const EventStats &b) {
+                      if (a.doitTime != b.doitTime)
+                          return a.doitTime > b.doitTime;
+                      return a.name < b.name;
+                  });
+        return v;
+    }
+
+    double Profiler::getMeanQueueDepth() const {
+        return _depthSamples == 0 ? 0 : _depthSum / _depthSamples;
+    }
+
+    void Profiler::printCSV(std::ostream &os) const {
+        os << "event,posts,drops,fires,doit_ns,probes,probe_ns" << std::endl;
+        for (auto &s : getEventStats())
+            os << csv_field(s.name) << "," << s.posts << "," << s.drops
+               << "," << s.fires << "," << s.doitTime << "," << s.probes
+               << "," << s.probeTime << std::endl;
+
+        os << std::endl;
+        os << "counter,value" << std::endl;
+        os << "fires," << _fires << std::endl;
+        os << "ticks," << _ticks << std::endl;
+        os << "mean_events_per_tick,"
+           << (_ticks == 0 ? 0 : double(_fires) / _ticks) << std::endl;
+        os << "max_events_per_tick," << _maxPerTick << std::endl;
+        os << "queue_depth_samples," << _depthSamples << std::endl;
+        os << "mean_queue_depth," << getMeanQueueDepth() << std::endl;
+        os << "max_queue_depth," << _maxDepth << std::endl;
+    }
+
+    void Profiler::printJSON(std::ostream &os) const {
+        os << "{" << std::endl;
+        os << "  \"events\": [";
+        bool first = true;
+        for (auto &s : getEventStats()) {
+            os << (first ? "" : ",") << std::endl;
+            os << "    {\"event\": " << json_string(s.name)
+               << ", \"posts\": " << s.posts << ", \"drops\": " << s.drops
+               << ", \"fires\": " << s.fires
+               << ", \"doit_ns\": " << s.doitTime
+               << ", \"probes\": " << s.probes
+               << ", \"probe_ns\": " << s.probeTime << "}";
+            first = false;
+        }
+        os << std::endl << "  ]," << std::endl;
+        os << "  \"fires\": " << _fires << "," << std::endl;
+        os << "  \"ticks\": " << _ticks << "," << std::endl;
+        os << "  \"mean_events_per_tick\": "
+           << (_ticks == 0 ? 0 : double(_fires) / _ticks) << "," << std::endl;
+        os << "  \"max_events_per_tick\": " << _maxPerTick << ","
+           << std::endl;
+        os << "  \"queue_depth_samples\": " << _depthSamples << ","
+           << std::endl;
+        os << "  \"mean_queue_depth\": " << getMeanQueueDepth() << ","
+           << std::endl;
+        os << "  \"max_queue_depth\": " << _maxDepth << std::endl;
+        os << "}" << std::endl;
+    }
+
+    void Profiler::dump(const std::string &fname) const {
+        std::ofstream f(fname);
+        if (!f)
+            throw Exc("Cannot open " + fname);
+
+        const std::string ext = ".json";
+        if (fname.size() >= ext.size() &&
+            fname.compare(fname.size() - ext.size(), ext.size(), ext) == 0)
+            printJSON(f);
+        else
+            printCSV(f);
+    }
+
+} // namespace MetaSim
@@ -11,6 +11,7 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include <algorithm>
 #include <cmath>
 #include <metasim/memory.hpp>
 #include <string>
@@ -35,10 +36,6 @@ namespace MetaSim {
     using std::unique_ptr;
     using std::vector;
 
-    RandomGen RandomVar::_stdgen(1);
-
-    RandomGen *RandomVar::_pstdgen(&_stdgen);
-
     const RandNum RandomGen::A = 16807;
     const RandNum RandomGen::M = 2147483647;
     const RandNum RandomGen::Q = 127773; // M div A
@@ -71,24 +68,107 @@ namespace MetaSim {
 
     /*---------------------------------------------------*/
 
+    PhiloxGen::PhiloxGen(uint64_t stream) :
+        RandomGen(1),
+        _ctx(&SimulationContext::current()),
+        _stream(stream),
+        _epoch(_ctx->_streamEpoch),
+        _draw(0) {}
+
+    void PhiloxGen::init(RandNum s) {
+        _stream = s;
+        _draw = 0;
+    }
+
+    void PhiloxGen::philox(uint32_t ctr[4], const uint32_t key[2]) {
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                k0 += 0x9E3779B9;
+                k1 += 0xBB67AE85;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53) * ctr[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57) * ctr[2];
+            uint32_t c0 = uint32_t(p1 >> 32) ^ ctr[1] ^ k0;
+            uint32_t c2 = uint32_t(p0 >> 32) ^ ctr[3] ^ k1;
+            ctr[1] = uint32_t(p1);
+            ctr[3] = uint32_t(p0);
+            ctr[0] = c0;
+            ctr[2] = c2;
+        }
+    }
+
+    RandNum PhiloxGen::sample() {
+        if (_epoch != _ctx->_streamEpoch) {
+            _epoch = _ctx->_streamEpoch;
+            _draw = 0;
+        }
+
+        // One block gives four numbers
+        if ((_draw & 3) == 0) {
+            uint64_t blk = _draw >> 2;
+            _block[0] = uint32_t(blk);
+            _block[1] = uint32_t(blk >> 32);
+            _block[2] = uint32_t(_ctx->_streamRun);
+            _block[3] = uint32_t(_ctx->_streamSeed);
+            const uint32_t key[2] = {uint32_t(_stream),
+                                     uint32_t(_stream >> 32)};
+            philox(_block, key);
+        }
+        uint32_t x = _block[_draw & 3];
+        ++_draw;
+
+        // Same range of the Lehmer generator, [1, M - 1]
+        return 1 + RandNum((uint64_t(x) * uint64_t(getModule() - 1)) >> 32);
+    }
+
+    /*---------------------------------------------------*/
+
     const unsigned long PoissonVar::CUTOFF = 10000;
 
-    RandomVar::RandomVar() : _gen(_pstdgen) {
+    RandomVar::RandomVar() : _gen(SimulationContext::current()._pstdgen) {
         __regrandvar_init();
     }
 
-    RandomVar::RandomVar(const RandomVar &r) : _gen(r._gen) {}
+    RandomVar::RandomVar(const RandomVar &r) : _gen(r._gen) {
+        if (r._ownGen) {
+            const PhiloxGen &g = static_cast<const PhiloxGen &>(*r._ownGen);
+            _ownGen.reset(new PhiloxGen(g));
+            _gen = _ownGen.get();
+        }
+    }
 
     RandomVar::~RandomVar() {}
 
+    void RandomVar::init(RandNum s) {
+        SimulationContext &ctx = SimulationContext::current();
+        ctx._pstdgen->init(s);
+        ctx._streamSeed = s;
+        ctx._streamRun = 0;
+        ++ctx._streamEpoch;
+    }
+
+    void RandomVar::newRun() {
+        SimulationContext &ctx = SimulationContext::current();
+        ++ctx._streamRun;
+        ++ctx._streamEpoch;
+    }
+
+    void RandomVar::setStream(uint64_t stream) {
+        _ownGen.reset(new PhiloxGen(stream));
+        _gen = _ownGen.get();
+    }
+
     RandomGen *RandomVar::changeGenerator(RandomGen *g) {
-        RandomGen *old = _pstdgen;
-        _pstdgen = g;
+        SimulationContext &ctx = SimulationContext::current();
+        RandomGen *old = ctx._pstdgen;
+        ctx._pstdgen = g;
         return old;
     }
 
     void RandomVar::restoreGenerator() {
-        _pstdgen = &_stdgen;
+        SimulationContext &ctx = SimulationContext::current();
+        ctx._pstdgen = &ctx._stdgen;
     }
 
     /*-----------------------------------------------------*/
@@ -102,7 +182,29 @@ namespace MetaSim {
 
     /*-----------------------------------------------------*/
 
+    void UniformVar::setBlockSize(std::size_t n) {
+        _block.assign(n, 0.0);
+        _blockPos = n;
+    }
+
+    void UniformVar::refill() {
+        const double scale = (_max - _min) / _gen->getModule();
+        const std::size_t n = _block.size();
+        double *buf = _block.data();
+
+        // Drawing is sequential, the transform is a separate loop
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = _gen->sample() * scale + _min;
+        transform(buf, n);
+
+        _blockPos = 0;
+    }
+
     double UniformVar::get() {
+        double v;
+        if (fromBlock(v))
+            return v;
+
         if (generatedValue == 0.0) {
             double tmp;
             tmp = _gen->sample();
@@ -127,9 +229,18 @@ namespace MetaSim {
     /*-----------------------------------------------------*/
 
     double ExponentialVar::get() {
+        double v;
+        if (fromBlock(v))
+            return v;
         return -log(UniformVar::get()) / _lambda;
     }
 
+    void ExponentialVar::transform(double *buf, std::size_t n) {
+        const double lambda = _lambda;
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = -std::log(buf[i]) / lambda;
+    }
+
     std::unique_ptr<ExponentialVar>
         ExponentialVar::createInstance(vector<string> &par) {
         if (par.size() != 1)
@@ -142,9 +253,18 @@ namespace MetaSim {
     /*-----------------------------------------------------*/
 
     double WeibullVar::get() {
+        double v;
+        if (fromBlock(v))
+            return v;
         return _l * pow(-log(UniformVar::get()), 1.0 / _k);
     }
 
+    void WeibullVar::transform(double *buf, std::size_t n) {
+        const double l = _l, e = 1.0 / _k;
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = l * std::pow(-std::log(buf[i]), e);
+    }
+
     std::unique_ptr<WeibullVar>
         WeibullVar::createInstance(vector<string> &par) {
         if (par.size() != 2)
@@ -158,9 +278,18 @@ namespace MetaSim {
     /*-----------------------------------------------------*/
 
     double ParetoVar::get() {
+        double v;
+        if (fromBlock(v))
+            return v;
         return _mu * pow(UniformVar::get(), -1 / _order);
     };
 
+    void ParetoVar::transform(double *buf, std::size_t n) {
+        const double mu = _mu, e = -1 / _order;
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = mu * std::pow(buf[i], e);
+    }
+
     unique_ptr<ParetoVar> ParetoVar::createInstance(vector<string> &par) {
         double a, b;
 
@@ -178,8 +307,13 @@ namespace MetaSim {
         const double epsilon = std::numeric_limits<double>::min();
         const double two_pi = 2.0 * 3.14159265358979323846;
 
-        static double z0, z1;
-        static bool generate;
+        double v;
+        if (fromBlock(v))
+            return v;
+
+        // Shared by all the normal variables of the thread
+        thread_local static double z0, z1;
+        thread_local static bool generate;
         generate = !generate;
 
         if (!generate)
@@ -197,6 +331,23 @@ namespace MetaSim {
         return z0 * _sigma + _mu;
     }
 
+    void NormalVar::setBlockSize(std::size_t n) {
+        UniformVar::setBlockSize(n + n % 2);
+    }
+
+    void NormalVar::transform(double *buf, std::size_t n) {
+        const double epsilon = std::numeric_limits<double>::min();
+        const double two_pi = 2.0 * 3.14159265358979323846;
+        const double mu = _mu, sigma = _sigma;
+
+        for (std::size_t i = 0; i + 1 < n; i += 2) {
+            double r = std::sqrt(-2.0 * std::log(std::max(buf[i], epsilon)));
+            double a = two_pi * buf[i + 1];
+            buf[i] = r * std::cos(a) * sigma + mu;
+            buf[i + 1] = r * std::sin(a) * sigma + mu;
+        }
+    }
+
     std::unique_ptr<NormalVar> NormalVar::createInstance(vector<string> &par) {
         double a, b;
 
@@ -210,18 +361,31 @@ namespace MetaSim {
 
     /*-----------------------------------------------------*/
 
-    double PoissonVar::get() {
-        double u = UniformVar::get();
-        double F = exp(-_lambda);
+    // inversion of the cumulative distribution function
+    static double poisson_inverse(double u, double lambda,
+                                  unsigned long cutoff) {
+        double F = exp(-lambda);
         double S = F;
 
-        for (unsigned int i = 1; i < CUTOFF; ++i) {
+        for (unsigned int i = 1; i < cutoff; ++i) {
             if (u < S)
                 return i - 1;
-            F = F * _lambda / double(i);
+            F = F * lambda / double(i);
             S += F;
         }
-        return CUTOFF;
+        return cutoff;
+    }
+
+    double PoissonVar::get() {
+        double v;
+        if (fromBlock(v))
+            return v;
+        return poisson_inverse(UniformVar::get(), _lambda, CUTOFF);
+    }
+
+    void PoissonVar::transform(double *buf, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            buf[i] = poisson_inverse(buf[i], _lambda, CUTOFF);
     }
 
     unique_ptr<PoissonVar> PoissonVar::createInstance(vector<string> &par) {
@@ -0,0 +1,122 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <metasim/basestat.hpp>
+#include <metasim/replication.hpp>
+#include <metasim/simul.hpp>
+
+namespace MetaSim {
+
+    ReplicationRunner::ReplicationRunner(ModelFactory factory,
+                                         unsigned int workers) :
+        _factory(factory),
+        _workers(workers) {
+        if (_workers == 0)
+            _workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    RandNum ReplicationRunner::getSeed(RandNum seed, int r) {
+        // splitmix64 finalizer on the (seed, r) pair, reduced to
+        // [1, M - 1] as required by the Lehmer generator
+        uint64_t z = (uint64_t(seed) << 32) ^ uint64_t(r);
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z = z ^ (z >> 31);
+
+        RandomGen g(1);
+        return RandNum(z % uint64_t(g.getModule() - 1)) + 1;
+    }
+
+    void ReplicationRunner::run(Tick endTick, int nRuns, RandNum seed) {
+        if (nRuns < 1)
+            throw Exc("The number of runs must be positive");
+        if (nRuns == 2)
+            nRuns = 3;
+
+        const size_t nstats = std::distance(BaseStat::begin(), BaseStat::end());
+        const unsigned int nworkers =
+            std::min(_workers, static_cast<unsigned int>(nRuns));
+
+        // samples[r][i] is the value of the i-th stat in run r
+        std::vector<std::vector<double>> samples(nRuns);
+
+        std::atomic<int> next(0);
+        std::exception_ptr error;
+        std::mutex error_mtx;
+
+        auto worker = [&]() {
+            try {
+                SimulationContext ctx;
+                SimulationContext::Scope scope(ctx);
+
+                std::shared_ptr<void> model = _factory();
+
+                if (size_t(std::distance(BaseStat::begin(),
+                                         BaseStat::end())) != nstats)
+                    throw Exc("The model built by the factory does not "
+                              "match the statistics of the current context");
+
+                Simulation &sim = ctx.getSimulation();
+                sim.initRuns(nRuns);
+
+                int r;
+                while ((r = next++) < nRuns) {
+                    RandomVar::init(getSeed(seed, r));
+                    sim.singleRun(endTick);
+
+                    samples[r].reserve(nstats);
+                    for (auto it = BaseStat::begin(); it != BaseStat::end();
+                         ++it)
+                        samples[r].push_back((*it)->getLastValue());
+                }
+
+                // Objects of the model must die before their context
+                model.reset();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if (!error)
+                    error = std::current_exception();
+                next = nRuns;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < nworkers; ++i)
+            threads.emplace_back(worker);
+        for (auto &t : threads)
+            t.join();
+
+        if (error)
+            std::rethrow_exception(error);
+
+        // Merge, as if the runs had been executed here in order
+        BaseStat::init(nRuns);
+        for (int r = 0; r < nRuns; ++r) {
+            size_t i = 0;
+            for (auto it = BaseStat::begin(); it != BaseStat::end(); ++it)
+                (*it)->_val = samples[r][i++];
+            BaseStat::endRun();
+        }
+        BaseStat::endSim();
+    }
+
+} // namespace MetaSim
@@ -0,0 +1,63 @@
+/***************************************************************************
+    begin                : Thu Apr 24 15:54:58 CEST 2003
+    copyright            : (C) 2003 by Giuseppe Lipari
+    email                : lipari@sssup.it
+ ***************************************************************************/
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include <metasim/eventqueue.hpp>
+#include <metasim/simcontext.hpp>
+#include <metasim/simul.hpp>
+
+namespace MetaSim {
+
+    thread_local SimulationContext *SimulationContext::_current = NULL;
+
+    SimulationContext::SimulationContext(const std::string &queue) :
+        _eventQueue(EventQueue::create(queue)),
+        _eventCounter(0),
+        _globMap(),
+        _index(),
+        _IDcount(0),
+        _statList(),
+        _totalNumOfExp(0),
+        _expNum(0),
+        _endOfSim(false),
+        _initFlag(false),
+        _transitory(0),
+        _stdgen(1),
+        _pstdgen(&_stdgen),
+        _streamSeed(1),
+        _streamRun(0),
+        _streamEpoch(0),
+        _simulation(new Simulation(*this)) {}
+
+    SimulationContext::~SimulationContext() {
+        if (_current == this)
+            _current = NULL;
+    }
+
+    void SimulationContext::setEventQueue(std::unique_ptr<EventQueue> q) {
+        _eventQueue = std::move(q);
+    }
+
+    SimulationContext &SimulationContext::getDefault() {
+        // Never destroyed: entities and events with static storage may
+        // still refer to it while the program exits
+        static SimulationContext *def = new SimulationContext();
+        return *def;
+    }
+
+    SimulationContext *SimulationContext::install(SimulationContext *ctx) {
+        SimulationContext *prev = _current;
+        _current = ctx;
+        return prev;
+    }
+
+} // namespace MetaSim
@@ -11,10 +11,17 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <deque>
 #include <iostream>
 #include <sstream>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <metasim/entity.hpp>
 #include <metasim/simul.hpp>
 namespace MetaSim {
@@ -25,31 +32,33 @@ namespace MetaSim {
     public:
         MsgEvt(const string &msg,
                int p = MetaSim::Event::_DEFAULT_PRIORITY + 10) :
-            Event("GenericMessage", p),
+            Event(typeName(), p),
             _msg(msg) {}
+
+        /// These events are disposable, the name is interned once
+        static const std::string *typeName() {
+            static const std::string *name = intern_string("GenericMessage");
+            return name;
+        }
+
         void doit() override {
             DBGPRINT(_msg);
             std::cout << _msg << std::endl;
         }
     };
 
-    Simulation *Simulation::instance_ = 0;
-
     class NoMoreEventsInQueue {};
 
-    Simulation::Simulation() :
+    Simulation::Simulation(SimulationContext &ctx) :
+        _ctx(ctx),
         dbg(),
         numRuns(0),
         actRuns(0),
         globTime(0),
-        end(false) {}
-
-    Simulation &Simulation::getInstance() {
-        if (instance_ == 0)
-            instance_ = new Simulation();
-
-        return *instance_;
-    }
+        end(false),
+        _batching(false),
+        _inBatch(false),
+        _batchCounter(0) {}
 
     const Tick Simulation::getTime() {
         return globTime;
@@ -65,12 +74,13 @@ namespace MetaSim {
         Event *temp;
         Tick mytime;
 
+        SimulationContext::Scope scope(_ctx);
         DBGENTER(_SIMUL_DBG_LEV);
 
         temp = Event::getFirst(); // takes the first event in the queue ...
         if (temp == NULL)
             throw NoMoreEventsInQueue();
-        temp->drop(); // ... and extract it!
+        temp->extract(); // ... and extract it!
 
         mytime = temp->getTime(); // stores the current time
 
@@ -83,12 +93,75 @@ namespace MetaSim {
         setTime(mytime);
 
         temp->action(); // do what it is supposed to do...
+
+        Profiler &prof = _ctx.getProfiler();
+        if (prof.isEnabled())
+            prof.onStep(mytime, _ctx.getEventQueue().size());
+
         if (temp->isDisposable()) // if it has to be deleted...
             delete temp; // delete it!
 
         return mytime;
     }
 
+    bool Simulation::deferToEndOfBatch(BatchHook *hook) {
+        if (!_inBatch)
+            return false;
+
+        if (!hook->_batchPending) {
+            hook->_batchPending = true;
+            _batchHooks.push_back(hook);
+        }
+        hook->_batchOrder = _batchCounter++;
+        return true;
+    }
+
+    const Tick Simulation::sim_batch() {
+        SimulationContext::Scope scope(_ctx);
+
+        Event *first = Event::getFirst();
+        if (first == NULL)
+            throw NoMoreEventsInQueue();
+
+        const Tick t = first->getTime();
+        const int prio = first->getPriority();
+
+        _inBatch = true;
+        try {
+            do {
+                sim_step();
+                first = Event::getFirst();
+            } while (first != NULL && first->getTime() == t &&
+                     first->getPriority() == prio);
+        } catch (...) {
+            _inBatch = false;
+            throw;
+        }
+        _inBatch = false;
+
+        endBatch();
+
+        return t;
+    }
+
+    void Simulation::endBatch() {
+        if (_batchHooks.empty())
+            return;
+
+        std::vector<BatchHook *> hooks;
+        hooks.swap(_batchHooks);
+        std::sort(hooks.begin(), hooks.end(),
+                  [](const BatchHook *a, const BatchHook *b) {
+                      return a->_batchOrder < b->_batchOrder;
+                  });
+        for (BatchHook *h : hooks)
+            h->_batchPending = false;
+
+        // Hooks run outside of the batch, hence they act immediately
+        for (BatchHook *h : hooks)
+            h->onEndOfBatch();
+    }
+
     // this event returns the time of the first event in the queue
     // (i.e. the next event to be processed) or throws and exception
     // if there is no more events in the queue
@@ -106,11 +179,12 @@ namespace MetaSim {
     // it returns the final tick
     // it stops before executing the first event after stop
     const Tick Simulation::run_to(const Tick &stop) {
+        SimulationContext::Scope scope(_ctx);
         try {
             MsgEvt msgEvt("run_to() end time reached");
             msgEvt.post(stop);
             while (getNextEventTime() <= stop) {
-                globTime = sim_step();
+                globTime = _batching ? sim_batch() : sim_step();
             }
         } catch (NoMoreEventsInQueue &e) {
             std::cerr << "No more events in queue: simulation time = "
@@ -120,33 +194,71 @@ namespace MetaSim {
         return globTime;
     }
 
+    const Tick Simulation::advance(const Tick &limit) {
+        SimulationContext::Scope scope(_ctx);
+
+        Event *temp;
+        while ((temp = Event::getFirst()) != NULL && temp->getTime() < limit)
+            globTime = _batching ? sim_batch() : sim_step();
+
+        return globTime;
+    }
+
     void Simulation::initRuns(int nRuns) {
+        SimulationContext::Scope scope(_ctx);
         BaseStat::init(nRuns);
         globTime = 0;
         end = false;
     }
 
     void Simulation::initSingleRun() {
+        SimulationContext::Scope scope(_ctx);
         globTime = 0;
 
         // Run Initialization:
         // Before each run, call the newRun() of every entity
         // and setup statistics
+        RandomVar::newRun();
         Entity::callNewRun();
 
         BaseStat::newRun();
     }
 
     void Simulation::endSingleRun() {
+        SimulationContext::Scope scope(_ctx);
         Entity::callEndRun();
         BaseStat::endRun();
 
         clearEventQueue();
     }
 
+    void Simulation::singleRun(Tick endTick) {
+        SimulationContext::Scope scope(_ctx);
+
+        initSingleRun();
+        continueRun(endTick);
+    }
+
+    void Simulation::continueRun(Tick endTick) {
+        SimulationContext::Scope scope(_ctx);
+
+        // MAIN CYCLE!!
+        try {
+            while (globTime < endTick) {
+                globTime = _batching ? sim_batch() : sim_step();
+            }
+        } catch (NoMoreEventsInQueue &e) {
+            std::cerr << "No more events in queue: simulation time ="
+                      << globTime << std::endl;
+        }
+
+        endSingleRun();
+    }
+
     // Main function:
     // This is the simulation engine
     void Simulation::run(Tick endTick, int nRuns) {
+        SimulationContext::Scope scope(_ctx);
         DBGENTER(_SIMUL_DBG_LEV);
         bool initializeRuns = true;
         bool terminateSim = true;
@@ -193,34 +305,63 @@ namespace MetaSim {
         while (actRuns < numRuns) {
             std::cout << "\n Run #" << actRuns << std::endl;
 
-            initSingleRun();
-
-            // MAIN CYCLE!!
-            try {
-                while (globTime < endTick) {
-                    globTime = sim_step();
-                }
-            } catch (NoMoreEventsInQueue &e) {
-                std::cerr << "No more events in queue: simulation time ="
-                          << globTime << std::endl;
-            }
-
-            endSingleRun();
+            singleRun(endTick);
 
             actRuns++; // next run....
         }
         end = true;
         if (terminateSim)
             endSim(); // the simulation is over!!
+
+        Profiler &prof = _ctx.getProfiler();
+        if (prof.isEnabled() && !prof.getOutput().empty())
+            prof.dump(prof.getOutput());
+    }
+
+    pid_t Simulation::fork() {
+        if (_inBatch)
+            throw Exc("Cannot fork the simulation while executing a batch");
+
+        // Otherwise, buffered output would be written twice
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(NULL);
+
+        pid_t pid = ::fork();
+        if (pid < 0)
+            throw Exc(std::string("fork() failed: ") + std::strerror(errno));
+        return pid;
+    }
+
+    int Simulation::waitFork(pid_t pid) {
+        int status;
+        while (::waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR)
+                throw Exc(std::string("waitpid() failed: ") +
+                          std::strerror(errno));
+        }
+
+        if (WIFEXITED(status))
+            return WEXITSTATUS(status);
+        throw Exc("The forked simulation did not terminate normally");
+    }
+
+    void Simulation::setEventQueue(const std::string &type) {
+        SimulationContext::Scope scope(_ctx);
+        Event::setEventQueue(EventQueue::create(type));
     }
 
     void Simulation::clearEventQueue() {
+        SimulationContext::Scope scope(_ctx);
         Event *temp;
         while ((temp = Event::getFirst()) != NULL) {
             temp->drop();
             if (temp->isDisposable()) // if it has to be deleted...
                 delete temp;
         }
+        for (BatchHook *h : _batchHooks)
+            h->_batchPending = false;
+        _batchHooks.clear();
         globTime = 0;
     }
 
@@ -233,13 +374,15 @@ namespace MetaSim {
     }
 
     // wrappers for debug entry/exit
-    void Simulation::dbgEnter(string lev, string header) {
-        std::stringstream ss;
-
-        ss << "t = [" << globTime << "] --> " + header;
-        // string h = "t = [" + string(globTime) + "] --> " + header;
-        // dbg.enter(lev, h);
-        dbg.enter(lev, ss.str());
+    void Simulation::dbgEnter(const string &lev, const char *header) {
+        dbg.enter(lev);
+
+        // The header is built only when it is going to be printed
+        if (dbg.filter()) {
+            std::stringstream ss;
+            ss << "t = [" << globTime << "] --> " << header;
+            dbg.header(ss.str());
+        }
     }
 
     void Simulation::dbgExit() {
@@ -247,6 +390,7 @@ namespace MetaSim {
     }
 
     void Simulation::endSim() {
+        SimulationContext::Scope scope(_ctx);
         // Collect statistics
         BaseStat::endSim();
     }
@@ -0,0 +1,133 @@
+#include <algorithm>
+
+// RTSim
+#include <rtsim/admission.hpp>
+
+namespace RTSim {
+
+    void UtilizationTracker::account(Sums &s, const Entry &e) {
+        s.utilization += e.utilization;
+        s.density += e.density;
+        ++s.tasks;
+    }
+
+    void UtilizationTracker::unaccount(Sums &s, const Entry &e) {
+        // Restart from zero on empty CPUs, so that rounding errors do not
+        // accumulate over the simulation
+        if (--s.tasks == 0) {
+            s.utilization = 0.0;
+            s.density = 0.0;
+        } else {
+            s.utilization -= e.utilization;
+            s.density -= e.density;
+        }
+    }
+
+    void UtilizationTracker::addTask(const CPU *c, const AbsRTTask *task) {
+        if (contains(task))
+            throw Exc("Task already accounted");
+
+        Entry e = {c, getTaskUtilization(task), getTaskDensity(task)};
+        account(_cpus[c], e);
+        _tasks.emplace(task, e);
+    }
+
+    void UtilizationTracker::removeTask(const AbsRTTask *task) {
+        auto it = _tasks.find(task);
+        if (it == _tasks.end())
+            return;
+
+        unaccount(_cpus[it->second.cpu], it->second);
+        _tasks.erase(it);
+    }
+
+    void UtilizationTracker::migrate(const AbsRTTask *task, const CPU *c) {
+        auto it = _tasks.find(task);
+        if (it == _tasks.end())
+            throw Exc("Migrating a task not accounted");
+
+        Entry &e = it->second;
+        if (e.cpu == c)
+            return;
+        unaccount(_cpus[e.cpu], e);
+        e.cpu = c;
+        account(_cpus[c], e);
+    }
+
+    void UtilizationTracker::clear(const CPU *c) {
+        for (auto it = _tasks.begin(); it != _tasks.end();) {
+            if (it->second.cpu == c)
+                it = _tasks.erase(it);
+            else
+                ++it;
+        }
+        _cpus.erase(c);
+    }
+
+    void UtilizationTracker::clear() {
+        _tasks.clear();
+        _cpus.clear();
+    }
+
+    const CPU *UtilizationTracker::getProcessor(const AbsRTTask *task) const {
+        auto it = _tasks.find(task);
+        return it == _tasks.end() ? nullptr : it->second.cpu;
+    }
+
+    size_t UtilizationTracker::getNumTasks(const CPU *c) const {
+        auto it = _cpus.find(c);
+        return it == _cpus.end() ? 0 : it->second.tasks;
+    }
+
+    double UtilizationTracker::getUtilization(const CPU *c,
+                                              double speed) const {
+        auto it = _cpus.find(c);
+        return it == _cpus.end() ? 0.0 : it->second.utilization / speed;
+    }
+
+    double UtilizationTracker::getDensity(const CPU *c, double speed) const {
+        auto it = _cpus.find(c);
+        return it == _cpus.end() ? 0.0 : it->second.density / speed;
+    }
+
+    double UtilizationTracker::getTaskUtilization(const AbsRTTask *task) const {
+        auto it = _tasks.find(task);
+        if (it != _tasks.end())
+            return it->second.utilization;
+
+        Tick period = task->getPeriod();
+        if (period <= 0)
+            throw Exc("The period must be positive");
+        return task->getWCET(1.0) / double(period);
+    }
+
+    double UtilizationTracker::getTaskDensity(const AbsRTTask *task) const {
+        auto it = _tasks.find(task);
+        if (it != _tasks.end())
+            return it->second.density;
+
+        Tick period = task->getPeriod();
+        if (period <= 0)
+            throw Exc("The period must be positive");
+        Tick dline = task->getRelDline();
+        if (dline <= 0 || dline > period)
+            dline = period;
+        return task->getWCET(1.0) / double(dline);
+    }
+
+    size_t UtilizationTracker::getMinOPP(const CPU *c, double demand,
+                                         WorkloadId workload, size_t first) {
+        CPUIsland *island = c->getIsland();
+        if (island == nullptr)
+            throw Exc("The CPU does not belong to an island");
+
+        const std::vector<speed_type> &speed =
+            island->getOPPTable(workload).speed;
+        if (first >= speed.size())
+            return speed.size();
+        return std::lower_bound(speed.cbegin() + first, speed.cend(),
+                                demand) -
+               speed.cbegin();
+    }
+
+} // namespace RTSim
@@ -1 +1,25 @@
 #include <rtsim/cpu.hpp>
+#include <rtsim/instr.hpp>
+
+namespace RTSim {
+
+    void CPUIsland::updateModels() {
+        // NOTICE: The power model is held by the
+        // CPUIsland, but always queried by each CPU
+        if (_powermodel == nullptr)
+            return;
+
+        for (auto cpu : _cpus) {
+            const speed_type old_speed = cpu->getSpeed();
+            cpu->updateModel();
+
+            // Only the instructions whose speed actually changed are
+            // re-timed (e.g. not on disabled CPUs)
+            const speed_type new_speed = cpu->getSpeed();
+            if (cpu->_instr != nullptr && new_speed != old_speed &&
+                new_speed > 0)
+                cpu->_instr->refreshExec(old_speed, new_speed);
+        }
+    }
+
+} // namespace RTSim
@@ -111,17 +111,19 @@ namespace RTSim {
 
     double EnergyMRTKernel::getUtilization(AbsRTTask *task,
                                            double capacity) const {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         double util =
             ceil(task->getRemainingWCET(capacity)) / double(task->getPeriod());
 
-        printf(
-            "\t\t\tgetUtilization of considered task %f/%f (capacity=%f)=%f\n",
-            task->getRemainingWCET(capacity), double(task->getPeriod()),
-            capacity, util);
+        DBGPRINT("\t\t\tgetUtilization of considered task ",
+                 task->getRemainingWCET(capacity), "/",
+                 double(task->getPeriod()), " (capacity=", capacity, ")=",
+                 util);
         return util;
     }
 
     double EnergyMRTKernel::getUtilization(CPU_BL *c, double capacity) const {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         double utilization = 0.0;
         vector<AbsRTTask *> ths = getReadyTasks(c);
         AbsRTTask *runningTask =
@@ -138,26 +140,23 @@ namespace RTSim {
 
             utilization +=
                 ceil(th->getRemainingWCET(capacity)) / double(th->getPeriod());
-            std::cout << "\t\t\tUtilization task already in CPU, "
-                      << th->toString() << ", is "
-                      << ceil(th->getWCET(capacity)) << "/" << th->getPeriod()
-                      << " = "
-                      << ceil(th->getRemainingWCET(capacity)) /
-                             double(th->getPeriod())
-                      << " - CPU capacity=" << capacity << std::endl
-                      << "\t\t\t\ttask WCET "
-                      << ceil(th->getRemainingWCET(capacity)) << " DL "
-                      << th->getPeriod() << std::endl;
+            DBGPRINT("\t\t\tUtilization task already in CPU, ", th->toString(),
+                     ", is ", ceil(th->getWCET(capacity)), "/", th->getPeriod(),
+                     " = ",
+                     ceil(th->getRemainingWCET(capacity)) /
+                         double(th->getPeriod()),
+                     " - CPU capacity=", capacity);
+            DBGPRINT("\t\t\t\ttask WCET ", ceil(th->getRemainingWCET(capacity)),
+                     " DL ", th->getPeriod());
         }
 
         double u_active = _queues->getUtilization_active(c);
-        std::cout << "\t\t\tU_active on core " << c->getName()
-                  << " (for CBS server): " << u_active << std::endl;
+        DBGPRINT("\t\t\tU_active on core ", c->getName(), " (for CBS server): ",
+                 u_active);
         utilization += u_active;
 
         double u_tempMig = getUtilization_temporarilyMigrated(c);
-        std::cout << "\t\t\tU_tempMig on " << c->toString() << " = "
-                  << u_tempMig << std::endl;
+        DBGPRINT("\t\t\tU_tempMig on ", c->toString(), " = ", u_tempMig);
         utilization += u_tempMig;
 
         return utilization;
@@ -166,24 +165,23 @@ namespace RTSim {
     double EnergyMRTKernel::getIslandUtilization(double capacity,
                                                  IslandType island,
                                                  int *nTasksIsland) const {
-        std::cout << "\t\t\t" << __func__ << "()" << std::endl;
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+        DBGPRINT("\t\t\t", __func__, "()");
         // Sum of running and ready tasks on island + utils active
         double utilizationIsland = 0.0;
 
         for (CPU_BL *c1 : getProcessors(island)) {
-            std::cout << "\t\t\t\t" << c1->getName() << ":" << std::endl;
+            DBGPRINT("\t\t\t\t", c1->getName(), ":");
 
             utilizationIsland += getUtilization(c1, capacity);
 
             double u_active_c1 = _queues->getUtilization_active(c1);
             utilizationIsland += u_active_c1;
-            std::cout << "\t\t\t\tutil active=" << u_active_c1 << " ("
-                      << c1->getName() << ") -> isl util=" << utilizationIsland
-                      << std::endl;
+            DBGPRINT("\t\t\t\tutil active=", u_active_c1, " (", c1->getName(),
+                     ") -> isl util=", utilizationIsland);
         }
 
-        std::cout << "\t\t\t\tisland utilization=" << utilizationIsland
-                  << std::endl;
+        DBGPRINT("\t\t\t\tisland utilization=", utilizationIsland);
         return utilizationIsland;
     }
 
@@ -192,44 +190,38 @@ namespace RTSim {
     bool EnergyMRTKernel::getCBServer_Utilization(AbsRTTask *task,
                                                   double &utilization,
                                                   const double capacity) const {
-        std::cout << "\t\t\t\t" << __func__ << "(). init util=" << utilization
-                  << std::endl;
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+        DBGPRINT("\t\t\t\t", __func__, "(). init util=", utilization);
         CBServerCallingEMRTKernel *cbs =
             dynamic_cast<CBServerCallingEMRTKernel *>(task);
 
         if (cbs == NULL) {
-            std::cout << "\t\t\t\t\tnot a CBServerCallingEMRTKernel => skip"
-                      << std::endl;
+            DBGPRINT("\t\t\t\t\tnot a CBServerCallingEMRTKernel => skip");
             return false;
         }
 
         if (cbs->isEmpty()) {
-            std::cout << "\t\t\t\t\tServer's empty => skip, you consider "
-                         "Util_actives ("
-                      << cbs->getName() << ")" << std::endl;
+            DBGPRINT("\t\t\t\t\tServer's empty => skip, you consider "
+                     "Util_actives (", cbs->getName(), ")");
             return true;
         }
 
         // todo rem
-        std::cout << "\t\t\t\t\tserver status: " << cbs->getStatusString()
-                  << std::endl;
+        DBGPRINT("\t\t\t\t\tserver status: ", cbs->getStatusString());
         // server utilization (its WCET/period) considered only if it's
         // executing or recharging
         if (cbs->getStatus() == ServerStatus::EXECUTING ||
             cbs->getStatus() == ServerStatus::RECHARGING) {
             utilization +=
                 cbs->getRemainingWCET(capacity) / double(cbs->getPeriod());
-            std::cout
-                << "\t\t\t\t\tCBS server is executing. utilization increased "
-                   "to "
-                << cbs->getRemainingWCET(capacity) << "/"
-                << double(cbs->getPeriod()) << "=" << utilization
-                << " capacity=" << capacity << std::endl;
+            DBGPRINT("\t\t\t\t\tCBS server is executing. utilization "
+                     "increased to ", cbs->getRemainingWCET(capacity), "/",
+                     double(cbs->getPeriod()), "=", utilization, " capacity=",
+                     capacity);
             return true;
         }
 
-        std::cout << "\t\t\t\t\tCBS server not executing or recharging => skip"
-                  << std::endl;
+        DBGPRINT("\t\t\t\t\tCBS server not executing or recharging => skip");
         return false;
     }
 
@@ -251,6 +243,7 @@ namespace RTSim {
 
     void EnergyMRTKernel::onOppChanged(unsigned int curropp,
                                        Island_BL *island) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         if (isTryngTaskOnCPU_BL())
             return;
 
@@ -269,38 +262,38 @@ namespace RTSim {
             if (c == NULL)
                 continue;
 
-            string startingWL = c->getWorkload();
-            c->setWorkload(Utils::getTaskWorkload(elem.first));
-            std::cout << __func__ << "(). cpu of elem is " << c->toString()
-                      << " wl: " << c->getWorkload() << std::endl;
+            WorkloadId startingWL = c->getWorkloadId();
+            c->setWorkload(Utils::getTaskWorkloadId(elem.first));
+            DBGPRINT(__func__, "(). cpu of elem is ", c->toString(), " wl: ",
+                     c->getWorkload());
             if (c->getIsland()->type() == island->type()) {
                 Tick taskWCET = Tick(ceil(elem.first->getWCET(c->getSpeed())));
-                std::cout << __func__ << "(). changing budget to "
-                          << elem.second->toString() << " to " << taskWCET
-                          << ". core: " << c->toString()
-                          << " speed:" << c->getSpeed() << std::endl;
+                DBGPRINT(__func__, "(). changing budget to ",
+                         elem.second->toString(), " to ", taskWCET, ". core: ",
+                         c->toString(), " speed:", c->getSpeed());
                 elem.second->changeBudget(taskWCET);
                 // elem.second->changeQ(taskWCET);
             }
 
             c->setWorkload(startingWL);
         }
-        std::cout << std::endl;
 
-        // scale wcets of tasks on the island
+        // The instructions running on the island have already been re-timed
+        // by CPUIsland::setOPP()
     }
 
     // ----------------------------------------------------------- testing
 
     void EnergyMRTKernel::test() {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         // PeriodicTask T7_task0 DL = T 500 WCET(abs) 63 in CPU LITTLE_0 freq
         // 500 freq 3
         AbsRTTask *t = dynamic_cast<AbsRTTask *>(_sched->getTaskN(0));
         CPU_BL *p;
         dispatch(p, t, 3);
         p->setWorkload("bzip2");
-        std::cout << "CPU is " << p->toString() << " freq " << p->getFrequency()
-                  << " " << t->toString() << std::endl;
+        DBGPRINT("CPU is ", p->toString(), " freq ", p->getFrequency(), " ",
+                 t->toString());
 
         int nTaskIsland = 0;
         // std::cout << "task util " << getIslandUtilization(p->getSpeed(500.0),
@@ -321,41 +314,39 @@ namespace RTSim {
 
     void EnergyMRTKernel::printState(bool alsoQueues,
                                      bool alsoCBSStatus) const {
-        std::cout << "t=" << SIMUL.getTime()
-                  << " State of scheduler:" << std::endl
-                  << "Running tasks:" << std::endl
-                  << "\t";
+        // Goes through the debug stream, so that it is printed only
+        // within enabled debug levels
+        DebugStream &out = SIMUL.dbg;
+        out << "t=" << SIMUL.getTime() << " State of scheduler:" << std::endl
+            << "Running tasks:" << std::endl
+            << "\t";
         for (CPU_BL *c : getProcessors()) {
             AbsRTTask *t = _queues->getRunningTask(c);
             if (dynamic_cast<CBServer *>(t) &&
                 dynamic_cast<CBServer *>(t)->isYielding())
                 t = _queues->getFirstReady(c);
-            std::cout << c->getName() << ": " << (t == NULL ? "0" : taskname(t))
-                      << "\t";
+            out << c->getName() << ": " << (t == NULL ? "0" : taskname(t))
+                << "\t";
         }
 
         if (alsoQueues)
-            std::cout << std::endl
-                      << "Queues:" << std::endl
-                      << _queues->toString();
+            out << std::endl << "Queues:" << std::endl << _queues->toString();
 
         if (alsoCBSStatus) {
-            std::cout << "CBS servers (= periodic tasks) statuses:"
-                      << std::endl;
+            out << "CBS servers (= periodic tasks) statuses:" << std::endl;
             for (const auto &elem : _envelopes) {
-                std::cout << "- " << elem.second->toString();
+                out << "- " << elem.second->toString();
                 if (elem.second->getStatus() == ServerStatus::RELEASING) {
-                    std::cout
-                        << ". util_active="
+                    out << ". util_active="
                         << std::to_string(
                                _queues->getUtilization_active(elem.second))
                         << " expires at t=" << elem.second->getVirtualTime();
                 }
-                std::cout << std::endl;
+                out << std::endl;
             }
         }
 
-        std::cout << std::endl;
+        out << std::endl;
     }
 
     void EnergyMRTKernel::addForcedDispatch(AbsRTTask *t, CPU_BL *c,
@@ -366,10 +357,11 @@ namespace RTSim {
 
     // for gdb
     bool EnergyMRTKernel::manageForcedDispatch(AbsRTTask *t) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         if (_m_forcedDispatch.find(t) !=
             _m_forcedDispatch.end()) { //&& std::get<2>(_m_forcedDispatch[t]) ==
                                        // SIMUL.getTime()) {
-            std::cout << __func__ << std::endl;
+            DBGPRINT(__func__);
             dispatch(std::get<0>(_m_forcedDispatch[t]), t,
                      std::get<1>(_m_forcedDispatch[t]));
 
@@ -415,7 +407,7 @@ namespace RTSim {
     // onEBM(), as in MRTKernel) Begins context switch on a core, task is at the
     // end of onBDM() still ready on core.
     void EnergyMRTKernel::onBeginDispatchMulti(BeginDispatchMultiEvt *e) {
-        DBGENTER(_KERNEL_DBG_LEV);
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
 
         CPU_BL *p = dynamic_cast<CPU_BL *>(e->getCPU());
         AbsRTTask *dt = _queues->getRunningTask(p);
@@ -423,31 +415,26 @@ namespace RTSim {
         assert(st != NULL);
         assert(p != NULL);
 
-        std::cout << std::endl
-                  << "time =" << SIMUL.getTime()
-                  << " EnergyMRTKernel::onBeginDispatchMulti() for "
-                  << taskname(st) << " on " << p->toString() << std::endl;
+        DBGPRINT("time =", SIMUL.getTime(),
+                 " EnergyMRTKernel::onBeginDispatchMulti() for ", taskname(st),
+                 " on ", p->toString());
         if (st != NULL && dt == st) {
             string ss = "Decided to dispatch " + st->toString() +
                         " on its former CPU => skip context switch";
             DBGPRINT(ss);
-            std::cout << ss << std::endl;
         }
         // if necessary, deschedule the task.
         if (dt != NULL || isToBeDescheduled(p, dt)) {
-            _m_oldExe[dt] = p;
-            _m_currExe[p] = NULL;
+            setOldProcessor(dt, p);
+            setExecuting(p, NULL);
             dt->deschedule();
-            std::cout << dt->toString() << " descheduled for " << taskname(st)
-                      << std::endl;
+            DBGPRINT(dt->toString(), " descheduled for ", taskname(st));
         }
 
         DBGPRINT("Scheduling task ", taskname(st), " on cpu ", p->toString());
-        std::cout << __func__ << " Scheduling task " << taskname(st)
-                  << " on cpu " << p->toString() << std::endl;
 
         //_endEvt[p]->setTask(st);
-        _isContextSwitching[p] = true;
+        setContextSwitching(p, true);
         // if you exit(0) here, dispatch() has already chosen a CPU forall tasks
         // exit(0);
         Tick overhead(_contextSwitchDelay);
@@ -457,9 +444,8 @@ namespace RTSim {
 
         _queues->onBeginDispatchMultiFinished(p, st, overhead);
 
-        std::cout << "\t" << taskname(st)
-                  << " end ctx switch set at t=" << SIMUL.getTime() + overhead
-                  << " - overhead=" << overhead << std::endl;
+        DBGPRINT("\t", taskname(st), " end ctx switch set at t=",
+                 SIMUL.getTime() + overhead, " - overhead=", overhead);
     }
 
     /**
@@ -467,15 +453,15 @@ namespace RTSim {
         Here task begins executing in its core. End of context switch on core.
       */
     void EnergyMRTKernel::onEndDispatchMulti(EndDispatchMultiEvt *e) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         AbsRTTask *t = e->getTask();
         CPU_BL *cpu = dynamic_cast<CPU_BL *>(e->getCPU());
         assert(t != NULL);
         assert(cpu != NULL);
 
-        std::cout << std::endl
-                  << "time =" << SIMUL.getTime()
-                  << " EnergyMRTKernel::onEndDispatchMulti() for "
-                  << taskname(t) << " on " << cpu->toString() << std::endl;
+        DBGPRINT("time =", SIMUL.getTime(),
+                 " EnergyMRTKernel::onEndDispatchMulti() for ", taskname(t),
+                 " on ", cpu->toString());
         _queues->onEndDispatchMultiFinished(cpu, t);
         MRTKernel::onEndDispatchMulti(e);
 
@@ -488,14 +474,12 @@ namespace RTSim {
         // these instructions below
         unsigned int opp = _queues->getOPP(cpu);
         if (opp > cpu->getOPP()) {
-            std::cout << "\t" << t->toString() << " " << cpu->toString()
-                      << " updating opp to " << opp << std::endl;
+            DBGPRINT("\t", t->toString(), " ", cpu->toString(),
+                     " updating opp to ", opp);
             cpu->setOPP(opp);
         }
 
-        _m_oldExe[t] = cpu;
-
-        std::cout << std::endl;
+        setOldProcessor(t, cpu);
 
         onTaskGetsRunning(t, cpu);
     }
@@ -504,75 +488,74 @@ namespace RTSim {
     // WCET
 
     void EnergyMRTKernel::onEnd(AbsRTTask *t) {
-        DBGENTER(_KERNEL_DBG_LEV);
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
 
         // only on big-little: update the state of the CPUs island
         CPU_BL *p = dynamic_cast<CPU_BL *>(getProcessor(t));
         DBGPRINT(t->toString(), " has just finished on ", p->toString(),
                  ". Actual time = [", SIMUL.getTime(), "]");
-        std::cout << ".............................." << std::endl;
-        std::cout << "\tActual time = [" << SIMUL.getTime()
-                  << "]. EMRTK::" << __func__ << "(). " << t->toString()
-                  << " has just finished on " << p->toString() << std::endl;
+        DBGPRINT("..............................");
+        DBGPRINT("\tActual time = [", SIMUL.getTime(), "]. EMRTK::", __func__,
+                 "(). ", t->toString(), " has just finished on ",
+                 p->toString());
 
         _sched->extract(t);
         // todo delete std::cout
         string state = _sched->toString();
         if (state == "")
-            std::cout << "\t(External scheduler is empty)" << std::endl;
+            DBGPRINT("\t(External scheduler is empty)");
         else
-            std::cout << "\tState of external scheduler: " << std::endl
-                      << "\t\t" << state << std::endl;
+            DBGPRINT("\tState of external scheduler: \n\t\t", state);
 
-        _m_oldExe[t] = p;
-        _m_currExe.erase(p);
-        _m_dispatched.erase(t);
+        setOldProcessor(t, p);
+        setExecuting(p, NULL);
+        setDispatched(t, NULL);
         _queues->onEnd(t, p);
 
         // // FIXME: the busy status is now an invariant
         // if (_queues->isEmpty(p) && getRunningTask(p) == NULL)
         //     p->setBusy(false);
 
-        std::cout << "\tState before migration (migrations after end="
-                  << EMRTK_CBS_MIGRATE_AFTER_END
-                  << ", Temporarily migrate after end="
-                  << EMRTK_TEMPORARILY_MIGRATE_END
-                  << ", core is busy=" << p->busy() << "):" << std::endl;
-        printState(true);
+        DBGPRINT("\tState before migration (migrations after end=",
+                 EMRTK_CBS_MIGRATE_AFTER_END,
+                 ", Temporarily migrate after end=",
+                 EMRTK_TEMPORARILY_MIGRATE_END, ", core is busy=", p->busy(),
+                 "):");
+        if (DBGENABLED())
+            printState(true);
 
         if (!p->busy() && EMRTK_CBS_MIGRATE_AFTER_END) {
-            std::cout << "\tTrying to migrate into core" << std::endl;
+            DBGPRINT("\tTrying to migrate into core");
             if (!migrateInto(p) && EMRTK_TEMPORARILY_MIGRATE_END) {
-                std::cout
-                    << "\tFailed to migrate into core, trying to temporarily "
-                       "migrate into core"
-                    << std::endl;
+                DBGPRINT("\tFailed to migrate into core, trying to "
+                         "temporarily migrate into core");
                 bool res = migrateTemporarily(p);
-                std::cout << "\tTemporary migration into core "
-                          << (res ? "succeeded" : "failed") << std::endl;
+                DBGPRINT("\tTemporary migration into core ",
+                         (res ? "succeeded" : "failed"));
             }
         } else { // core has already some ready tasks
-            std::cout << "\tcore busy, schedule ready task" << std::endl;
+            DBGPRINT("\tcore busy, schedule ready task");
             _queues->schedule(p);
         }
 
         if (!p->getIsland()->busy()) {
-            std::cout << "\t" << p->getIsland()->getName()
-                      << "'s got free => clock down to min speed" << std::endl;
+            DBGPRINT("\t", p->getIsland()->getName(),
+                     "'s got free => clock down to min speed");
             p->getIsland()->setOPP(0);
         }
 
         if (_queues->isEmpty(p)) {
-            std::cout << "\t" << p->getName() << " is empty -> wl idle"
-                      << std::endl;
-            p->setWorkload("idle");
+            DBGPRINT("\t", p->getName(), " is empty -> wl idle");
+            p->setWorkload(WorkloadId::IDLE);
         }
-        std::cout << "\tState after migration:" << std::endl;
-        printState(true);
+        DBGPRINT("\tState after migration:");
+        if (DBGENABLED())
+            printState(true);
     }
 
     bool EnergyMRTKernel::migrateInto(CPU_BL *endingCPU,
                                       vector<AbsRTTask *> toBeSkipped) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         /**
            Migration mechanism: a task finishes on CPU c, leaving it idle.
            If c is a little, try moving ready tasks originally assigned to
@@ -582,35 +565,31 @@ namespace RTSim {
            Try not to touch running tasks.
         */
         if (!EMRTK_MIGRATE_ENABLED) {
-            std::cout << "Migration policy disabled => skip" << std::endl;
+            DBGPRINT("Migration policy disabled => skip");
             return false;
         }
         if (getReadyTasks(endingCPU).size() != 0) {
-            std::cout << endingCPU->getName()
-                      << " already has some ready task => skip migration"
-                      << std::endl;
+            DBGPRINT(endingCPU->getName(),
+                     " already has some ready task => skip migration");
             return false;
         }
         if (getRunningTask(endingCPU) != NULL) {
             assert(EMRTK_CBS_ENVELOPING_PER_TASK_ENABLED &&
                    EMRTK_CBS_ENVELOPING_MIGRATE_AFTER_VTIME_END);
-            std::cout << endingCPU->getName()
-                      << " already has a running task => skip migration"
-                      << std::endl;
+            DBGPRINT(endingCPU->getName(),
+                     " already has a running task => skip migration");
             return false;
         }
-        std::cout << "\t" << __func__ << "() time=" << SIMUL.getTime()
-                  << std::endl;
+        DBGPRINT("\t", __func__, "() time=", SIMUL.getTime());
 
         MigrationProposal migrationProposal =
             getTaskToMigrateInto(endingCPU, toBeSkipped);
 
         if (migrationProposal.task == NULL)
-            std::cout << "\t\tEMRTK::" << __func__ << "(). No migration done"
-                      << std::endl;
+            DBGPRINT("\t\tEMRTK::", __func__, "(). No migration done");
         else {
             migrationProposal.to->setWorkload(
-                Utils::getTaskWorkload(migrationProposal.task));
+                Utils::getTaskWorkloadId(migrationProposal.task));
 
             // make task run on ending core.
             // onEndDispatchMulti will take care of increasing core OPP
@@ -626,7 +605,7 @@ namespace RTSim {
         EnergyMRTKernel::getTaskToMigrateInto(CPU_BL *endingCPU,
                                               vector<AbsRTTask *> toBeSkipped) {
         assert(endingCPU != NULL);
-        std::cout << "\tEMRTK::" << __func__ << "()" << std::endl;
+        DBGPRINT("\tEMRTK::", __func__, "()");
 
         MigrationProposal migrationProposal =
             migrateFromBig(endingCPU, toBeSkipped);
@@ -661,13 +640,11 @@ namespace RTSim {
                     setTryingTaskOnCPU_BL(false);
                     if (!iDeltaPows.empty() &&
                         !Utils::exists(tt, toBeSkipped)) {
-                        std::cout
-                            << "\t\tMigration proposal of " << tt->toString()
-                            << " from " << c->toString() << " to "
-                            << iDeltaPows.at(0).cpu->toString()
-                            << " with frequency "
-                            << endingCPU->getFrequency(iDeltaPows.at(0).opp)
-                            << std::endl;
+                        DBGPRINT("\t\tMigration proposal of ", tt->toString(),
+                                 " from ", c->toString(), " to ",
+                                 iDeltaPows.at(0).cpu->toString(),
+                                 " with frequency ",
+                                 endingCPU->getFrequency(iDeltaPows.at(0).opp));
                         migrationProposal.task = tt;
                         migrationProposal.from = c;
                         migrationProposal.to = endingCPU;
@@ -675,10 +652,8 @@ namespace RTSim {
                     }
                 }
             }
-            std::cout
-                << "\t\tNo migration from big island to endingCPU => balance "
-                   "little island load"
-                << std::endl;
+            DBGPRINT("\t\tNo migration from big island to endingCPU => "
+                     "balance little island load");
         }
 
     endFun:
@@ -688,9 +663,8 @@ namespace RTSim {
     EnergyMRTKernel::MigrationProposal
         EnergyMRTKernel::balanceLoad(CPU_BL *endingCPU,
                                      vector<AbsRTTask *> toBeSkipped) {
-        std::cout << "\t\tEMRTK::" << __func__
-                  << "(). Balancing load of island: " << endingCPU->getName()
-                  << std::endl;
+        DBGPRINT("\t\tEMRTK::", __func__, "(). Balancing load of island: ",
+                 endingCPU->getName());
         MigrationProposal migrationProposal = {.task = NULL,
                                                .from = NULL,
                                                .to = NULL};
@@ -704,10 +678,9 @@ namespace RTSim {
             if (nTasksOnCore > 1 &&
                 !Utils::exists(readyTasks.at(0), toBeSkipped)) {
                 AbsRTTask *tt = readyTasks.at(0);
-                std::cout << "\t\tMigration proposal of " << tt->toString()
-                          << " from " << c->toString() << " to "
-                          << endingCPU->toString() << " with same frequency "
-                          << std::endl;
+                DBGPRINT("\t\tMigration proposal of ", tt->toString(), " from ",
+                         c->toString(), " to ", endingCPU->toString(),
+                         " with same frequency ");
                 migrationProposal.task = tt;
                 migrationProposal.from = c;
                 migrationProposal.to = endingCPU;
@@ -719,9 +692,9 @@ namespace RTSim {
     }
 
     void EnergyMRTKernel::onRound(AbsRTTask *finishingTask) {
-        std::cout << "t = " << SIMUL.getTime() << " " << __func__
-                  << " for finishingTask = " << taskname(finishingTask)
-                  << std::endl;
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+        DBGPRINT("t = ", SIMUL.getTime(), " ", __func__,
+                 " for finishingTask = ", taskname(finishingTask));
         finishingTask->deschedule();
         _queues->onRound(finishingTask, getProcessor(finishingTask));
     }
@@ -739,8 +712,9 @@ namespace RTSim {
     // cores for tasks
 
     void EnergyMRTKernel::leaveLittle3(
-        AbsRTTask *t, vector<struct ConsumptionTable> iDeltaPows,
+        AbsRTTask *t, const vector<struct ConsumptionTable> &iDeltaPows,
         CPU_BL *&chosenCPU) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         /**
          * Policy of leaving a little core free for big-WCET tasks, which
          * otherwise would be scheduled on big cores, thus increasing power
@@ -749,15 +723,14 @@ namespace RTSim {
          * Otherwise (if it only fits on little 3 and in bigs, choose little 3).
          */
 
-        std::cout << __func__ << "():" << std::endl;
+        DBGPRINT(__func__, "():");
         if (!EMRTK_LEAVE_LITTLE3_ENABLED) {
-            std::cout << "\tPolicy deactivated. Skip" << std::endl;
+            DBGPRINT("\tPolicy deactivated. Skip");
             return;
         }
         if (chosenCPU->getName().find("LITTLE_3") == string::npos ||
             chosenCPU->getIsland()->type() == IslandType::BIG) {
-            std::cout << "chosenCPU in big island or is not little_3 => skip"
-                      << std::endl;
+            DBGPRINT("chosenCPU in big island or is not little_3 => skip");
             return;
         }
 
@@ -767,76 +740,68 @@ namespace RTSim {
 
         bool fitsInOtherCore = true; // if it only fits on little 3 and in bigs
 
-        for (int i = 0; i < iDeltaPows.size(); i++) {
-            std::cout << iDeltaPows[i].cons << " "
-                      << iDeltaPows[i].cpu->toString() << std::endl;
-            if (iDeltaPows[i].cpu->getIsland()->type() == IslandType::LITTLE &&
-                iDeltaPows[i].cpu->getName().find("LITTLE_3") == string::npos) {
-                chosenCPU = iDeltaPows[i].cpu;
-                chosenCPU->setOPP(iDeltaPows[i].opp);
-                std::cout << "Changing to " << iDeltaPows[i].cpu->toString()
-                          << " - chosenCPU=" << chosenCPU->toString()
-                          << std::endl;
-                fitsInOtherCore = false;
-                break;
-            }
+        // Cheapest little core other than little 3
+        auto other = getCheapest(iDeltaPows, [](const ConsumptionTable &e) {
+            return e.cpu->getIsland()->type() == IslandType::LITTLE &&
+                   e.cpu->getName().find("LITTLE_3") == string::npos;
+        });
+        if (other != iDeltaPows.cend()) {
+            chosenCPU = other->cpu;
+            chosenCPU->setOPP(other->opp);
+            DBGPRINT("Changing to ", other->cpu->toString(), " - chosenCPU=",
+                     chosenCPU->toString());
+            fitsInOtherCore = false;
         }
 
         if (fitsInOtherCore) {
-            std::cout << "Task only fits on little 3 and in bigs => stay in "
-                         "LITTLE_3, CPU not changed"
-                      << std::endl;
+            DBGPRINT("Task only fits on little 3 and in bigs => stay in "
+                     "LITTLE_3, CPU not changed");
         }
     }
 
     void EnergyMRTKernel::balanceLoadEnergy(
         CPU_BL **chosenCPU, unsigned int &chosenOPP, bool &chosenCPUchanged,
-        vector<struct ConsumptionTable> iDeltaPows) {
+        const vector<struct ConsumptionTable> &iDeltaPows) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         // Load balancing policy: don't put all the load on a core of an island,
         // but use also the others. Mechanism: if chosen CPU is busy, find a
         // free CPU in the island with the same consumption. Note: with this
         // algorithm tasks cannot be assigned to a core in an island different
         // than the originally chosen one
-        std::cout << __func__ << ":" << std::endl;
+        DBGPRINT(__func__, ":");
         if ((*chosenCPU)->busy()) {
-            std::cout << (*chosenCPU)->toString() << " was chosen but it's busy"
-                      << std::endl;
-            for (int i = 1; i < iDeltaPows.size(); i++) {
-                std::cout << iDeltaPows[i].cons << " VS " << iDeltaPows[0].cons
-                          << " busy? " << iDeltaPows[i].cpu->busy() << " "
-                          << iDeltaPows[i].cpu->toString() << std::endl;
-                if (iDeltaPows[i].cons == iDeltaPows[0].cons &&
-                    !iDeltaPows[i].cpu->busy()) {
-                    *chosenCPU = iDeltaPows[i].cpu;
-                    chosenOPP = iDeltaPows[i].opp;
+            DBGPRINT((*chosenCPU)->toString(), " was chosen but it's busy");
+            // The chosen CPU is one of the cheapest, look for another one
+            // with the same consumption
+            double minCons = getCheapest(iDeltaPows)->cons;
+            for (const ConsumptionTable &e : iDeltaPows) {
+                if (e.cons != minCons)
+                    continue;
+                DBGPRINT(e.cons, " VS ", minCons, " busy? ", e.cpu->busy(), " ",
+                         e.cpu->toString());
+                if (!e.cpu->busy()) {
+                    *chosenCPU = e.cpu;
+                    chosenOPP = e.opp;
                     chosenCPUchanged = true;
                     break;
                 }
             }
         } else
-            std::cout << "\tCPU is not busy => skip" << std::endl;
+            DBGPRINT("\tCPU is not busy => skip");
     }
 
     void EnergyMRTKernel::chooseCPU_BL(
-        AbsRTTask *t, vector<struct ConsumptionTable> iDeltaPows) {
-        // TODO: switch from nlogn to n for min()
-        // sort table of consumption
-        sort(iDeltaPows.begin(), iDeltaPows.end(),
-             [](struct ConsumptionTable const &e1,
-                struct ConsumptionTable const &e2) {
-                 return e1.cons < e2.cons;
-             });
-
+        AbsRTTask *t, const vector<struct ConsumptionTable> &iDeltaPows) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         // todo delete after debug
-        std::cout << "EMRTK::" << __func__ << "()" << std::endl;
+        DBGPRINT("EMRTK::", __func__, "()");
         for (auto elem : iDeltaPows) {
-            std::cout << elem.cons << " " << elem.cpu->toString()
-                      << " with new opp " << elem.cpu->getFrequency(elem.opp)
-                      << std::endl;
+            DBGPRINT(elem.cons, " ", elem.cpu->toString(), " with new opp ",
+                     elem.cpu->getFrequency(elem.opp));
             assert(elem.cpu->getOPPIndex() <= elem.opp);
         }
 
-        struct ConsumptionTable chosen = iDeltaPows[0];
+        struct ConsumptionTable chosen = *getCheapest(iDeltaPows);
         CPU_BL *chosenCPU = chosen.cpu;
         unsigned int chosenOPP = chosen.opp;
         bool chosenCPUchanged = false;
@@ -844,27 +809,24 @@ namespace RTSim {
 
         balanceLoadEnergy(&chosenCPU, chosenOPP, chosenCPUchanged, iDeltaPows);
 
-        std::cout << "Temporarily chosenCPU: " << chosenCPU->toString()
-                  << " with freq " << chosenCPU->getFrequency(chosenOPP)
-                  << std::endl;
+        DBGPRINT("Temporarily chosenCPU: ", chosenCPU->toString(),
+                 " with freq ", chosenCPU->getFrequency(chosenOPP));
         leaveLittle3(t, iDeltaPows, chosenCPU);
 
         dispatch(chosenCPU, t, chosenOPP);
         setTryingTaskOnCPU_BL(true);
-        std::cout << "time = " << SIMUL.getTime()
-                  << " - going to schedule task " << t->toString() << " in CPU "
-                  << chosenCPU->getName() << " with freq "
-                  << chosenCPU->getFrequency(chosenOPP)
-                  << " speed=" << chosenCPU->getSpeedByOPP(chosenOPP)
-                  << " chosenOPP " << chosenOPP << " - CPU"
-                  << (chosenCPUchanged && toBeChanged ? "" : " not")
-                  << " changed " << std::endl;
+        DBGPRINT("time = ", SIMUL.getTime(), " - going to schedule task ",
+                 t->toString(), " in CPU ", chosenCPU->getName(), " with freq ",
+                 chosenCPU->getFrequency(chosenOPP), " speed=",
+                 chosenCPU->getSpeedByOPP(chosenOPP), " chosenOPP ", chosenOPP,
+                 " - CPU", (chosenCPUchanged && toBeChanged ? "" : " not"),
+                 " changed ");
         setTryingTaskOnCPU_BL(false);
     }
 
     void EnergyMRTKernel::dispatch(CPU *p, AbsRTTask *t, int opp) {
-        std::cout << "EMRTK::" << __func__
-                  << "(p, t, opp) task:" << t->toString() << std::endl;
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+        DBGPRINT("EMRTK::", __func__, "(p, t, opp) task:", t->toString());
         CPU_BL *pp = dynamic_cast<CPU_BL *>(p);
 
         removeTaskTemporarilyMigrated(pp);
@@ -879,7 +841,7 @@ namespace RTSim {
 
     /* Decide a CPU for each ready task */
     void EnergyMRTKernel::dispatch() {
-        DBGENTER(_KERNEL_DBG_LEV);
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         // setTryingTaskOnCPU_BL(true);
 
         int num_newtasks = 0; // # "new" tasks in the ready queue
@@ -888,7 +850,6 @@ namespace RTSim {
         while (_sched->getTaskN(num_newtasks) != NULL)
             num_newtasks++;
 
-        _sched->print();
         DBGPRINT("New tasks: ", num_newtasks);
         print();
         if (num_newtasks == 0)
@@ -900,10 +861,8 @@ namespace RTSim {
             AbsRTTask *t = dynamic_cast<AbsRTTask *>(_sched->getTaskN(i++));
             if (t == NULL)
                 break;
-            std::cout << "Actual time = [" << SIMUL.getTime() << "]"
-                      << std::endl;
-            std::cout << "Dealing with task " << t->toString() << "."
-                      << std::endl;
+            DBGPRINT("Actual time = [", SIMUL.getTime(), "]");
+            DBGPRINT("Dealing with task ", t->toString(), ".");
 
             // for testing
             if (manageForcedDispatch(t) || manageDiscartedTask(t)) {
@@ -915,28 +874,23 @@ namespace RTSim {
                 // dispatch() is called even before onEndMultiDispatch()
                 // finishes and thus tasks seem not to be dispatching (i.e.,
                 // assigned to a processor)
-                std::cout
-                    << "\tTask has already been dispatched, but dispatching "
-                       "is not complete => skip (you\'ll still see "
-                       "desched&sched evt, to trace tasks)"
-                    << std::endl;
+                DBGPRINT("\tTask has already been dispatched, but dispatching "
+                         "is not complete => skip (you\'ll still see "
+                         "desched&sched evt, to trace tasks)");
                 continue;
             }
 
             if (getProcessor(t) !=
                 NULL) { // e.g., task ends => migrateInto() => dispatch()
-                std::cout << "\tTask is running on a CPU already => skip"
-                          << std::endl;
+                DBGPRINT("\tTask is running on a CPU already => skip");
                 continue;
             }
 
             // otherwise scale up CPUs frequency
             DBGPRINT("Trying to scale up CPUs");
-            std::cout << std::endl << "Trying to scale up CPUs" << std::endl;
             vector<struct ConsumptionTable> iDeltaPows;
-            std::cout << std::endl
-                      << "\t------------\n\tCurrent situation:\n\t"
-                      << _queues->toString() << "\t------------" << std::endl;
+            DBGPRINT("\t------------\n\tCurrent situation:\n\t",
+                     _queues->toString(), "\t------------");
 
             setTryingTaskOnCPU_BL(true);
             for (CPU_BL *c : cpus)
@@ -946,14 +900,13 @@ namespace RTSim {
             if (!iDeltaPows.empty())
                 chooseCPU_BL(t, iDeltaPows);
             else
-                std::cout << "Cannot schedule " << t->toString() << " anywhere"
-                          << std::endl;
+                DBGPRINT("Cannot schedule ", t->toString(), " anywhere");
 
             _sched->extract(t);
             num_newtasks--;
 
-            std::cout << "Decisions 'til now:" << std::endl;
-            std::cout << _queues->toString() << std::endl;
+            DBGPRINT("Decisions 'til now:");
+            DBGPRINT(_queues->toString());
 
             // if you get here, task is not schedulable in real-time
         } while (num_newtasks > 0);
@@ -966,128 +919,123 @@ namespace RTSim {
 
     void EnergyMRTKernel::tryTaskOnCPU_BL(
         AbsRTTask *t, CPU_BL *c, vector<struct ConsumptionTable> &iDeltaPows) {
+        DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
         if (c->disabled())
             return;
         int startingOPP = c->getOPPIndex();
         double frequency = c->getFrequency();
-        string startingWL = c->getWorkload();
-        c->setWorkload(Utils::getTaskWorkload(t));
-
-        std::cout << "\tTrying to schedule on CPU " << c->toString()
-                  << " using freq " << frequency
-                  << " - it has already ntasks=" << getReadyTasks(c).size()
-                  << std::endl;
-
-        // for (int ooo = c->getIslandCurOPP(); ooo < c->getOPPs().size();
-        // ooo++) {
-        for (OPP tryOPP : c->getHigherOPPs()) {
-            int ooo = c->getIsland()->getOPPIndexByOPP(tryOPP);
+        WorkloadId startingWL = c->getWorkloadId();
+        c->setWorkload(Utils::getTaskWorkloadId(t));
+        const Island_BL::OPPTable &table =
+            c->getIsland()->getOPPTable(c->getWorkloadId());
+
+        DBGPRINT("\tTrying to schedule on CPU ", c->toString(), " using freq ",
+                 frequency, " - it has already ntasks=",
+                 getReadyTasks(c).size());
+
+        // Utilization of the ready tasks of c plus t, at unit speed (the
+        // same test as Scheduler::isAdmissible()). The OPPs below the
+        // first one where t is admissible are skipped altogether.
+        const UtilizationTracker &tracker = _queues->getUtilizationTracker();
+        double demand =
+            tracker.getUtilization(c) + tracker.getTaskUtilization(t);
+        AbsRTTask *running = getRunningTask(c);
+        if (running != NULL && tracker.getProcessor(running) == c)
+            demand -= tracker.getTaskUtilization(running);
+        size_t firstOPP = UtilizationTracker::getMinOPP(
+            c, demand, c->getWorkloadId(), startingOPP);
+
+        for (size_t ooo = firstOPP; ooo < c->getIsland()->getOPPsize();
+             ++ooo) {
             double newFreq = c->getFrequency(ooo);
             double newCapacity = 0.0;
 
             c->setOPP(ooo);
-            newCapacity = c->getSpeed(newFreq);
-            printf("\t\tUsing frequency %d instead of %d (cap. %f)\n",
-                   (int) newFreq, (int) frequency, newCapacity);
-
-            // check whether task is admissible with the new frequency and where
-            if (_sched->isAdmissible(c, getReadyTasks(c), t)) {
-                std::cout << "\t\t\tHere task would be admissible" << std::endl;
-
-                double utilization =
-                    0.0; // utilization on the CPU c (without new task)
-                double utilization_t =
-                    0.0; // utilization of the considered new task
-                double newUtilizationIsland =
-                    0.0; // utilization of tasks in the island with new freq -
-                         // cores share frequency
-                double oldUtilizationIsland = 0.0;
-                double iPowWithNewTask = 0.0;
-                double iOldPow = 0.0;
-                double iDeltaPow = 0.0; // additional power to schedule t on CPU
-                                        // c on the whole island (big/little)
-                int nTaskIsland = 0;
-                IslandType island;
-
-                // utilization on CPU c with the new frequency
-                utilization = getUtilization(c, newCapacity);
-
-                if (utilization > 1.0) {
-                    std::cout
-                        << "\t\t\tCPU utilization is already >= 100% => skip "
-                           "OPP"
-                        << std::endl;
-                    continue;
-                } else
-                    std::cout
-                        << "\t\t\tTotal utilization (running+ready+active-new "
-                           "task) tasks already in CPU "
-                        << c->toString() << " = " << utilization << std::endl;
-
-                utilization_t = getUtilization(t, newCapacity);
-                std::cout << "\t\t\tUtilization cur/new task "
-                          << t->toString().substr(0, 25) << "... would be "
-                          << utilization_t << " - CPU capacity=" << newCapacity
-                          << std::endl;
-                std::cout << "\t\t\t\tScaled task WCET "
-                          << t->getRemainingWCET(newCapacity) << " DL "
-                          << t->getPeriod() << std::endl;
-
-                if (utilization + utilization_t > 1.0) {
-                    std::cout << "\t\t\tTotal utilization + cur/new task "
-                                 "utilization would be "
-                              << utilization << "+" << utilization_t << "="
-                              << utilization + utilization_t
-                              << " >= 100% => skip OPP" << std::endl;
-                    continue;
-                }
-                // std::cout << "Final core utilization running+ready+active+new
-                // task = " << utilization + utilization_t << std::endl;
-
-                // Ok, task can be placed on CPU c, compute power delta
-
-                // utilization island where CPU c is
-                island = c->getIsland()->type();
-                newUtilizationIsland =
-                    getIslandUtilization(newCapacity, island, NULL);
-                oldUtilizationIsland = getIslandUtilization(
-                    c->getSpeed(frequency), island, &nTaskIsland);
-                std::cout << "\t\t\tIn the CPU island of " << c->getName()
-                          << ", " << nTaskIsland << " are being scheduled"
-                          << std::endl;
-
-                iPowWithNewTask = (newUtilizationIsland + utilization_t) *
-                                  c->getPower(newFreq);
-                iOldPow = oldUtilizationIsland * c->getPower(frequency);
-
-                // todo remove after debug
-                //
-
-                printf("\t\t\tnew = [(util_isl_newFreq) %f + (util_new_task) "
-                       "%f] * (pow_newFreq) %.17g=%f, old: (util_isl_curFreq) "
-                       "%f * (pow_curFreq) %.17g=%f\n",
-                       newUtilizationIsland, utilization_t,
-                       c->getPower(newFreq), iPowWithNewTask,
-                       oldUtilizationIsland, c->getPower(frequency), iOldPow);
-
-                iDeltaPow = iPowWithNewTask - iOldPow;
-                assert(iPowWithNewTask >= 0.0);
-                assert(iOldPow >= 0.0);
-                std::cout << "\t\t\tiDeltaPow = new-old = " << iDeltaPow
-                          << std::endl;
-                struct ConsumptionTable row = {.cons = iDeltaPow,
-                                               .cpu = c,
-                                               .opp = ooo};
-                iDeltaPows.push_back(row);
-
-                // break; (i.e. skip foreach OPP) xk è ovvio che aumentando la
-                // freq della stessa CPU, t è ammissibile
-            } else {
-                std::cout
-                    << "\t\t\tHere task wouldn't be admissible (U + U_newTask "
-                       "> 1)"
-                    << std::endl;
+            newCapacity = table.speed[ooo];
+            DBGPRINT("\t\tUsing frequency ", (int) newFreq, " instead of ",
+                     (int) frequency, " (cap. ", newCapacity, ")");
+
+            DBGPRINT("\t\t\tHere task would be admissible");
+
+            double utilization =
+                0.0; // utilization on the CPU c (without new task)
+            double utilization_t =
+                0.0; // utilization of the considered new task
+            double newUtilizationIsland =
+                0.0; // utilization of tasks in the island with new freq -
+                     // cores share frequency
+            double oldUtilizationIsland = 0.0;
+            double iPowWithNewTask = 0.0;
+            double iOldPow = 0.0;
+            double iDeltaPow = 0.0; // additional power to schedule t on CPU
+                                    // c on the whole island (big/little)
+            int nTaskIsland = 0;
+            IslandType island;
+
+            // utilization on CPU c with the new frequency
+            utilization = getUtilization(c, newCapacity);
+
+            if (utilization > 1.0) {
+                DBGPRINT("\t\t\tCPU utilization is already >= 100% => skip "
+                         "OPP");
+                continue;
+            } else
+                DBGPRINT("\t\t\tTotal utilization (running+ready+active-new "
+                         "task) tasks already in CPU ", c->toString(), " = ",
+                         utilization);
+
+            utilization_t = getUtilization(t, newCapacity);
+            DBGPRINT("\t\t\tUtilization cur/new task ",
+                     t->toString().substr(0, 25), "... would be ",
+                     utilization_t, " - CPU capacity=", newCapacity);
+            DBGPRINT("\t\t\t\tScaled task WCET ",
+                     t->getRemainingWCET(newCapacity), " DL ", t->getPeriod());
+
+            if (utilization + utilization_t > 1.0) {
+                DBGPRINT("\t\t\tTotal utilization + cur/new task utilization "
+                         "would be ", utilization, "+", utilization_t, "=",
+                         utilization + utilization_t, " >= 100% => skip OPP");
+                continue;
             }
+            // std::cout << "Final core utilization running+ready+active+new
+            // task = " << utilization + utilization_t << std::endl;
+
+            // Ok, task can be placed on CPU c, compute power delta
+
+            // utilization island where CPU c is
+            island = c->getIsland()->type();
+            newUtilizationIsland =
+                getIslandUtilization(newCapacity, island, NULL);
+            oldUtilizationIsland = getIslandUtilization(
+                table.speed[startingOPP], island, &nTaskIsland);
+            DBGPRINT("\t\t\tIn the CPU island of ", c->getName(), ", ",
+                     nTaskIsland, " are being scheduled");
+
+            iPowWithNewTask =
+                (newUtilizationIsland + utilization_t) * table.power[ooo];
+            iOldPow = oldUtilizationIsland * table.power[startingOPP];
+
+            // todo remove after debug
+            //
+
+            DBGPRINT("\t\t\tnew = [(util_isl_newFreq) ", newUtilizationIsland,
+                     " + (util_new_task) ", utilization_t, "] * (pow_newFreq) ",
+                     table.power[ooo], "=", iPowWithNewTask,
+                     ", old: (util_isl_curFreq) ", oldUtilizationIsland,
+                     " * (pow_curFreq) ", table.power[startingOPP], "=",
+                     iOldPow);
+
+            iDeltaPow = iPowWithNewTask - iOldPow;
+            assert(iPowWithNewTask >= 0.0);
+            assert(iOldPow >= 0.0);
+            DBGPRINT("\t\t\tiDeltaPow = new-old = ", iDeltaPow);
+            struct ConsumptionTable row = {.cons = iDeltaPow,
+                                           .cpu = c,
+                                           .opp = int(ooo)};
+            iDeltaPows.push_back(row);
+
+            // break; (i.e. skip foreach OPP) xk è ovvio che aumentando la
+            // freq della stessa CPU, t è ammissibile
         }
 
         c->setOPP(startingOPP);
@@ -0,0 +1,153 @@
+#include <metasim/simul.hpp>
+
+// RTSim
+#include <rtsim/cpu.hpp>
+#include <rtsim/energymeter.hpp>
+
+namespace RTSim {
+
+    EnergyMeter::EnergyMeter(const std::string &name) :
+        Entity(name),
+        _start(0) {}
+
+    EnergyMeter::~EnergyMeter() {
+        for (auto &m : _meters)
+            m.cpu->setEnergyMeter(nullptr);
+    }
+
+    void EnergyMeter::attach(CPU *c) {
+        if (_index.count(c))
+            return;
+        if (c->getEnergyMeter() != nullptr)
+            throw Exc("The CPU " + c->getName() +
+                      " is measured by another meter");
+
+        _index[c] = _meters.size();
+        _meters.push_back({c, nullptr, 0, 0, 0});
+        reset(_meters.back());
+        c->setEnergyMeter(this);
+    }
+
+    void EnergyMeter::attach(CPUIsland *island) {
+        for (CPU *c : island->getProcessors())
+            attach(c);
+    }
+
+    void EnergyMeter::detach(CPU *c) {
+        auto it = _index.find(c);
+        if (it == _index.end())
+            return;
+
+        // Keep the vector dense, the last meter takes the removed slot
+        const size_t i = it->second;
+        _index.erase(it);
+        if (i + 1 != _meters.size()) {
+            _meters[i] = _meters.back();
+            _index[_meters[i].cpu] = i;
+        }
+        _meters.pop_back();
+        c->setEnergyMeter(nullptr);
+    }
+
+    const EnergyMeter::Meter &EnergyMeter::find(const CPU *c) const {
+        auto it = _index.find(c);
+        if (it == _index.end())
+            throw Exc("The CPU " + c->getName() + " is not measured");
+        return _meters[it->second];
+    }
+
+    long double EnergyMeter::getEnergy(const Meter &m) const {
+        Tick now = SIMUL.getTime();
+        if (now <= m.last)
+            return m.energy;
+        return m.energy + m.power * double(now - m.last);
+    }
+
+    long double EnergyMeter::getEnergy(const CPU *c) const {
+        return getEnergy(find(c));
+    }
+
+    long double EnergyMeter::getEnergy(const CPUIsland *island) const {
+        long double e = 0;
+        for (const auto &m : _meters)
+            if (m.cpu->getIsland() == island)
+                e += getEnergy(m);
+        return e;
+    }
+
+    long double EnergyMeter::getEnergy() const {
+        long double e = 0;
+        for (const auto &m : _meters)
+            e += getEnergy(m);
+        return e;
+    }
+
+    long double EnergyMeter::getEnergy(const AbsRTTask *task) const {
+        auto it = _tasks.find(task);
+        long double e = it == _tasks.end() ? 0 : it->second;
+
+        // Plus the current interval, if the task is running
+        for (const auto &m : _meters)
+            if (m.task == task)
+                e += getEnergy(m) - m.energy;
+        return e;
+    }
+
+    long double EnergyMeter::average(long double energy) const {
+        Tick now = SIMUL.getTime();
+        if (now <= _start)
+            return 0;
+        return energy / double(now - _start);
+    }
+
+    void EnergyMeter::update(const CPU *c) {
+        auto it = _index.find(c);
+        if (it == _index.end())
+            return;
+
+        Meter &m = _meters[it->second];
+        const AbsRTTask *task = c->getTask();
+        const double power = c->getPower();
+        if (task == m.task && power == m.power)
+            return;
+
+        // At the beginning of a run the CPUs may be reset before the meter,
+        // while the time still refers to the previous run
+        Tick now = SIMUL.getTime();
+        if (now > m.last) {
+            long double e = m.power * double(now - m.last);
+            m.energy += e;
+            if (m.task != nullptr)
+                _tasks[m.task] += e;
+        }
+        m.last = now;
+        m.task = task;
+
+        if (power != m.power) {
+            m.power = power;
+            record(m);
+        }
+    }
+
+    void EnergyMeter::reset(Meter &m) {
+        m.task = m.cpu->getTask();
+        m.power = m.cpu->getPower();
+        m.last = SIMUL.getTime();
+        m.energy = 0;
+        record(m);
+    }
+
+    void EnergyMeter::record(const Meter &m) {
+        if (_trace != nullptr)
+            *_trace << m.last << ' ' << m.cpu->getName() << ' ' << m.power
+                    << '\n';
+    }
+
+    void EnergyMeter::newRun() {
+        _start = SIMUL.getTime();
+        _tasks.clear();
+        for (auto &m : _meters)
+            reset(m);
+    }
+
+} // namespace RTSim
@@ -47,8 +47,10 @@ namespace RTSim {
         actCycles(0),
         lastTime(0),
         executing(false),
+        cpu(nullptr),
         _endEvt(this) {
         DBGTAG(_INSTR_DBG_LEV, "ExecInstr constructor");
+        cost->setStream(getID());
         std::cout << "wl: " << wl << std::endl;
     }
 
@@ -56,17 +58,21 @@ namespace RTSim {
         Instr(other),
         isBegOfInstr(false),
         cost(other.cost->clone()),
+        workload(other.workload),
         execdTime(0),
         currentCost(0),
         actCycles(0),
         lastTime(0),
         executing(false),
+        cpu(nullptr),
         _endEvt(this) {
         DBGTAG(_INSTR_DBG_LEV, "ExecInstr copy constructor");
+        cost->setStream(getID());
     }
 
     ExecInstr::~ExecInstr() {
         DBGTAG(_INSTR_DBG_LEV, "ExecInstr::~ExecInstr() called");
+        releaseCPU();
     }
 
     Instr *ExecInstr::createInstance(const vector<string> &par) {
@@ -92,6 +98,7 @@ namespace RTSim {
     }
 
     void ExecInstr::newRun() {
+        releaseCPU();
         actCycles = lastTime = 0;
         isBegOfInstr = true;
         execdTime = 0;
@@ -100,6 +107,7 @@ namespace RTSim {
 
     void ExecInstr::endRun() {
         _endEvt.drop();
+        releaseCPU();
     }
 
     Tick ExecInstr::getExecTime() const {
@@ -148,7 +156,9 @@ namespace RTSim {
         CPU *p = _father->getCPU();
         if (!dynamic_cast<CPU *>(p))
             throw InstrExc("No CPU!", "ExeInstr::schedule()");
-        p->setWorkload(workload);
+        p->setWorkload(workload, _father);
+        p->setInstr(this);
+        cpu = p;
 
         double currentSpeed = p->getSpeed();
 
@@ -159,11 +169,7 @@ namespace RTSim {
         DBGPRINT(" result ", ((double) currentCost - actCycles) / currentSpeed,
                  " to tick ",
                  ceil(((double) currentCost - actCycles) / currentSpeed));
-        Tick tmp = 0;
-        if (((double) currentCost) > actCycles * currentSpeed)
-            tmp =
-                (Tick) ceil(((double) currentCost - actCycles * currentSpeed) /
-                            currentSpeed);
+        Tick tmp = getRemainingTime(currentSpeed);
         assert(tmp >= 0);
         _endEvt.post(t + tmp);
 
@@ -178,13 +184,14 @@ namespace RTSim {
         DBGPRINT("Descheduling ExecInstr named: ", getName());
 
         _endEvt.drop();
+        releaseCPU();
 
         if (executing) {
             CPU *p = _father->getOldCPU();
             if (!dynamic_cast<CPU *>(p))
                 throw InstrExc("No CPU!", "ExeInstr::deschedule()");
 
-            p->setWorkload("idle");
+            p->setWorkload(WorkloadId::IDLE);
 
             double currentSpeed = p->getSpeed();
 
@@ -212,6 +219,7 @@ namespace RTSim {
         lastTime = t;
         actCycles = 0;
         _endEvt.drop();
+        releaseCPU();
 
         DBGPRINT("internal data set... now calling the _father->onInstrEnd()");
 
@@ -225,32 +233,45 @@ namespace RTSim {
         isBegOfInstr = true;
         execdTime = 0;
         _endEvt.drop();
+        releaseCPU();
 
         DBGPRINT("internal data reset...");
     }
 
     void ExecInstr::refreshExec(double oldSpeed, double newSpeed) {
+        DBGENTER(_INSTR_DBG_LEV);
+
+        if (!executing)
+            return;
+
         Tick t = SIMUL.getTime();
-        _endEvt.drop();
         actCycles += ((double) (t - lastTime)) * oldSpeed;
         execdTime += (t - lastTime);
         lastTime = t;
 
-        // if (isBegOfInstr)
-        //    currentCost = getDuration();
+        Tick tmp = getRemainingTime(newSpeed);
+        assert(tmp >= 0);
 
-        Tick tmp = 0;
-        if (((double) currentCost) > actCycles)
-            tmp = (Tick) ceil((double(currentCost) - actCycles) / newSpeed);
-        // tmp = (Tick) ceil (double(currentCost - execdTime) / newSpeed);
-        // cost->setMaximum(double(currentCost - execdTime));
+        DBGPRINT("Moving endEvt for ", _father->toString(), " at t=", t + tmp);
 
-        assert(tmp >= 0);
-        printf("endEvt at %f + [%f-%f]/%f=%f\n", double(t),
-               (double) currentCost, (double) actCycles, newSpeed,
-               (double) tmp);
-        //_endEvt.post(t + tmp);
-        _endEvt.post(t + Tick(double(currentCost) / newSpeed));
+        if (_endEvt.isInQueue() && _endEvt.getTime() == t + tmp)
+            return;
+
+        _endEvt.drop();
+        _endEvt.post(t + tmp);
+    }
+
+    Tick ExecInstr::getRemainingTime(double speed) const {
+        // actCycles is in cycles, so it is compared with the cost as it is
+        if (((double) currentCost) <= actCycles)
+            return 0;
+        return (Tick) ceil(((double) currentCost - actCycles) / speed);
+    }
+
+    void ExecInstr::releaseCPU() {
+        if (cpu != nullptr && cpu->getInstr() == this)
+            cpu->setInstr(nullptr);
+        cpu = nullptr;
     }
 
     /*---------------------------- */
@@ -0,0 +1,142 @@
+#include <algorithm>
+
+// RTSim
+#include <rtsim/fpanalysis.hpp>
+
+namespace RTSim {
+
+    size_t FPAnalysis::addLevel(Tick wcet, Tick period, Tick dline) {
+        if (period <= 0)
+            throw Exc("The period must be positive");
+        if (wcet < 0)
+            throw Exc("The WCET must not be negative");
+        if (dline <= 0)
+            dline = period;
+
+        _levels.push_back({impl_t(wcet), impl_t(period), impl_t(dline), 0});
+        _points.emplace_back();
+        return _levels.size() - 1;
+    }
+
+    void FPAnalysis::clear() {
+        _levels.clear();
+        _points.clear();
+    }
+
+    void FPAnalysis::setWCET(size_t i, Tick wcet) {
+        if (wcet < 0)
+            throw Exc("The WCET must not be negative");
+
+        Level &l = _levels.at(i);
+        if (impl_t(wcet) < l.wcet) {
+            // The iterates may now exceed the response times
+            for (size_t j = i; j < _levels.size(); ++j)
+                _levels[j].bound = 0;
+        }
+        l.wcet = wcet;
+    }
+
+    FPAnalysis::impl_t FPAnalysis::iterate(size_t i, impl_t r, size_t k,
+                                           impl_t ck) const {
+        const impl_t own = i == k ? ck : _levels[i].wcet;
+        const impl_t dline = _levels[i].dline;
+
+        // Any value not greater than the response time works as a start,
+        // the WCET of the level itself is the classical one
+        r = std::max(r, own);
+        for (;;) {
+            impl_t next = own;
+            for (size_t j = 0; j < i; ++j) {
+                const Level &l = _levels[j];
+                next += (r + l.period - 1) / l.period * (j == k ? ck : l.wcet);
+            }
+            if (next <= r || next > dline)
+                return next;
+            r = next;
+        }
+    }
+
+    Tick FPAnalysis::getResponseTime(size_t i) {
+        Level &l = _levels.at(i);
+        l.bound = iterate(i, l.bound, i, l.wcet);
+        return l.bound;
+    }
+
+    bool FPAnalysis::probe(size_t i, impl_t c,
+                           std::vector<impl_t> &start) const {
+        for (size_t j = i; j < _levels.size(); ++j) {
+            start[j] = iterate(j, start[j], i, c);
+            if (start[j] > _levels[j].dline)
+                return false;
+        }
+        return true;
+    }
+
+    bool FPAnalysis::tryWCET(size_t i, Tick wcet) {
+        const Level &l = _levels.at(i);
+
+        // The cached iterates are lower bounds only if the WCET does not
+        // decrease
+        _probe.resize(_levels.size());
+        for (size_t j = i; j < _levels.size(); ++j)
+            _probe[j] = impl_t(wcet) >= l.wcet ? _levels[j].bound : 0;
+        return probe(i, wcet, _probe);
+    }
+
+    Tick FPAnalysis::getMaxWCET(size_t i, Tick max) {
+        impl_t lo = _levels.at(i).wcet;
+        impl_t hi = max;
+        bool hiTested = false;
+
+        // Each probe starts from the response times of the largest
+        // feasible WCET found so far, which are lower bounds for any
+        // larger WCET
+        _best.resize(_levels.size());
+        _probe.resize(_levels.size());
+        for (size_t j = i; j < _levels.size(); ++j)
+            _best[j] = _levels[j].bound;
+
+        while (hi - lo > 1) {
+            impl_t mid = (lo + hi) / 2;
+            std::copy(_best.begin() + i, _best.end(), _probe.begin() + i);
+            if (probe(i, mid, _probe)) {
+                lo = mid;
+                _best.swap(_probe);
+            } else {
+                hi = mid;
+                hiTested = true;
+            }
+        }
+
+        if (hi == lo + 1 && !hiTested) {
+            std::copy(_best.begin() + i, _best.end(), _probe.begin() + i);
+            if (probe(i, hi, _probe))
+                lo = hi;
+        }
+        return lo;
+    }
+
+    const std::vector<Tick> &FPAnalysis::getSchedPoints(size_t i) {
+        std::vector<Tick> &points = _points.at(i);
+        if (!points.empty())
+            return points;
+
+        // Starting from the deadline, each higher priority level adds the
+        // last multiple of its period before each point found so far
+        points.push_back(_levels[i].dline);
+        for (size_t j = i; j-- > 0;) {
+            const impl_t p = _levels[j].period;
+            const size_t n = points.size();
+            for (size_t h = 0; h < n; ++h) {
+                impl_t t = impl_t(points[h]) / p * p;
+                if (t > 0)
+                    points.push_back(t);
+            }
+        }
+
+        std::sort(points.begin(), points.end());
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+        return points;
+    }
+
+} // namespace RTSim
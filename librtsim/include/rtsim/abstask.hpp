@@ -14,6 +14,10 @@
 #ifndef __ABSTASK_HPP__
 #define __ABSTASK_HPP__
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include <metasim/basetype.hpp>
 // #include <rtsim/cpu.hpp>
 
@@ -24,6 +28,8 @@ namespace RTSim {
     using std::string;
 
     class AbsKernel;
+    class Scheduler;
+    class TaskModel;
 
     /**
        \ingroup task
@@ -138,6 +144,15 @@ namespace RTSim {
         void setTrace(Trace *tr) {
             tr->attachToTask(*this);
         }
+
+    private:
+        /// Handles to the models of this task in the schedulers it
+        /// belongs to, by scheduler id (see Scheduler::find()). A
+        /// task belongs to few schedulers (usually one), so they
+        /// are kept in a small vector.
+        std::vector<std::pair<uint64_t, TaskModel *>> _schedModels;
+
+        friend class Scheduler;
     };
 
 } // namespace RTSim
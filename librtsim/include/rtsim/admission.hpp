@@ -0,0 +1,146 @@
+// #pragma once
+
+#ifndef RTSIM_ADMISSION_HPP
+#define RTSIM_ADMISSION_HPP
+
+#include <string>
+#include <unordered_map>
+
+// MetaSim
+#include <metasim/baseexc.hpp>
+
+// RTSim
+#include <rtsim/abstask.hpp>
+#include <rtsim/cpu.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /// \ingroup sched
+    ///
+    /// Keeps the utilization and the density of the tasks assigned to each
+    /// CPU, for admission tests that do not iterate over the tasks.
+    ///
+    /// The sums are kept at unit speed and updated in O(1) each time a task
+    /// is added, removed or migrated; the utilization at speed s is obtained
+    /// by dividing them by s. This is exact as long as the WCET of the tasks
+    /// scales with 1/capacity, as Task::getWCET(double) and
+    /// CBServer::getWCET(double) do.
+    ///
+    /// The utilization of a task is WCET/period, its density is WCET/min(D,
+    /// period), where D is its relative deadline. Both are evaluated when
+    /// the task is added, a task whose parameters change must be removed and
+    /// added again.
+    ///
+    /// @code
+    /// UtilizationTracker tracker;
+    /// tracker.addTask(c, t1);
+    /// tracker.addTask(c, t2);
+    /// size_t opp = tracker.getMinOPP(c, t3, c->getWorkloadId());
+    /// if (opp < c->getIsland()->getOPPsize())
+    ///     ; // t3 fits on c at OPP opp and above
+    /// @endcode
+    class UtilizationTracker {
+    public:
+        /// \ingroup sched
+        ///
+        /// Exceptions for the UtilizationTracker class.
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "UtilizationTracker",
+                const std::string md = "admission.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /// Accounts task on c. Throws if the task is already accounted
+        /// or if its period is not positive.
+        void addTask(const CPU *c, const AbsRTTask *task);
+
+        /// Stops accounting task, if it is accounted
+        void removeTask(const AbsRTTask *task);
+
+        /// Moves task to c, keeping the values computed by addTask().
+        /// Throws if the task is not accounted.
+        void migrate(const AbsRTTask *task, const CPU *c);
+
+        /// Stops accounting all the tasks on c
+        void clear(const CPU *c);
+
+        /// Stops accounting all the tasks
+        void clear();
+
+        bool contains(const AbsRTTask *task) const {
+            return _tasks.count(task) > 0;
+        }
+
+        /// @return the CPU where task is accounted, or nullptr
+        const CPU *getProcessor(const AbsRTTask *task) const;
+
+        /// @return the number of tasks accounted on c
+        size_t getNumTasks(const CPU *c) const;
+
+        /// @return the utilization of the tasks on c, at the given speed
+        double getUtilization(const CPU *c, double speed = 1.0) const;
+
+        /// @return the density of the tasks on c, at the given speed
+        double getDensity(const CPU *c, double speed = 1.0) const;
+
+        /// @return the utilization of task at unit speed. The task need
+        /// not be accounted.
+        double getTaskUtilization(const AbsRTTask *task) const;
+
+        /// @return the density of task at unit speed. The task need not
+        /// be accounted.
+        double getTaskDensity(const AbsRTTask *task) const;
+
+        /// Utilization-based EDF test: true if task fits on c at the
+        /// given speed together with the tasks already accounted there.
+        bool isAdmissible(const CPU *c, const AbsRTTask *task,
+                          double speed) const {
+            return getUtilization(c) + getTaskUtilization(task) <= speed;
+        }
+
+        /// Returns the index of the lowest OPP of the island of c, not
+        /// lower than first, whose speed for the given workload is at
+        /// least demand (i.e. a utilization at unit speed). The search
+        /// is a binary search over CPUIsland::getOPPTable(), whose OPPs
+        /// are sorted by frequency, and assumes that the speed does not
+        /// decrease with the frequency.
+        ///
+        /// @return the index or the number of OPPs if none is fast enough
+        static size_t getMinOPP(const CPU *c, double demand,
+                                WorkloadId workload, size_t first = 0);
+
+        /// Returns the lowest OPP of the island of c (not lower than
+        /// first) at which task is admissible on c, see getMinOPP().
+        size_t getMinOPP(const CPU *c, const AbsRTTask *task,
+                         WorkloadId workload, size_t first = 0) const {
+            return getMinOPP(c, getUtilization(c) + getTaskUtilization(task),
+                             workload, first);
+        }
+
+    private:
+        struct Sums {
+            double utilization = 0.0;
+            double density = 0.0;
+            size_t tasks = 0;
+        };
+
+        struct Entry {
+            const CPU *cpu;
+            double utilization;
+            double density;
+        };
+
+        static void account(Sums &s, const Entry &e);
+        static void unaccount(Sums &s, const Entry &e);
+
+        std::unordered_map<const CPU *, Sums> _cpus;
+        std::unordered_map<const AbsRTTask *, Entry> _tasks;
+    };
+
+} // namespace RTSim
+
+#endif // RTSIM_ADMISSION_HPP
@@ -4,12 +4,14 @@
 #define __RTSIM_CPUISLAND_HPP__
 
 #include <metasim/entity.hpp>
+#include <rtsim/energymeter.hpp>
 #include <rtsim/opp.hpp>
 #include <rtsim/powermodel.hpp>
 #include <rtsim/system_descriptor.hpp>
 
 #include <cassert>
 #include <set>
+#include <vector>
 
 // FOR NOW, I WILL ASSUME THAT THE LIFETIME OF ISLANDS AND CPUS ARE NOT RELATED
 // Nonetheless, associations between CPUs and CPUIslands are maintained
@@ -41,6 +43,7 @@ namespace RTSim {
     using namespace MetaSim;
 
     class CPU;
+    class Instr;
     class RTKernel;
 
     // =========================================================================
@@ -172,8 +175,13 @@ namespace RTSim {
             _cpus(),
             _opps(opps),
             _powermodel(powermodel ? powermodel
-                                   : createMinimalPowerModel(_opps)),
+                                   : createMinimalPowerModel(opps)),
             _current_opp(opps.size() ? opps.size() - 1 : 0) {
+            // The values of the model are cached from now on
+            if (_powermodel)
+                _powermodel->freeze();
+            compileModel();
+
             // Additional operations needed
             for (auto cpu : cpus) {
                 addCPU(cpu);
@@ -333,6 +341,45 @@ namespace RTSim {
             return _powermodel;
         }
 
+        /// @return the power of the whole island at the given OPP when
+        /// one of its CPUs runs the given workload, as given by
+        /// CPUModel::lookupPower() but read from the tables of the island,
+        /// see compileModel()
+        watt_type lookupPower(size_t opp_index, WorkloadId workload) const {
+            assert(opp_index < getOPPsize());
+            if (workload.index() >= _compiled)
+                compileModel();
+            return _power_table[workload.index() * _opps.size() + opp_index];
+        }
+
+        /// @return the speed at the given OPP of the given workload, as
+        /// given by CPUModel::lookupSpeed() but read from the tables of the
+        /// island, see compileModel()
+        speed_type lookupSpeed(size_t opp_index, WorkloadId workload) const {
+            assert(opp_index < getOPPsize());
+            if (workload.index() >= _compiled)
+                compileModel();
+            return _speed_table[workload.index() * _opps.size() + opp_index];
+        }
+
+        /// Power consumption and speed of a CPU of this island at
+        /// each OPP (by index) for a given workload. The power is the
+        /// contribution of a single CPU, as in CPU::getPowerByOPP().
+        struct OPPTable {
+            std::vector<watt_type> power;
+            std::vector<speed_type> speed;
+        };
+
+        /// @return the table of the given workload, computed from the
+        /// CPUModel the first time it is requested and then kept until
+        /// the CPUs of the island change. The island must have at least
+        /// one CPU.
+        const OPPTable &getOPPTable(WorkloadId workload) const;
+
+        const OPPTable &getOPPTable(const std::string &workload) const {
+            return getOPPTable(WorkloadId(workload));
+        }
+
         /// @return the power consumption of the whole island
         watt_type getPower() const;
 
@@ -381,9 +428,19 @@ namespace RTSim {
 
     private:
         /// Updates the power and speed estimations on each
-        /// CPU after a change of OPP in the island.
+        /// CPU after a change of OPP in the island, then re-times the
+        /// instructions running on the CPUs whose speed changed, all in
+        /// a single pass.
         void updateModels();
 
+        /// Evaluates the CPUModel at each OPP for all the workload
+        /// classes interned since the last call, so that the model is not
+        /// evaluated anymore during the simulation. Called when the
+        /// island is built and then whenever a new workload class is
+        /// looked up. The model is frozen when the island is built, so
+        /// the tables never need to be invalidated.
+        void compileModel() const;
+
         // =================================================
         // Data
         // =================================================
@@ -399,6 +456,17 @@ namespace RTSim {
         size_t _current_opp;
 
         size_t _frequency_switches = 0;
+
+        /// Power and speed tables by workload index, see getOPPTable()
+        mutable std::vector<OPPTable> _tables;
+
+        /// Values of the CPUModel, indexed by [workload][opp], see
+        /// compileModel()
+        mutable std::vector<watt_type> _power_table;
+        mutable std::vector<speed_type> _speed_table;
+
+        /// Number of workload classes in the tables above
+        mutable size_t _compiled = 0;
     };
 } // namespace RTSim
 
@@ -453,7 +521,7 @@ namespace RTSim {
         CPU(const std::string &name, CPUIsland *island) :
             Entity(name),
             _index(0),
-            _workload("idle"),
+            _workload(WorkloadId::IDLE),
             _island(nullptr) {
             // This invocation here is deeply problematic,
             // invoke this from outside right after creating
@@ -499,6 +567,9 @@ namespace RTSim {
         DISABLE_MOVE(CPU);
 
         virtual ~CPU() {
+            if (_meter)
+                _meter->detach(this);
+
             // Remove association in associated CPUIsland
             // (otherwise UB may happend when dereferencing
             // link to this CPU)
@@ -550,7 +621,7 @@ namespace RTSim {
         /// @return whether the CPU is busy
         // TODO: do we need a separed setBusy method?
         bool busy() const {
-            return !disabled() && getWorkload() != "idle";
+            return getWorkloadId() != WorkloadId::IDLE;
         }
 
         /// @note forwards to the linked CPUIsland
@@ -588,13 +659,35 @@ namespace RTSim {
             return island->getOPP(opp_index);
         }
 
-        std::string getWorkload() const {
+        /// @returns the workload class currently running on the CPU, idle
+        /// if it is disabled
+        WorkloadId getWorkloadId() const {
             // TODO: check if this is ok
-            if (disabled() || _workload.length() < 1)
-                return "idle";
+            if (disabled())
+                return WorkloadId::IDLE;
             return _workload;
         }
 
+        const std::string &getWorkload() const {
+            return getWorkloadId().getName();
+        }
+
+        /// @returns the task whose workload is running on the CPU, if it
+        /// was given to setWorkload()
+        const AbsRTTask *getTask() const {
+            return _task;
+        }
+
+        /// @returns the instruction executing on the CPU, if any
+        Instr *getInstr() const {
+            return _instr;
+        }
+
+        /// @returns the meter measuring the energy of this CPU, if any
+        EnergyMeter *getEnergyMeter() const {
+            return _meter;
+        }
+
         /// @note forwards to the linked CPUIsland
         freq_type getFrequency(size_t opp_index) const {
             auto island = getIsland();
@@ -681,12 +774,11 @@ namespace RTSim {
         // ---------- Templated Methods to avoid code repetitions ----------- //
     private:
         template <class retT>
-        using cpumodel_method = retT (CPUModel::*)(const OPP &,
-                                                   const std::string &) const;
+        using lookup_method = retT (CPUIsland::*)(size_t, WorkloadId) const;
 
         template <class retT>
-        retT getValueByOPP(cpumodel_method<retT> lookup, size_t opp_index,
-                           const std::string &workload) const {
+        retT getValueByOPP(lookup_method<retT> lookup, size_t opp_index,
+                           WorkloadId workload) const {
             auto island = getIsland();
             if (!island)
                 return 0;
@@ -694,27 +786,29 @@ namespace RTSim {
             if (opp_index == island->getOPPsize())
                 return 0;
 
-            auto powermodel = island->getCPUModel();
-            if (!powermodel)
+            if (!island->getCPUModel())
                 return 0;
 
-            return (powermodel->*lookup)(island->getOPP(opp_index), workload);
+            return (island->*lookup)(opp_index, workload);
         }
 
         // ------------------------- Speed Getters -------------------------- //
     public:
         /// @returns the speed of the current workload when
         /// running at the given OPP
+        speed_type getSpeedByOPP(size_t opp_index, WorkloadId workload) const {
+            return getValueByOPP(&CPUIsland::lookupSpeed, opp_index, workload);
+        }
+
         speed_type getSpeedByOPP(size_t opp_index,
                                  const std::string &workload) const {
-            return getValueByOPP(&CPUModel::lookupSpeed, opp_index, workload);
+            return getSpeedByOPP(opp_index, WorkloadId(workload));
         }
 
         /// @returns the speed of the current workload when
         /// running at the given frequency
         // TODO: change to getSpeedByFrequency
-        speed_type getSpeed(freq_type frequency,
-                            const std::string &workload) const {
+        speed_type getSpeed(freq_type frequency, WorkloadId workload) const {
             auto island = getIsland();
             if (!island)
                 return 0;
@@ -722,17 +816,22 @@ namespace RTSim {
             return getSpeedByOPP(opp_index, workload);
         }
 
+        speed_type getSpeed(freq_type frequency,
+                            const std::string &workload) const {
+            return getSpeed(frequency, WorkloadId(workload));
+        }
+
         /// @returns the speed of the current workload when
         /// running at the given OPP
         speed_type getSpeedByOPP(size_t opp_index) const {
-            return getSpeedByOPP(opp_index, getWorkload());
+            return getSpeedByOPP(opp_index, getWorkloadId());
         }
 
         /// @returns the speed of the current workload when
         /// running at the given frequency
         // TODO: change to getSpeedByFrequency
         speed_type getSpeed(freq_type frequency) const {
-            return getSpeed(frequency, getWorkload());
+            return getSpeed(frequency, getWorkloadId());
         }
 
         // ------------------------- Power Getters -------------------------- //
@@ -741,8 +840,7 @@ namespace RTSim {
         /// workload when running at the given OPP; the
         /// returned value is the contribution of this CPU
         /// only to the island power consumption
-        watt_type getPowerByOPP(size_t opp_index,
-                                const std::string &workload) const {
+        watt_type getPowerByOPP(size_t opp_index, WorkloadId workload) const {
             auto island = getIsland();
             if (!island)
                 return 0;
@@ -771,31 +869,35 @@ namespace RTSim {
             // table, but it must be consistent with the
             // other models, so we use this convention.
 
-            if (workload == "idle") {
+            if (workload == WorkloadId::IDLE) {
                 // Shortcut, the standard path gets the same
                 // result for the "idle" state with double
                 // the lookup cost and computation
                 // (increasing error due to floating point
                 // approximations)
-                auto island_idle_power =
-                    getValueByOPP(&CPUModel::lookupPower, opp_index, "idle");
+                auto island_idle_power = getValueByOPP(
+                    &CPUIsland::lookupPower, opp_index, WorkloadId::IDLE);
                 return island_idle_power / watt_type(num_cpus);
             }
 
-            auto island_idle_power =
-                getValueByOPP(&CPUModel::lookupPower, opp_index, "idle");
+            auto island_idle_power = getValueByOPP(
+                &CPUIsland::lookupPower, opp_index, WorkloadId::IDLE);
             auto cpu_active_power =
-                getValueByOPP(&CPUModel::lookupPower, opp_index, workload);
+                getValueByOPP(&CPUIsland::lookupPower, opp_index, workload);
             auto cpu_idle_power = island_idle_power / watt_type(num_cpus);
             // auto cpu_active_power = island_active_power - island_idle_power;
             return cpu_idle_power + cpu_active_power;
         }
 
+        watt_type getPowerByOPP(size_t opp_index,
+                                const std::string &workload) const {
+            return getPowerByOPP(opp_index, WorkloadId(workload));
+        }
+
         /// @returns the power consumption of the current workload when
         /// running at the given frequency
         // TODO: change to getPowerByFrequency
-        watt_type getPower(freq_type frequency,
-                           const std::string &workload) const {
+        watt_type getPower(freq_type frequency, WorkloadId workload) const {
             auto island = getIsland();
             if (!island)
                 return 0;
@@ -803,17 +905,22 @@ namespace RTSim {
             return getPowerByOPP(opp_index, workload);
         }
 
+        watt_type getPower(freq_type frequency,
+                           const std::string &workload) const {
+            return getPower(frequency, WorkloadId(workload));
+        }
+
         /// @returns the power consumption of the current workload when
         /// running at the given OPP
         watt_type getPowerByOPP(size_t opp_index) const {
-            return getPowerByOPP(opp_index, getWorkload());
+            return getPowerByOPP(opp_index, getWorkloadId());
         }
 
         /// @returns the power consumption of the current workload when
         /// running at the given frequency
         // TODO: change to getPowerByFrequency
         watt_type getPower(freq_type frequency) const {
-            return getPower(frequency, getWorkload());
+            return getPower(frequency, getWorkloadId());
         }
 
         // -------------------------- Power Saving -------------------------- //
@@ -864,7 +971,7 @@ namespace RTSim {
 
         // FIXME: reset counters etc.
         void newRun() override {
-            setWorkload("idle");
+            setWorkload(WorkloadId::IDLE);
         }
 
         void endRun() override {}
@@ -900,20 +1007,35 @@ namespace RTSim {
         /// Disables current CPU.
         void disable() {
             _disabled = true;
+            updateModel();
         }
 
         /// Enables current CPU.
         void enable() {
             _disabled = false;
+            updateModel();
         }
 
-        /// Set the workload currently running on the CPU
-        void setWorkload(std::string workload) {
+        /// Set the workload currently running on the CPU, on behalf of
+        /// the given task (used to account its energy)
+        void setWorkload(WorkloadId workload, const AbsRTTask *task) {
             assert(!disabled());
             _workload = workload;
+            _task = workload == WorkloadId::IDLE ? nullptr : task;
             updateModel();
         }
 
+        /// Set the workload currently running on the CPU, the task does
+        /// not change unless it is idle
+        void setWorkload(WorkloadId workload) {
+            setWorkload(workload, _task);
+        }
+
+        /// Same as above, interns the name first
+        void setWorkload(const std::string &workload) {
+            setWorkload(WorkloadId(workload));
+        }
+
         /// Sets the current OPP of the CPU using its index
         void setOPP(size_t opp_index) {
             auto island = getIsland();
@@ -928,6 +1050,18 @@ namespace RTSim {
             _max_power = max_p;
         }
 
+        /// Used by EnergyMeter::attach(), see there
+        void setEnergyMeter(EnergyMeter *meter) {
+            _meter = meter;
+        }
+
+        /// Registers the instruction executing on the CPU, which is
+        /// refreshed when the OPP of the island changes its speed
+        /// (nullptr when none is executing)
+        void setInstr(Instr *instr) {
+            _instr = instr;
+        }
+
     private:
         /// This method is used only for caching purposes.
         /// If this is deemed unnecessary, these operations
@@ -940,14 +1074,16 @@ namespace RTSim {
                 // the Island has just been deleted.
                 _cpu_power = 0;
                 _cpu_speed = 0;
-                return;
-            }
+            } else {
+                auto opp_index = island->getOPPIndex();
+                auto workload = getWorkloadId();
 
-            auto opp_index = island->getOPPIndex();
-            auto workload = getWorkload();
+                _cpu_power = getPowerByOPP(opp_index, workload);
+                _cpu_speed = getSpeedByOPP(opp_index, workload);
+            }
 
-            _cpu_power = getPowerByOPP(opp_index, workload);
-            _cpu_speed = getSpeedByOPP(opp_index, workload);
+            if (_meter)
+                _meter->update(this);
         }
 
         // =================================================
@@ -957,9 +1093,18 @@ namespace RTSim {
         /// Index of the CPU in its multiprocessor environment
         int _index;
 
-        /// Workload currently executing on this CPU ("idle"
+        /// Workload currently executing on this CPU (idle
         /// if no task is running)
-        std::string _workload;
+        WorkloadId _workload;
+
+        /// Task running the workload above, if known
+        const AbsRTTask *_task = nullptr;
+
+        /// Meter measuring the energy of this CPU, if any
+        EnergyMeter *_meter = nullptr;
+
+        /// Instruction executing on this CPU, if any
+        Instr *_instr = nullptr;
 
         /// Power consumption of this CPU in current working
         /// conditions (cached from CPUModel)
@@ -1033,17 +1178,6 @@ namespace RTSim {
         CPUIsland *_island;
     };
 
-    inline void CPUIsland::updateModels() {
-        // NOTICE: The power model is held by the
-        // CPUIsland, but always queried by each CPU
-        if (_powermodel == nullptr)
-            return;
-
-        for (auto cpu : _cpus) {
-            cpu->updateModel();
-        }
-    }
-
     inline CPUIsland::~CPUIsland() {
         // Remove association in associated CPUs
         // (otherwise UB may happend when dereferencing
@@ -1093,6 +1227,9 @@ namespace RTSim {
         if (res == _cpus.cend())
             return false;
 
+        // The contribution of each CPU to the power depends on their number
+        _tables.clear();
+
         // Remove the association of the CPU to the Island
 
         // TODO: should a CPU create a new Island each
@@ -1110,6 +1247,8 @@ namespace RTSim {
         auto res = _cpus.insert(cpu);
 
         if (res.second) {
+            _tables.clear();
+
             // This operation will trigger an update of the CPU model
             cpu->setIsland(this);
         }
@@ -1117,6 +1256,46 @@ namespace RTSim {
         return res.second;
     }
 
+    inline void CPUIsland::compileModel() const {
+        if (_powermodel == nullptr)
+            return;
+
+        const size_t count = WorkloadId::count();
+        _power_table.reserve(count * _opps.size());
+        _speed_table.reserve(count * _opps.size());
+        for (; _compiled < count; ++_compiled) {
+            auto workload = WorkloadId::fromIndex(_compiled);
+            for (const OPP &opp : _opps) {
+                _power_table.push_back(_powermodel->lookupPower(opp, workload));
+                _speed_table.push_back(_powermodel->lookupSpeed(opp, workload));
+            }
+        }
+    }
+
+    inline const CPUIsland::OPPTable &
+        CPUIsland::getOPPTable(WorkloadId workload) const {
+        const auto index = workload.index();
+        if (index >= _tables.size())
+            _tables.resize(index + 1);
+
+        OPPTable &table = _tables[index];
+        if (table.power.size() == _opps.size() && !_opps.empty())
+            return table;
+
+        assert(!_cpus.empty());
+        const CPU *cpu = *_cpus.cbegin();
+
+        table.power.clear();
+        table.speed.clear();
+        table.power.reserve(_opps.size());
+        table.speed.reserve(_opps.size());
+        for (size_t i = 0; i < _opps.size(); ++i) {
+            table.power.push_back(cpu->getPowerByOPP(i, workload));
+            table.speed.push_back(cpu->getSpeedByOPP(i, workload));
+        }
+        return table;
+    }
+
     inline bool CPUIsland::busy() const {
         for (auto cpu : _cpus) {
             if (cpu->busy())
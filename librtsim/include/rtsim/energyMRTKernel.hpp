@@ -56,9 +56,7 @@ namespace RTSim {
         EnergyMultiCoresScheds(MRTKernel *kernel, vector<CPU *> &cpus,
                                vector<Scheduler *> &s, const string &name);
 
-        ~EnergyMultiCoresScheds() {
-            std::cout << __func__ << std::endl;
-        }
+        ~EnergyMultiCoresScheds() {}
 
         /**
          * Add a task to the queue of a core. Use instead
@@ -83,14 +81,15 @@ namespace RTSim {
         */
         void onMigrationFinished(AbsRTTask *t, CPU *original,
                                  CPU *final) override {
+            DBGENTER(_MULTISCHED_DBG_LEV);
             CBServerCallingEMRTKernel *cbs =
                 dynamic_cast<CBServerCallingEMRTKernel *>(t);
             assert(cbs != NULL);
             assert(original != NULL);
             assert(final != NULL);
-            std::cout << "\t\tEMCS::" << __func__ << "()" << std::endl;
+            DBGPRINT("\t\tEMCS::", __func__, "()");
 
-            final->setWorkload(Utils::getTaskWorkload(t));
+            final->setWorkload(Utils::getTaskWorkloadId(t));
             Tick newBudget =
                 Tick(ceil(cbs->getFirstTask()->getWCET(final->getSpeed())));
             cbs->changeBudget(Tick(newBudget));
@@ -257,7 +256,7 @@ namespace RTSim {
         /// cores work
         void balanceLoadEnergy(CPU_BL **chosenCPU, unsigned int &chosenOPP,
                                bool &chosenCPUchanged,
-                               vector<struct ConsumptionTable> iDeltaPows);
+                               const vector<ConsumptionTable> &iDeltaPows);
 
         /// Balance load by migration. Tasks in toBeSkipped will be skipped.
         /// todo joinable with balanceLoadEnergy?
@@ -272,9 +271,31 @@ namespace RTSim {
         /**
          * CPU_BL choice from the table of consumptions (not sorted).
          * It tries to spread tasks on CPU_BLs if they have the same energy
-         * consumption
+         * consumption. Only the cheapest entries are looked for, the table
+         * is never sorted.
          */
-        void chooseCPU_BL(AbsRTTask *t, vector<ConsumptionTable> iDeltaPows);
+        void chooseCPU_BL(AbsRTTask *t,
+                          const vector<ConsumptionTable> &iDeltaPows);
+
+        /// @return the cheapest entry of iDeltaPows among those satisfying
+        /// pred, or iDeltaPows.cend() if there is none
+        template <class Pred>
+        static vector<ConsumptionTable>::const_iterator
+            getCheapest(const vector<ConsumptionTable> &iDeltaPows,
+                        Pred pred) {
+            auto best = iDeltaPows.cend();
+            for (auto it = iDeltaPows.cbegin(); it != iDeltaPows.cend(); ++it)
+                if (pred(*it) &&
+                    (best == iDeltaPows.cend() || it->cons < best->cons))
+                    best = it;
+            return best;
+        }
+
+        static vector<ConsumptionTable>::const_iterator
+            getCheapest(const vector<ConsumptionTable> &iDeltaPows) {
+            return getCheapest(iDeltaPows,
+                               [](const ConsumptionTable &) { return true; });
+        }
 
         /// Returns the CBS servers enveloping the periodic tasks
         vector<AbsRTTask *> getEnvelopers(vector<AbsRTTask *> ptasks) const {
@@ -322,7 +343,7 @@ namespace RTSim {
          * cores, increasing power consumption.
          */
         void leaveLittle3(AbsRTTask *t,
-                          std::vector<ConsumptionTable> iDeltaPows,
+                          const std::vector<ConsumptionTable> &iDeltaPows,
                           CPU_BL *&chosenCPU_BL);
 
         /// Returns a possible migration to endingCPU. Tasks in toBeSkipped will
@@ -339,6 +360,7 @@ namespace RTSim {
         /// Performs a temporary migration, i.e. one that last only until a task
         /// arrives on endingCPU
         bool migrateTemporarily(CPU_BL *endingCPU) {
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
             /**
               Balance on island and execute until ending task DL or new task
               arrives. At that point, move back task on its original core, so
@@ -349,28 +371,26 @@ namespace RTSim {
               */
             if (!EMRTK_TEMPORARILY_MIGRATE_VTIME &&
                 !EMRTK_TEMPORARILY_MIGRATE_END) {
-                std::cout << "\tTemporary migrations disabled => skip"
-                          << std::endl;
+                DBGPRINT("\tTemporary migrations disabled => skip");
                 return false;
             }
 
-            std::cout << "\tEMRTK::" << __func__ << "()" << std::endl;
+            DBGPRINT("\tEMRTK::", __func__, "()");
             MigrationProposal migrationProposal = balanceLoad(endingCPU, {});
 
             if (migrationProposal.task == NULL) {
-                std::cout
-                    << "\tNo temporary migration (by balancing) possible. skip"
-                    << std::endl;
+                DBGPRINT("\tNo temporary migration (by balancing) possible. "
+                         "skip");
                 return false;
             }
 
-            std::cout << "\tTemporarily migrated "
-                      << migrationProposal.task->toString() << " from "
-                      << migrationProposal.from->toString() << " to "
-                      << migrationProposal.to->toString() << std::endl;
+            DBGPRINT("\tTemporarily migrated ",
+                     migrationProposal.task->toString(), " from ",
+                     migrationProposal.from->toString(), " to ",
+                     migrationProposal.to->toString());
             _temporarilyMigrated.push_back(migrationProposal);
             migrationProposal.to->setWorkload(
-                Utils::getTaskWorkload(migrationProposal.task));
+                Utils::getTaskWorkloadId(migrationProposal.task));
             _queues->onMigrationFinished(migrationProposal.task,
                                          migrationProposal.from,
                                          migrationProposal.to);
@@ -379,15 +399,15 @@ namespace RTSim {
 
         /// Remove tasks temporarily migrated task to core 'to'
         void removeTaskTemporarilyMigrated(CPU_BL *to) {
-            std::cout << "\tEMRTK::" << __func__
-                      << "() to core=" << to->toString() << std::endl;
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+            DBGPRINT("\tEMRTK::", __func__, "() to core=", to->toString());
             for (int i = 0; i < _temporarilyMigrated.size(); i++) {
                 if (_temporarilyMigrated.at(i).to == to) {
                     MigrationProposal mp = _temporarilyMigrated.at(i);
                     if (dynamic_cast<CBServerCallingEMRTKernel *>(mp.task)
                             ->getFirstTask() !=
                         NULL) { // is task ended already TODO
-                        mp.from->setWorkload(Utils::getTaskWorkload(mp.task));
+                        mp.from->setWorkload(Utils::getTaskWorkloadId(mp.task));
                         _queues->onMigrationFinished(mp.task, mp.to, mp.from);
                     }
                     _temporarilyMigrated.erase(_temporarilyMigrated.begin() +
@@ -456,7 +476,6 @@ namespace RTSim {
                         Island_BL *little, const string &name = "");
 
         virtual ~EnergyMRTKernel() {
-            std::cout << "~EnergyMRTKernel" << std::endl;
             delete _islands[0];
             delete _islands[1];
 
@@ -667,6 +686,7 @@ namespace RTSim {
 
         /// Does migration break schedulability on the ending core?
         bool isMigrationSafe(const MigrationProposal mp) {
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
             assert(mp.task != NULL);
             assert(mp.from != NULL);
             assert(mp.to != NULL);
@@ -674,9 +694,9 @@ namespace RTSim {
             CBServerCallingEMRTKernel *task_m =
                 dynamic_cast<CBServerCallingEMRTKernel *>(mp.task);
 
-            string starting_wl = endingCPU->getWorkload();
-            endingCPU->setWorkload(Utils::getTaskWorkload(task_m));
-            std::cout << "\tEMRTK::" << __func__ << "()" << std::endl;
+            WorkloadId starting_wl = endingCPU->getWorkloadId();
+            endingCPU->setWorkload(Utils::getTaskWorkloadId(task_m));
+            DBGPRINT("\tEMRTK::", __func__, "()");
 
             double utilCore = getUtilization(endingCPU, endingCPU->getSpeed());
             bool safe =
@@ -688,22 +708,19 @@ namespace RTSim {
                                              // (remaining core util)
 
             if (!safe)
-                std::cout << "\t\tNot safe to migrate " << task_m->toString()
-                          << " into " << endingCPU->toString()
-                          << " => pick next ready" << std::endl;
+                DBGPRINT("\t\tNot safe to migrate ", task_m->toString(),
+                         " into ", endingCPU->toString(),
+                         " => pick next ready");
             else
-                std::cout << "\t\tMigration safe " << task_m->toString()
-                          << mp.from->toString() << " -> "
-                          << endingCPU->toString() << std::endl;
-
-            std::cout << "\t\t\t" << endingCPU->toString() << " "
-                      << endingCPU->getWorkload() << " "
-                      << endingCPU->getFrequency() << std::endl;
-            std::cout << "\t\t\tCalculation: "
-                      << (double) task_m->getWCET(1.0) / endingCPU->getSpeed()
-                      << " > (" << 1 - utilCore << ") * ("
-                      << task_m->getDeadline() << " - " << SIMUL.getTime()
-                      << ")? if yes, unsafe" << std::endl;
+                DBGPRINT("\t\tMigration safe ", task_m->toString(),
+                         mp.from->toString(), " -> ", endingCPU->toString());
+
+            DBGPRINT("\t\t\t", endingCPU->toString(), " ",
+                     endingCPU->getWorkload(), " ", endingCPU->getFrequency());
+            DBGPRINT("\t\t\tCalculation: ",
+                     (double) task_m->getWCET(1.0) / endingCPU->getSpeed(),
+                     " > (", 1 - utilCore, ") * (", task_m->getDeadline(),
+                     " - ", SIMUL.getTime(), ")? if yes, unsafe");
 
             endingCPU->setWorkload(starting_wl);
             return safe;
@@ -744,7 +761,8 @@ namespace RTSim {
         void onEnd(AbsRTTask *t) override;
 
         void onExecutingRecharging(CBServer *cbs) {
-            std::cout << "EMRTK::" << __func__ << "()" << std::endl;
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+            DBGPRINT("EMRTK::", __func__, "()");
 
             _queues->onExecutingRecharging(cbs);
         }
@@ -752,15 +770,15 @@ namespace RTSim {
         /// Callback called when a task on a CBS CEMRTK. goes executing ->
         /// releasing
         void onExecutingReleasing(CBServer *cbs) {
-            std::cout << "EMRTK::" << __func__ << "()" << std::endl;
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+            DBGPRINT("EMRTK::", __func__, "()");
             CPU *cpu = getOldProcessor(cbs);
 
             // for some reason, here task has wl idle, wrongly (should be kept
             // until the end of this function). reset:
-            cpu->setWorkload(Utils::getTaskWorkload(cbs));
-            std::cout << "\t" << cpu->getName()
-                      << " has now wl: " << cpu->getWorkload()
-                      << ", speed: " << cpu->getSpeed() << std::endl;
+            cpu->setWorkload(Utils::getTaskWorkloadId(cbs));
+            DBGPRINT("\t", cpu->getName(), " has now wl: ", cpu->getWorkload(),
+                     ", speed: ", cpu->getSpeed());
 
             _queues->onExecutingReleasing(cpu, cbs);
 
@@ -771,9 +789,8 @@ namespace RTSim {
                   schedule ready tasks on the core (i.e., deschedule & schedule
                   server)
                   */
-                std::cout << "\tServer's got empty. Server yields (= schedule "
-                             "a ready task of core)"
-                          << std::endl;
+                DBGPRINT("\tServer's got empty. Server yields (= schedule a "
+                         "ready task of core)");
                 _queues->yield(cpu);
                 cbs->yield(); // server might still have higher priority and
                               // thus still get scheduled (=> 2 running tasks on
@@ -784,9 +801,8 @@ namespace RTSim {
                   Schedule ready task on core
                   */
                 assert(cbs->getStatus() == ServerStatus::RELEASING);
-                std::cout << "CBS enveloping periodic tasks enabled => "
-                             "schedule ready on "
-                          << cpu->getName() << std::endl;
+                DBGPRINT("CBS enveloping periodic tasks enabled => schedule "
+                         "ready on ", cpu->getName());
                 _queues->schedule(cpu);
             }
 
@@ -797,10 +813,10 @@ namespace RTSim {
         /// CBS server still alive.
         void onCBSKilled(AbsRTTask *t, CPU_BL *cpu,
                          CBServerCallingEMRTKernel *cbs) {
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
             assert(cpu != NULL);
             assert(cbs != NULL);
-            std::cout << "EMRTK::" << __func__ << "() for " << cbs->toString()
-                      << std::endl;
+            DBGPRINT("EMRTK::", __func__, "() for ", cbs->toString());
 
             _queues->onTaskInServerEnd(t, cpu, cbs); // save util active
             _queues->onEnd(cbs, cpu);
@@ -809,22 +825,21 @@ namespace RTSim {
         /// Callback called when a task on a CBS CEMRTK. goes executing ->
         /// releasing (virtual time ends)
         void onReleasingIdle(CBServer *cbs) {
-            std::cout << "EMRTK::" << __func__ << "()" << std::endl;
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+            DBGPRINT("EMRTK::", __func__, "()");
             CPU_BL *endingCPU = dynamic_cast<CPU_BL *>(
                 _queues->onReleasingIdle(cbs)); // forget U_active
             AbsRTTask *oldTask = getRunningTask(endingCPU);
 
             if (!getReadyTasks(endingCPU).empty()) {
-                std::cout << "\tCore already has some ready tasks. Scheduling "
-                             "one of those"
-                          << std::endl;
+                DBGPRINT("\tCore already has some ready tasks. Scheduling one "
+                         "of those");
                 _queues->schedule(endingCPU);
                 return;
             }
             if (!EMRTK_CBS_ENVELOPING_MIGRATE_AFTER_VTIME_END) {
-                std::cout
-                    << "\tEMRTK_CBS_ENVELOPING_MIGRATE_AFTER_VTIME_END disabled"
-                    << std::endl;
+                DBGPRINT("\tEMRTK_CBS_ENVELOPING_MIGRATE_AFTER_VTIME_END "
+                         "disabled");
                 return;
             }
 
@@ -850,8 +865,8 @@ namespace RTSim {
             }
 
             if (task_m != NULL) {
-                std::cout << "\tConfirmed migration of " << task_m->toString()
-                          << " into " << endingCPU->toString() << std::endl;
+                DBGPRINT("\tConfirmed migration of ", task_m->toString(),
+                         " into ", endingCPU->toString());
                 _queues->onMigrationFinished(migrationProposal.task,
                                              migrationProposal.from,
                                              migrationProposal.to);
@@ -861,43 +876,42 @@ namespace RTSim {
         }
 
         void onReplenishment(CBServer *cbs) {
-            std::cout << "EMRTK::" << __func__ << "()" << std::endl;
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
+            DBGPRINT("EMRTK::", __func__, "()");
             _queues->onReplenishment(cbs);
             dispatch();
         }
 
         /// Callback, when a CBS server ends a task
         void onTaskInServerEnd(AbsRTTask *t, CPU_BL *cpu, CBServer *cbs) {
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
             assert(t != NULL);
             assert(cpu != NULL);
             assert(cbs != NULL);
 
-            std::cout << "\tEMRTK::" << __func__ << "()" << std::endl;
+            DBGPRINT("\tEMRTK::", __func__, "()");
             _queues->onTaskInServerEnd(t, cpu, cbs); // save util active
-            std::cout << __func__ << "() cbs is empty? " << cbs->isEmpty()
-                      << std::endl;
+            DBGPRINT(__func__, "() cbs is empty? ", cbs->isEmpty());
             if (cbs->isEmpty())
                 onEnd(cbs);
         }
 
         /// Callback, when a task gets running on a core
         void onTaskGetsRunning(AbsRTTask *t, CPU_BL *cpu) {
+            DBGENTER(_ENERGYMRTKERNEL_DBG_LEV);
             assert(t != NULL);
             assert(cpu != NULL);
-            std::cout << "EMRTK::" << __func__ << "() " << taskname(t) << " on "
-                      << cpu->getName() << std::endl;
-
-            std::cout << "\t" << cpu->getName()
-                      << " had wl: " << cpu->getWorkload()
-                      << ", speed: " << cpu->getSpeed()
-                      << ", freq: " << cpu->getFrequency() << std::endl;
-            cpu->setWorkload(Utils::getTaskWorkload(t));
+            DBGPRINT("EMRTK::", __func__, "() ", taskname(t), " on ",
+                     cpu->getName());
+
+            DBGPRINT("\t", cpu->getName(), " had wl: ", cpu->getWorkload(),
+                     ", speed: ", cpu->getSpeed(), ", freq: ",
+                     cpu->getFrequency());
+            cpu->setWorkload(Utils::getTaskWorkloadId(t));
             assert(cpu->getWorkload() != "");
-            std::cout << "\t" << cpu->getName()
-                      << " has now wl: " << cpu->getWorkload()
-                      << ", speed: " << cpu->getSpeed()
-                      << ", freq: " << cpu->getFrequency() << std::endl
-                      << std::endl;
+            DBGPRINT("\t", cpu->getName(), " has now wl: ", cpu->getWorkload(),
+                     ", speed: ", cpu->getSpeed(), ", freq: ",
+                     cpu->getFrequency());
         }
 
         /**
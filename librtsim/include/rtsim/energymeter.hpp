@@ -0,0 +1,148 @@
+#ifndef __RTSIM_ENERGYMETER_HPP__
+#define __RTSIM_ENERGYMETER_HPP__
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// MetaSim
+#include <metasim/baseexc.hpp>
+#include <metasim/entity.hpp>
+#include <metasim/tick.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    class AbsRTTask;
+    class CPU;
+    class CPUIsland;
+
+    /// \ingroup server
+    ///
+    /// Measures the energy consumed by a set of CPUs without posting any
+    /// event. The power of a CPU is constant between two changes of its
+    /// workload, of the OPP of its island or of its enabled state, and the
+    /// CPU notifies the meter at each of them; the meter integrates the
+    /// power exactly over each interval.
+    ///
+    /// Energies are in Watt times ticks, averages in Watt. The energy of a
+    /// CPU while a task runs on it is also charged to the task (idle
+    /// intervals are charged to no task).
+    ///
+    /// The meter is reset at the beginning of each run; all the values are
+    /// relative to the start of the current run and can be read at any
+    /// time.
+    ///
+    /// @code
+    /// EnergyMeter meter("meter");
+    /// meter.attach(island);
+    /// SIMUL.run(1000);
+    /// long double e = meter.getEnergy(island);
+    /// @endcode
+    class EnergyMeter : public Entity {
+    public:
+        /// \ingroup server
+        ///
+        /// Exceptions for the EnergyMeter class.
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "EnergyMeter",
+                const std::string md = "energymeter.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        EnergyMeter(const std::string &name = "");
+
+        ~EnergyMeter();
+
+        /// Starts measuring c. A CPU can be measured by one meter at a
+        /// time.
+        void attach(CPU *c);
+
+        /// Starts measuring all the CPUs of the island
+        void attach(CPUIsland *island);
+
+        /// Stops measuring c, discarding its energy
+        void detach(CPU *c);
+
+        /// Writes a line "<tick> <cpu> <power>" to os each time the power
+        /// of a CPU changes (nullptr disables the trace)
+        void setTrace(std::ostream *os) {
+            _trace = os;
+        }
+
+        /// @return the energy consumed by c since the start of the run
+        long double getEnergy(const CPU *c) const;
+
+        /// @return the energy consumed by the measured CPUs of island
+        long double getEnergy(const CPUIsland *island) const;
+
+        /// @return the energy consumed by all the measured CPUs
+        long double getEnergy() const;
+
+        /// @return the energy consumed by the CPUs while task was running
+        /// on them
+        long double getEnergy(const AbsRTTask *task) const;
+
+        /// @return the average power of c since the start of the run
+        long double getAveragePower(const CPU *c) const {
+            return average(getEnergy(c));
+        }
+
+        /// @return the average power of the measured CPUs of island
+        long double getAveragePower(const CPUIsland *island) const {
+            return average(getEnergy(island));
+        }
+
+        /// @return the average power of all the measured CPUs
+        long double getAveragePower() const {
+            return average(getEnergy());
+        }
+
+        /// Called by the CPU each time its power or its task may have
+        /// changed
+        void update(const CPU *c);
+
+        // From Entity...
+        void newRun() override;
+        void endRun() override {}
+
+    private:
+        struct Meter {
+            CPU *cpu;
+            const AbsRTTask *task;
+            double power;
+            Tick last;
+            long double energy;
+        };
+
+        const Meter &find(const CPU *c) const;
+
+        /// @return the energy of m up to the current time
+        long double getEnergy(const Meter &m) const;
+
+        long double average(long double energy) const;
+
+        void reset(Meter &m);
+
+        void record(const Meter &m);
+
+        std::vector<Meter> _meters;
+
+        /// Index of each CPU in _meters
+        std::unordered_map<const CPU *, size_t> _index;
+
+        /// Energy of the tasks up to the last change of their CPU
+        std::unordered_map<const AbsRTTask *, long double> _tasks;
+
+        Tick _start;
+
+        std::ostream *_trace = nullptr;
+    };
+
+} // namespace RTSim
+
+#endif // __RTSIM_ENERGYMETER_HPP__
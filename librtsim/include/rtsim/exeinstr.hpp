@@ -38,12 +38,15 @@
 
 // From RTLIB
 #include <rtsim/instr.hpp>
+#include <rtsim/workload.hpp>
 #include <sstream>
 
 namespace RTSim {
 
     using namespace MetaSim;
 
+    class CPU;
+
     /**
         \ingroup instr
 
@@ -62,8 +65,8 @@ namespace RTSim {
         bool isBegOfInstr;
         /// Random var representing the instruction cost/duration
         std::unique_ptr<RandomVar> cost;
-        /// Random var representing the instruction cost/duration
-        string workload;
+        /// Workload class of the instruction, interned when it is created
+        WorkloadId workload;
         /// Actual Real-Time execution of the instruction
         Tick execdTime;
         /// Duration of the current instruction
@@ -75,6 +78,16 @@ namespace RTSim {
         Tick lastTime;
         /// True if the instruction is currently executing
         bool executing;
+        /// CPU the instruction is registered on while executing, which
+        /// refreshes it when its speed changes
+        CPU *cpu;
+
+        /// @returns the ticks needed to execute the remaining cycles at
+        /// the given speed
+        Tick getRemainingTime(double speed) const;
+
+        /// Unregisters the instruction from its CPU
+        void releaseCPU();
 
         // copy constructor
         ExecInstr(const ExecInstr &obj);
@@ -113,6 +126,10 @@ namespace RTSim {
             return actCycles;
         }
         virtual string getWorkload() const {
+            return workload.getName();
+        }
+
+        WorkloadId getWorkloadId() const {
             return workload;
         }
 
@@ -129,7 +146,10 @@ namespace RTSim {
         void endRun() override;
 
         /** Function inherited from Instr. It refreshes the state of the
-         *  executing instruction when a change of the CPU speed occurs.
+         *  executing instruction when a change of the CPU speed occurs:
+         *  the cycles executed at the old speed are accounted and the end
+         *  event is moved according to the new one (it is not touched if
+         *  the end does not change).
          */
         void refreshExec(double oldSpeed, double newSpeed) override;
     };
@@ -0,0 +1,137 @@
+// #pragma once
+
+#ifndef RTSIM_FPANALYSIS_HPP
+#define RTSIM_FPANALYSIS_HPP
+
+#include <string>
+#include <vector>
+
+// MetaSim
+#include <metasim/baseexc.hpp>
+#include <metasim/tick.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /// \ingroup sched
+    ///
+    /// Response-time analysis of a set of fixed-priority tasks (or
+    /// servers), keeping its intermediate results between queries, for
+    /// supervisors that analyze the same set every time a budget changes.
+    ///
+    /// Levels are indexed by priority, 0 being the highest one. For each
+    /// level the analysis caches:
+    /// - the scheduling points, which depend only on the periods of the
+    ///   higher priority levels and are computed once;
+    /// - the last iterate of the response-time recurrence, used to
+    ///   warm-start the next query of the same level.
+    ///
+    /// The iterates are lower bounds of the response time as long as no
+    /// WCET decreases; decreasing the WCET of level i restarts levels i
+    /// and below from scratch. Changing a WCET never affects the levels
+    /// with higher priority.
+    ///
+    /// @code
+    /// FPAnalysis a;
+    /// a.addLevel(1, 4);
+    /// a.addLevel(2, 6);
+    /// a.addLevel(3, 13);
+    /// Tick r = a.getResponseTime(2);     // 10
+    /// Tick c = a.getMaxWCET(1, 6);       // largest WCET of level 1
+    /// @endcode
+    class FPAnalysis {
+    public:
+        /// \ingroup sched
+        ///
+        /// Exceptions for the FPAnalysis class.
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "FPAnalysis",
+                const std::string md = "fpanalysis.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        /// Adds a level with lower priority than all the previous ones.
+        /// A non-positive deadline means deadline = period.
+        ///
+        /// @return the index of the new level
+        size_t addLevel(Tick wcet, Tick period, Tick dline = 0);
+
+        /// Removes all the levels
+        void clear();
+
+        size_t size() const {
+            return _levels.size();
+        }
+
+        Tick getWCET(size_t i) const {
+            return _levels.at(i).wcet;
+        }
+
+        Tick getPeriod(size_t i) const {
+            return _levels.at(i).period;
+        }
+
+        Tick getDeadline(size_t i) const {
+            return _levels.at(i).dline;
+        }
+
+        /// Changes the WCET of level i, without analyzing anything
+        void setWCET(size_t i, Tick wcet);
+
+        /// @return the worst-case response time of level i, if it does not
+        /// exceed its deadline, otherwise a value greater than the deadline
+        Tick getResponseTime(size_t i);
+
+        /// @return true if level i meets its deadline
+        bool isSchedulable(size_t i) {
+            return getResponseTime(i) <= getDeadline(i);
+        }
+
+        /// @return true if levels i and below would meet their deadlines
+        /// with the given WCET for level i, which is not changed
+        bool tryWCET(size_t i, Tick wcet);
+
+        /// Binary search of the largest WCET of level i, between the
+        /// current one and max, for which levels i and below meet their
+        /// deadlines. The current WCET is assumed to be feasible.
+        Tick getMaxWCET(size_t i, Tick max);
+
+        /// @return the scheduling points of level i, i.e. the instants in
+        /// (0, D_i] where its schedulability has to be checked (Bini and
+        /// Buttazzo), sorted and without repetitions
+        const std::vector<Tick> &getSchedPoints(size_t i);
+
+    private:
+        typedef Tick::impl_t impl_t;
+
+        struct Level {
+            impl_t wcet;
+            impl_t period;
+            impl_t dline;
+            // last iterate of the recurrence, 0 if none
+            impl_t bound;
+        };
+
+        // Iterates the recurrence of level i from r, with the WCET of
+        // level k replaced by ck. Returns the fixed point or the first
+        // iterate past the deadline.
+        impl_t iterate(size_t i, impl_t r, size_t k, impl_t ck) const;
+
+        // Checks levels i and below with the WCET of level i replaced by
+        // c, starting level j from start[j]. On success the response
+        // times are left in start.
+        bool probe(size_t i, impl_t c, std::vector<impl_t> &start) const;
+
+        std::vector<Level> _levels;
+        std::vector<std::vector<Tick>> _points;
+
+        // Scratch buffers of probe(), kept to avoid reallocations
+        std::vector<impl_t> _best, _probe;
+    };
+
+} // namespace RTSim
+
+#endif // RTSIM_FPANALYSIS_HPP
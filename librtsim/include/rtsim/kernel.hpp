@@ -20,6 +20,7 @@
 
 #include <metasim/baseexc.hpp>
 #include <metasim/entity.hpp>
+#include <metasim/simul.hpp>
 
 #include <rtsim/abskernel.hpp>
 #include <rtsim/cpu.hpp>
@@ -76,7 +77,9 @@ namespace RTSim {
 
         @sa absCPUFactory, Scheduler, ResManager, AbsRTTask
     */
-    class RTKernel : public Entity, public virtual AbsKernel {
+    class RTKernel : public Entity,
+                     public virtual AbsKernel,
+                     public BatchHook {
     protected:
         /// The real-time scheduler
         Scheduler *_sched;
@@ -171,6 +174,20 @@ namespace RTSim {
         */
         void dispatch() override;
 
+        /**
+           Calls dispatch() once at the end of the current batch
+           of simultaneous events when the simulation runs in
+           batched mode (see Simulation::setBatching()), or
+           immediately otherwise. Used by onArrival(), so that
+           N tasks arriving at the same time cost a single
+           scheduling decision.
+        */
+        void dispatchOncePerBatch();
+
+        /// Performs the dispatch() requested with
+        /// dispatchOncePerBatch().
+        void onEndOfBatch() override;
+
         virtual void onBeginDispatch(Event *e);
         virtual void onEndDispatch(Event *e);
 
@@ -14,6 +14,10 @@
 #ifndef __MRTKERNEL_HPP__
 #define __MRTKERNEL_HPP__
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 // Single CPU RTKernel
 #include <rtsim/kernel.hpp>
 #include <rtsim/kernevt.hpp>
@@ -163,8 +167,9 @@ namespace RTSim {
     /// access related operations and thus implements a resource allocation
     /// policy (NOTE: not destroyed by the kernel itself);
     ///
-    /// - a map of pointers to CPU and task, which keeps the information about
-    /// current task assignment to CPUs;
+    /// - the state of each CPU and of each task, in arrays indexed by a slot
+    /// number, which keeps the information about current task assignment to
+    /// CPUs;
     ///
     /// - the set of tasks handled by this kernel.
     ///
@@ -182,9 +187,9 @@ namespace RTSim {
     ///
     /// @see absCPUFactory, Scheduler, ResManager, AbsRTTask
     ///
-    /// @note Internally this class does not have a list of CPUs, rather it
-    /// knows which CPUs are linked to it because of its mapping from CPUs to
-    /// Tasks (or to null pointers if no task is in execution).
+    /// @note Each CPU and each task gets a slot number when added to the
+    /// kernel, so that all the lookups between CPUs and tasks take constant
+    /// time.
     ///
     /// @note Since it extends RTKernel, it has a single CPU associated that is
     /// managed by the superclass, but never used.
@@ -193,8 +198,68 @@ namespace RTSim {
         // Internal Types
         // =================================================
     protected:
-        using ITCPU = std::map<CPU *, AbsRTTask *>::iterator;
-        using CITCPU = std::map<CPU *, AbsRTTask *>::const_iterator;
+        /// State of a CPU, indexed by the slot assigned by addCPU().
+        struct CPUState {
+            CPU *cpu;
+
+            /// The currently executing task.
+            AbsRTTask *exe;
+
+            /// Number of tasks dispatched on this CPU (normally at most
+            /// one, see TaskState::dispatched).
+            int dispatched;
+
+            /// Indicates whether the CPU is currently in the middle of a
+            /// context switch.
+            bool switching;
+
+            BeginDispatchMultiEvt *beginEvt;
+            EndDispatchMultiEvt *endEvt;
+        };
+
+        /// State of a task, indexed by the slot assigned by addTask().
+        /// CPUs are referred to by their slot, -1 means none.
+        struct TaskState {
+            AbsRTTask *task;
+
+            /// Where the task is executing.
+            int exe;
+
+            /// This denotes where the task has been dispatched. A
+            /// dispatched task is also the currently executing task once
+            /// the context switch is over.
+            ///
+            /// The set of dispatched tasks includes the set of executing
+            /// tasks:
+            ///
+            /// - first, in the onBeginDispatchMulti a task is dispatched,
+            /// (but not executing yet);
+            ///
+            /// - then, in the onEndDispatchMulti, its execution starts on
+            /// the processor (the task remains dispatched to that
+            /// processor anyway until another task or the idle task is
+            /// scheduled on it).
+            int dispatched;
+
+            /// Where the task was executing before being suspended.
+            int old;
+
+            /// Whether the task is in _ranked, and with which key.
+            bool ranked;
+            TaskModel::SortKey key;
+        };
+
+        /// A dispatched task, with its sort key in the ready queue.
+        struct RankedTask {
+            TaskModel::SortKey key;
+            AbsRTTask *task;
+        };
+
+        struct RankedTaskCmp {
+            bool operator()(const RankedTask &a, const RankedTask &b) const {
+                return a.key < b.key;
+            }
+        };
 
         // =================================================
         // Data
@@ -204,35 +269,30 @@ namespace RTSim {
         /// @deprecated removed because only needed in constructors.
         // absCPUFactory *_CPUFactory;
 
-        /// The currently executing tasks (one per processor).
-        std::map<CPU *, AbsRTTask *> _m_currExe;
+        /// The CPUs, in the order they were added.
+        std::vector<CPUState> _cpus;
 
-        /// Where the task was executing before being suspended
-        std::map<const AbsRTTask *, CPU *> _m_oldExe;
+        /// The slot of each CPU in _cpus.
+        std::unordered_map<const CPU *, int> _cpuSlot;
 
-        /// This denotes where the task has been dispatched. A dispatched task
-        /// is also the currently executing task once the context switch is
-        /// over.
-        ///
-        /// The set of dispatched tasks includes the set of executing tasks:
-        ///
-        /// - first, in the onBeginDispatchMulti a task is dispatched, (but not
-        /// executing yet);
-        ///
-        /// - then, in the onEndDispatchMulti, its execution starts on the
-        /// processor (the task remains dispatched to that processor anyway
-        /// until another task or the idle task is scheduled on it).
-        std::map<const AbsRTTask *, CPU *> _m_dispatched;
+        /// The tasks, in the order they were added.
+        std::vector<TaskState> _taskStates;
+
+        /// The slot of each task in _taskStates.
+        std::unordered_map<const AbsRTTask *, int> _taskSlot;
 
-        /// Indicates whether the CPU is currently in the middle of a context
-        /// switch.
-        std::map<CPU *, bool> _isContextSwitching;
+        /// Bit i is set if the CPU in slot i is free, i.e. it has no
+        /// executing task and no dispatched task.
+        std::vector<uint64_t> _freeCPUs;
 
-        /// Each CPU has its own BeginDispatchMultiEvt
-        std::map<CPU *, BeginDispatchMultiEvt *> _beginEvt;
+        /// The dispatched tasks that are in the ready queue, in the order
+        /// of the queue. The ones past the first N are preempted in this
+        /// order.
+        indexed_priority_list<RankedTask, RankedTaskCmp> _ranked;
 
-        /// Each CPU has its own EndDispatchMultiEvt
-        std::map<CPU *, EndDispatchMultiEvt *> _endEvt;
+        /// Scratch buffer for the CPUs to preempt, reused by each
+        /// dispatch().
+        std::vector<CPU *> _victims;
 
         /// Indicates the amount of delay due to migration of a task.
         ///
@@ -334,9 +394,43 @@ namespace RTSim {
         // Methods
         // =================================================
     protected:
+        /// @return the slot of the given CPU. Throws an exception if the
+        /// CPU does not belong to this kernel.
+        int getCPUSlot(const CPU *c) const;
+
+        /// @return the state of the given task, or nullptr if the task
+        /// does not belong to this kernel.
+        TaskState *getTaskState(const AbsRTTask *t);
+        const TaskState *getTaskState(const AbsRTTask *t) const;
+
+        /// Sets the task executing on the given CPU (nullptr for none).
+        void setExecuting(CPU *c, AbsRTTask *t);
+
+        /// Sets the CPU where the task is dispatched (nullptr for none).
+        void setDispatched(AbsRTTask *t, CPU *c);
+
+        /// @return the CPU where the task is dispatched, or nullptr.
+        CPU *getDispatched(const AbsRTTask *t) const;
+
+        /// Sets the CPU where the task was previously executing.
+        void setOldProcessor(AbsRTTask *t, CPU *c);
+
+        /// Adds the task to (removes it from) the dispatched tasks
+        /// ordered as in the ready queue.
+        void addRanked(TaskState &ts);
+        void removeRanked(TaskState &ts);
+
+        /// Sets the context switching flag of the CPU.
+        void setContextSwitching(CPU *c, bool s) {
+            _cpus[getCPUSlot(c)].switching = s;
+        }
+
+        /// Updates the bit of the CPU in slot i in _freeCPUs.
+        void updateFree(int i);
+
         /// @return a pointer to a free CPU (nullptr if every CPU is busy).
         ///
-        /// @note there is no specific order in which free CPUs are chosen.
+        /// @note CPUs are tried in the order they were added.
         CPU *getFreeProcessor();
 
         // CPU *getFreeProcessor() {
@@ -348,18 +442,13 @@ namespace RTSim {
         /// on.
         bool isDispatched(CPU *p) const;
 
-        /// A CPU is considered free to use if it has no _m_currExe[] task
-        /// mapped, and there are no _m_dispatched[] tasks on that CPU.
+        /// A CPU is considered free to use if it has no executing task,
+        /// and there are no dispatched tasks on that CPU.
         ///
-        /// @returns the first free CPU between the two given iterators (first
-        /// included, last excluded).
-        ITCPU getNextFreeProc(ITCPU begin, ITCPU end);
-
-        // ITCPU getNextFreeProc(CITCPU begin, CITCPU end) {
-        //     return static_cast<ITCPU>(
-        //         const_cast<const MRTKernel *>(this)->getNextFreeProc(begin,
-        //                                                              end));
-        // }
+        /// @returns the slot of the first free CPU starting from slot
+        /// first (included), or -1 if there is none. Takes time
+        /// proportional to the number of CPUs / 64.
+        int getNextFreeProc(int first) const;
 
     public:
         /// Adds a CPU to the set of CPUs handled by the kernel. Initializes all
@@ -380,6 +469,8 @@ namespace RTSim {
         /// Differently from RTKernel::onArrival, this method overlooks whether
         /// the kernel is context switching or not (because each CPU can be in a
         /// context switching state independently from each other).
+        /// In batched mode, the global dispatch() is executed once for
+        /// all the tasks arriving in the same batch.
         ///
         /// @see RTKernel::onArrival
         void onArrival(AbsRTTask *) override;
@@ -428,6 +519,15 @@ namespace RTSim {
         /// After this call, the first N tasks in the ready queue are dispatched
         /// on the N cpus managed by this kernel. If there aren't enough tasks
         /// then some CPUs will be left idle.
+        ///
+        /// The number of new tasks among the first N is found by comparing
+        /// the N-th task of the queue with the dispatched ones, and the CPUs
+        /// to preempt are the ones of the dispatched tasks that fell out of
+        /// the first N, in queue order, so the cost is O(log n) plus the
+        /// number of CPUs that change task.
+        /// Tasks are compared with the keys given by
+        /// Scheduler::getSortKey(), hence any scheduler (e.g., EDF or FP)
+        /// can be used for global scheduling.
         void dispatch() override;
 
         /// Called by the BeginDispatchMultiEvt objects related to each CPU when
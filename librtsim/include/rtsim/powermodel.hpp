@@ -112,7 +112,7 @@ namespace RTSim {
         }
 
         /// Set the current workload running on the CPU
-        void setWorkload(wclass_type workload) {
+        void setWorkload(WorkloadId workload) {
             setOPP(_opp, workload);
         }
 
@@ -145,10 +145,15 @@ namespace RTSim {
         /// frequency will be capped to the maximum frequency value.
         ///
         /// @param opp the new OPP
-        void setOPP(const OPP &opp, const wclass_type &workload = "") {
+        void setOPP(const OPP &opp) {
+            setOPP(opp, _workload);
+        }
+
+        /// Set the current Operating Performance Point (OPP) and the
+        /// workload running on the CPU
+        void setOPP(const OPP &opp, WorkloadId workload) {
             _opp = opp;
-            if (workload != "")
-                _workload = workload;
+            _workload = workload;
 
             if (_opp.frequency > _F_max)
                 _opp.frequency = _F_max;
@@ -157,6 +162,17 @@ namespace RTSim {
             speed_value = speed_model->lookupValue(_opp, _workload, _F_max);
         }
 
+        /// Freezes the power and speed models, so that their values
+        /// can be cached (see CPUIsland::compileModel())
+        void freeze() {
+            power_model->freeze();
+            speed_model->freeze();
+        }
+
+        bool isFrozen() const {
+            return power_model->isFrozen() && speed_model->isFrozen();
+        }
+
         /// @returns the current OPP
         OPP getOPP() const {
             return _opp;
@@ -184,8 +200,7 @@ namespace RTSim {
         /// @param opp desired OPP [MHz and Volts]
         ///
         /// @returns the forshadowed power
-        watt_type lookupPower(const OPP &opp,
-                              const std::string &workload) const {
+        watt_type lookupPower(const OPP &opp, WorkloadId workload) const {
             return power_model->lookupValue(opp, workload);
         }
 
@@ -196,8 +211,7 @@ namespace RTSim {
         /// @param opp desired OPP [MHz and Volts]
         ///
         /// @returns the forshadowed power
-        speed_type lookupSpeed(const OPP &opp,
-                               const std::string &workload) const {
+        speed_type lookupSpeed(const OPP &opp, WorkloadId workload) const {
             return speed_model->lookupValue(opp, workload);
         }
 
@@ -241,7 +255,7 @@ namespace RTSim {
         // CPU
 
         /// Current workload class
-        wclass_type _workload = "idle";
+        WorkloadId _workload = WorkloadId::IDLE;
 
         /// The current OPP of the modeled CPU. Units are MHz and Volts.
         OPP _opp;
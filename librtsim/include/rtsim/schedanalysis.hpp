@@ -0,0 +1,167 @@
+// #pragma once
+
+#ifndef RTSIM_SCHEDANALYSIS_HPP
+#define RTSIM_SCHEDANALYSIS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// MetaSim
+#include <metasim/baseexc.hpp>
+
+namespace RTSim {
+
+    using namespace MetaSim;
+
+    /// \ingroup sched
+    ///
+    /// A set of sporadic tasks, stored as one array per parameter so that
+    /// the analyses scan contiguous memory. It does not depend on the
+    /// simulator: no entity is created and SIMUL is never used.
+    ///
+    /// Times are integer ticks, WCETs are at unit speed. A lower value of
+    /// priority means a higher priority; cpu is the index of the CPU the
+    /// task is assigned to, or NONE.
+    struct TaskArray {
+        static constexpr int NONE = -1;
+
+        std::vector<int64_t> wcet;
+        std::vector<int64_t> period;
+        std::vector<int64_t> dline;
+        std::vector<int> priority;
+        std::vector<int> cpu;
+
+        size_t size() const {
+            return wcet.size();
+        }
+
+        /// Adds a task. A non-positive deadline means deadline = period,
+        /// a negative priority means lower than all the previous tasks.
+        ///
+        /// @return the index of the task
+        size_t add(int64_t c, int64_t t, int64_t d = 0, int prio = -1,
+                   int core = NONE);
+
+        void clear();
+    };
+
+    /// \ingroup sched
+    ///
+    /// Offline schedulability tests on a TaskArray: utilization bounds,
+    /// response-time analysis for fixed priority, processor demand (QPA)
+    /// for EDF and partitioning heuristics.
+    ///
+    /// The tests take the CPU to analyze (TaskArray::NONE for all the
+    /// tasks, as on a single CPU) and its speed. At speed s the WCET of a
+    /// task becomes ceil(C / s), as for Task::getWCET(double).
+    ///
+    /// @code
+    /// TaskArray ts;
+    /// ts.add(20, 100);
+    /// ts.add(40, 150, 120);
+    /// bool edf = SchedAnalysis::isQPASchedulable(ts);
+    /// bool ok = SchedAnalysis::partition(ts, {1.0, 0.5},
+    ///                                    SchedAnalysis::Fit::FIRST);
+    /// @endcode
+    class SchedAnalysis {
+    public:
+        /// \ingroup sched
+        ///
+        /// Exceptions for the SchedAnalysis class.
+        class Exc : public BaseExc {
+        public:
+            Exc(const std::string message,
+                const std::string cl = "SchedAnalysis",
+                const std::string md = "schedanalysis.cpp") :
+                BaseExc(message, cl, md){};
+        };
+
+        enum class Policy { EDF, FP };
+
+        enum class Fit { FIRST, BEST, WORST };
+
+        typedef std::function<bool(const TaskArray &)> Test;
+
+        /// @return the sum of C/(s T) of the tasks on cpu
+        static double getUtilization(const TaskArray &ts,
+                                     int cpu = TaskArray::NONE,
+                                     double speed = 1.0);
+
+        /// @return the sum of C/(s min(D, T)) of the tasks on cpu
+        static double getDensity(const TaskArray &ts, int cpu = TaskArray::NONE,
+                                 double speed = 1.0);
+
+        /// Liu and Layland bound for rate monotonic, U <= n(2^(1/n) - 1)
+        static bool isLLSchedulable(const TaskArray &ts,
+                                    int cpu = TaskArray::NONE,
+                                    double speed = 1.0);
+
+        /// Hyperbolic bound for rate monotonic, prod(U_i + 1) <= 2
+        static bool isHyperbolicSchedulable(const TaskArray &ts,
+                                            int cpu = TaskArray::NONE,
+                                            double speed = 1.0);
+
+        /// Exact response-time analysis for fixed priority and
+        /// constrained deadlines, using TaskArray::priority (ties are
+        /// broken by index)
+        static bool isRTASchedulable(const TaskArray &ts,
+                                     int cpu = TaskArray::NONE,
+                                     double speed = 1.0);
+
+        /// @return the worst-case response time of task i on its CPU if
+        /// it does not exceed its deadline, otherwise a larger value
+        static int64_t getResponseTime(const TaskArray &ts, size_t i,
+                                       double speed = 1.0);
+
+        /// @return the processor demand of the tasks on cpu in [0, t]
+        static int64_t getDemand(const TaskArray &ts, int64_t t,
+                                 int cpu = TaskArray::NONE,
+                                 double speed = 1.0);
+
+        /// Exact processor-demand test for EDF (Quick convergence
+        /// Processor-demand Analysis, Zhang and Burns). Exact if the
+        /// utilization is clearly below or above 1; at (almost) full
+        /// utilization the busy period may be too long to be checked, and
+        /// the set is reported as not schedulable.
+        static bool isQPASchedulable(const TaskArray &ts,
+                                     int cpu = TaskArray::NONE,
+                                     double speed = 1.0);
+
+        /// Runs the exact test of the given policy
+        static bool isSchedulable(const TaskArray &ts, Policy policy,
+                                  int cpu = TaskArray::NONE,
+                                  double speed = 1.0);
+
+        /// Assigns the tasks to the CPUs, whose speeds are given, with the
+        /// given bin-packing heuristic; a CPU accepts a task if it
+        /// passes the exact test of the policy. Tasks are considered by
+        /// decreasing utilization if decreasing is true, otherwise in
+        /// index order. Tasks that fit nowhere are left on NONE.
+        ///
+        /// @return true if all the tasks have been assigned
+        static bool partition(TaskArray &ts, const std::vector<double> &speeds,
+                              Fit fit, Policy policy = Policy::EDF,
+                              bool decreasing = true);
+
+        /// @return the index of the first speed in speeds (e.g. the
+        /// speeds of the OPPs of an island, in increasing order) at which
+        /// the tasks on cpu are schedulable, or speeds.size()
+        static size_t getMinOPP(const TaskArray &ts, int cpu,
+                                const std::vector<double> &speeds,
+                                Policy policy = Policy::EDF);
+
+        /// Runs test on each set, with the given number of threads (0
+        /// means one per hardware thread). Exceptions raised by a test are
+        /// re-thrown here.
+        ///
+        /// @return the result of each test, in the order of sets
+        static std::vector<char> evaluate(const std::vector<TaskArray> &sets,
+                                          const Test &test,
+                                          unsigned int workers = 0);
+    };
+
+} // namespace RTSim
+
+#endif // RTSIM_SCHEDANALYSIS_HPP
@@ -4,6 +4,7 @@
 #include <map>
 #include <vector>
 
+#include <rtsim/fpanalysis.hpp>
 #include <rtsim/sporadicserver.hpp>
 #include <rtsim/supervisor.hpp>
 
@@ -66,6 +67,12 @@ namespace RTSim {
 
         int task;
 
+        // caches the scheduling points of each server
+        FPAnalysis analysis;
+
+        // scratch buffer of sensitivity()
+        u_row_t product;
+
         class ChangeBudgetEvt;
         friend class ChangeBudgetEvt;
         void onChangeBudget(ChangeBudgetEvt *e);
@@ -77,13 +84,20 @@ namespace RTSim {
 
         public:
             ChangeBudgetEvt(SchedPoint *s1, Server *s2, double b) :
-                Event("SchedPointChangeBudget"),
+                Event(typeName()),
                 sp(s1),
                 ss(s2),
                 budget(b) {}
             void doit() override {
                 sp->onChangeBudget(this);
             }
+
+            /// These events are disposable, the name is interned once
+            static const std::string *typeName() {
+                static const std::string *name =
+                    intern_string("SchedPointChangeBudget");
+                return name;
+            }
             Server *getServer() {
                 return ss;
             }
@@ -3,13 +3,19 @@
 
 #include <vector>
 
+#include <rtsim/fpanalysis.hpp>
 #include <rtsim/server.hpp>
 #include <rtsim/supervisor.hpp>
 
 namespace RTSim {
     using namespace MetaSim;
 
-    /** Naive implementation of the RTA test */
+    /**
+       Implementation of the RTA test. The response times are kept by an
+       FPAnalysis between budget changes, so that each request only
+       re-analyzes the server and the lower priority ones, starting from
+       the previous results.
+    */
     class SchedRTA : public Entity, public Supervisor {
     public:
         struct ServerInfo {
@@ -45,6 +51,9 @@ namespace RTSim {
 
         /**********************************************************/
 
+        // the servers in rate-monotonic order, as in servers
+        FPAnalysis analysis;
+
         // not implemented
 
         SchedRTA(const SchedRTA &);
@@ -83,8 +92,6 @@ namespace RTSim {
         void endRun() override;
 
         void updateResponseTimes();
-        Tick computeResponseTime(int i) const;
-        Tick searchBudget(int i, Tick b1, Tick b2);
         Tick searchBudget(int i);
         bool tryBudget(int i, Tick b);
     };
@@ -47,6 +47,7 @@ namespace RTSim {
 
             /// @todo: check the type
             void setPriority(Tick p) {
+                checkNotQueued();
                 _prio = p;
             }
 
@@ -10,10 +10,13 @@
 
 // RTSim
 // #include <rtsim/cpu.hpp>
+#include <rtsim/admission.hpp>
 #include <rtsim/mrtkernel.hpp>
 // #include <rtsim/scheduler/rrscheduler.hpp>
 #include <rtsim/scheduler/scheduler.hpp>
 
+#define _MULTISCHED_DBG_LEV "MultiSched"
+
 namespace RTSim {
     /// \ingroup sched
     ///
@@ -81,6 +84,10 @@ namespace RTSim {
         //     _active_utilizations;
         std::map<AbsRTTask *, CPU_Utilizations> _active_utilizations;
 
+        /// Utilization of the tasks in each CPU queue (running and ready),
+        /// kept up to date by insertTask() and removeFromQueue()
+        UtilizationTracker _utilizations;
+
         // =================================================
         // Constructors and Destructors
         // =================================================
@@ -190,6 +197,12 @@ namespace RTSim {
         /// Returns all non-running tasks on the given core
         std::vector<AbsRTTask *> getReadyTasks(CPU *cpu);
 
+        /// @return the utilization of the tasks in the core queues, for
+        /// admission tests
+        const UtilizationTracker &getUtilizationTracker() const {
+            return _utilizations;
+        }
+
         /// Add a task to the queue of a core.
         /// @todo there is something fishy here
         virtual void insertTask(AbsRTTask *task, CPU *cpu);
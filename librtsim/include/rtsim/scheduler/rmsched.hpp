@@ -47,6 +47,7 @@ namespace RTSim {
             }
 
             void changePriority(MetaSim::Tick p) override {
+                checkNotQueued();
                 if (p == _rtTask->getRelDline())
                     extP = false;
                 else {
@@ -14,6 +14,8 @@
 #ifndef __SCHEDULER_HPP__
 #define __SCHEDULER_HPP__
 
+#include <vector>
+
 #include <metasim/baseexc.hpp>
 #include <metasim/entity.hpp>
 #include <metasim/plist.hpp>
@@ -52,13 +54,57 @@ namespace RTSim {
        trees of the task models and of the schedulers are similar.
     */
     class TaskModel {
+    public:
+        /**
+           The position of a model in the ready queue: priority,
+           insertion time and task number, compared in this
+           order. It is computed when the model is inserted in
+           the queue, so that the queue only compares integers.
+        */
+        struct SortKey {
+            Tick::impl_t priority;
+            Tick::impl_t insertTime;
+            int taskNumber;
+
+            bool operator<(const SortKey &o) const {
+                if (priority != o.priority)
+                    return priority < o.priority;
+                if (insertTime != o.insertTime)
+                    return insertTime < o.insertTime;
+                return taskNumber < o.taskNumber;
+            }
+        };
+
     protected:
         AbsRTTask *_rtTask;
         bool active;
-        int _insertTime;
         // [[deprecated]] int _threshold;
         // [[deprecated]] Tick _savedPriority;
 
+    private:
+        SortKey _key;
+
+        /// true while the model is in the ready queue
+        bool _queued;
+
+        /**
+           Recomputes the sort key with the current priority and
+           the given insertion time. Throws an exception if the
+           model is in the ready queue, because changing the key
+           there would break the ordering of the queue.
+        */
+        void refreshKey(Tick insertTime);
+
+        friend class Scheduler;
+
+    protected:
+        /**
+           Throws an exception if the model is in the ready queue.
+           Models call it before changing their priority, which
+           must happen only while they are out of the queue.
+        */
+        void checkNotQueued() const;
+
     public:
         TaskModel(AbsRTTask *t);
         virtual ~TaskModel();
@@ -74,7 +120,8 @@ namespace RTSim {
         /// Returns the task's preemption level. It depends on the scheduler
         // virtual Tick getPreemptionLevel() const = 0;
 
-        /// Changes the task's priority. It depends on the scheduler
+        /// Changes the task's priority. It depends on the scheduler.
+        /// The model must not be in the ready queue.
         virtual void changePriority(Tick p) = 0;
 
     public:
@@ -146,18 +193,22 @@ namespace RTSim {
         bool isActive();
 
         /**
-           Set the insertion time. Used to control the order
-           between two tasks with the same priority.
+           Returns the insertion time, used to control the order
+           between two tasks with the same priority. It is set by
+           the scheduler when the model is inserted in the queue.
         */
-        void setInsertTime(Tick t) {
-            _insertTime = t;
+        Tick getInsertTime() const {
+            return _key.insertTime;
         }
 
-        /**
-           Returns the insertion time.
-        */
-        Tick getInsertTime() {
-            return _insertTime;
+        /// Returns the sort key computed at the last insertion.
+        const SortKey &getKey() const {
+            return _key;
+        }
+
+        /// Tells whether the model is in the ready queue.
+        bool isQueued() const {
+            return _queued;
         }
 
         class TaskModelCmp {
@@ -170,7 +221,7 @@ namespace RTSim {
 
                - when 2 tasks have the same priority (i.e. deadline in
                EDF*), then the priority is decided basing upon the
-               insertion time (see setInsertTime() method).
+               insertion time (see getInsertTime() method).
 
                - when 2 tasks have the same priority and the same
                insertion time, then the priority is decided based
@@ -189,6 +240,11 @@ namespace RTSim {
                By using the slice time, it is possible to implement
                the SCHED_RR policy of POSIX, by using a fixed
                priority, and setting the slice time for each task.
+
+               The comparison uses the sort keys (see getKey()), so
+               a change of priority (e.g., the postponement of a
+               server deadline) is only seen by the queue when the
+               model is inserted again.
             */
             bool operator()(TaskModel *a, TaskModel *b) const;
         };
@@ -297,6 +353,15 @@ namespace RTSim {
         /** returns the priority of the task */
         int getPriority(AbsRTTask *task) const; // throw(RTSchedExc);
 
+        /**
+         * Returns the position of the task in the ready queue,
+         * i.e. the sort key computed when it was last inserted
+         * (see TaskModel::getKey()). Global kernels use it to
+         * compare tasks with the same order as the queue. Throws
+         * an exception if the task does not exist.
+         */
+        const TaskModel::SortKey &getSortKey(AbsRTTask *task) const;
+
         /** raises the threshold of the task */
         // [[deprecated]] void enableThreshold(AbsRTTask *t);
         // throw(RTSchedExc);
@@ -336,9 +401,17 @@ namespace RTSim {
         /**
          *  returns the (n+1)-th (0==first) task in the queue
          *  or NULL if the queue has less than n+1 elements.
+         *  Takes O(log n) time.
          */
         AbsRTTask *getTaskN(unsigned int);
 
+        /**
+         *  Appends to v the first m tasks in the queue (or all of
+         *  them, if there are less than m), in order. Cheaper
+         *  than calling getTaskN() m times.
+         */
+        void getTopTasks(unsigned int m, std::vector<AbsRTTask *> &v) const;
+
         static AbsRTTask *getTaskFromModel(TaskModel *model) {
             return model->getTask();
         }
@@ -368,7 +441,8 @@ namespace RTSim {
         };
 
         using TaskIt = ViewIt<
-            priority_list<TaskModel *, TaskModel::TaskModelCmp>::const_iterator,
+            indexed_priority_list<TaskModel *,
+                                  TaskModel::TaskModelCmp>::const_iterator,
             decltype(getTaskFromModel)>;
 
         using TheTaskList = TaskList<TaskIt, TaskIt>;
@@ -402,18 +476,32 @@ namespace RTSim {
         /// pointer to the kernel
         AbsKernel *_kernel;
 
-        /// priority queue, ordered by a TaskModelCmp
-        priority_list<TaskModel *, TaskModel::TaskModelCmp> _queue;
+        /// priority queue, ordered by a TaskModelCmp, with rank access
+        indexed_priority_list<TaskModel *, TaskModel::TaskModelCmp> _queue;
 
-        /// map between tasks and models
+        /// map between tasks and models; each task also has a handle to
+        /// its model (see find()), so this is mostly used to iterate
         std::map<AbsRTTask *, TaskModel *> _tasks;
 
         /// current executing task
         AbsRTTask *_currExe;
 
+        /// unique id of this scheduler, the key of the handles stored
+        /// in the tasks
+        const uint64_t _schedId;
+
         // stores the old task priorities
         std::map<AbsRTTask *, int> oldPriorities;
 
+        /**
+           Inserts the model in the ready queue, with the current
+           time as insertion time.
+        */
+        void enqueue(TaskModel *model);
+
+        /// Removes the model from the ready queue.
+        void dequeue(TaskModel *model);
+
         /**
            This is the internal version of the addTask, it
            enqueues a model and adds the corresponding task to
@@ -424,7 +512,8 @@ namespace RTSim {
         /**
          * This function returns a TaskModel from a task. It is
          * used mainly inside this class, but it can also be
-         * used by some resource manager. */
+         * used by some resource manager. It takes constant time,
+         * through the handle stored in the task by enqueueModel(). */
         TaskModel *find(AbsRTTask *task) const;
 
         /// @todo change it into ResManager
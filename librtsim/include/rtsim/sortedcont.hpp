@@ -87,6 +87,14 @@ namespace RTSim {
             return _container.cend();
         }
 
+        bool empty() const {
+            return _container.empty();
+        }
+
+        size_type size() const {
+            return _container.size();
+        }
+
     private:
         std::vector<V> _container;
         const Comp _less;
@@ -119,13 +119,20 @@ namespace RTSim {
 
         public:
             ChangeBudgetEvt(SparePot *s1, SporadicServer *s2, Tick b) :
-                Event("SparePotChangeBudget", EndEvt::_END_EVT_PRIORITY + 4),
+                Event(typeName(), EndEvt::_END_EVT_PRIORITY + 4),
                 sp(s1),
                 ss(s2),
                 budget(b) {}
             void doit() override {
                 sp->onChangeBudget(this);
             }
+
+            /// These events are disposable, the name is interned once
+            static const std::string *typeName() {
+                static const std::string *name =
+                    intern_string("SparePotChangeBudget");
+                return name;
+            }
             SporadicServer *getServer() {
                 return ss;
             }
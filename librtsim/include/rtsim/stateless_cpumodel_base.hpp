@@ -15,12 +15,14 @@ email                : gabriele.ara@santannapisa.it, gabriele.ara@live.it
 #define __STATELESS_BASE_HPP__
 
 #include <limits>
+#include <stdexcept>
 #include <string>
 
 #include <metasim/cloneable.hpp>
 #include <metasim/memory.hpp>
 #include <rtsim/class_utils.hpp>
 #include <rtsim/opp.hpp>
+#include <rtsim/workload.hpp>
 
 namespace RTSim {
     // Forward declarations
@@ -58,6 +60,38 @@ namespace RTSim {
         using value_type = speed_type;
     };
 
+    // =========================================================================
+    // FreezableModel
+    // =========================================================================
+
+    /// Common (virtual) base of the models and of their parameter maps
+    /// (see ParametrizedModel and TableBasedModel), so that they share a
+    /// single flag. A model is frozen once it is attached to a CPUIsland,
+    /// which caches its values from then on: changing its parameters
+    /// afterwards is an error.
+    class FreezableModel {
+    public:
+        /// Forbids any further change of the parameters of the model
+        void freeze() {
+            _frozen = true;
+        }
+
+        bool isFrozen() const {
+            return _frozen;
+        }
+
+    protected:
+        /// Throws std::logic_error if the model is frozen
+        void checkNotFrozen() const {
+            if (_frozen)
+                throw std::logic_error(
+                    "Cannot change the parameters of a frozen CPU model");
+        }
+
+    private:
+        bool _frozen = false;
+    };
+
     // =========================================================================
     // StatelessCPUModel
     // =========================================================================
@@ -68,7 +102,7 @@ namespace RTSim {
     /// implement stateless CPU models, for either Power or Speed (each needs a
     /// separate class implementation, templates can help with that)
     template <ModelType model_type>
-    class StatelessCPUModel {
+    class StatelessCPUModel : public virtual FreezableModel {
     public:
         using value_type =
             typename ModelTypeToValueType<model_type>::value_type;
@@ -119,12 +153,11 @@ namespace RTSim {
         /// selected for the current cpu.
         ///
         /// @param opp the OPP to select
-        /// @param workload the workload class of the task
+        /// @param workload the (interned) workload class of the task
         /// @param f_max the maximum frequency that could be set
         ///
         /// @returns the forshadowed value
-        virtual value_type lookupValue(const OPP &opp,
-                                       const wclass_type &workload,
+        virtual value_type lookupValue(const OPP &opp, WorkloadId workload,
                                        freq_type f_max = FREQ_MAX) const = 0;
     };
 
@@ -151,7 +184,7 @@ namespace RTSim {
         CLONEABLE(base_type, cls_name, override);                              \
                                                                                \
         virtual value_type                                                     \
-            lookupValue(const OPP &opp, const wclass_type &workload,           \
+            lookupValue(const OPP &opp, WorkloadId workload,                   \
                         freq_type f_max = FREQ_MAX) const override;            \
     }
 
@@ -91,16 +91,16 @@ namespace RTSim {
     template <>
     BPCPUModel<ModelType::Power>::value_type
         BPCPUModel<ModelType::Power>::lookupValue(const OPP &opp,
-                                                  const wclass_type &workload,
+                                                  WorkloadId workload,
                                                   freq_type) const {
         // This model was trained using frequencies in KHz
         const freq_type f = opp.frequency * 1000;
         const volt_type v = opp.voltage;
 
-        auto i = findParams(workload);
-        if (!foundParams(i)) {
+        auto params = findParams(workload);
+        if (params == nullptr) {
             // FALLBACK: see also below
-            i = findParams("idle");
+            params = findParams(WorkloadId::IDLE);
 
             // FIXME: if using setVoltage and setFrequency
             // independently, this exception may be
@@ -110,14 +110,13 @@ namespace RTSim {
             // throw std::exception{};
         }
 
-        const auto params = getParams(i);
         double K, eta, gamma, disp;
         double P_charge, P_short, P_dyn, P_leak;
 
-        disp = params.d;
-        K = params.k;
-        eta = params.e;
-        gamma = params.g;
+        disp = params->d;
+        K = params->k;
+        eta = params->e;
+        gamma = params->g;
 
         // Evaluation of the P_charge
         P_charge = K * f * (v * v);
@@ -138,23 +137,22 @@ namespace RTSim {
     template <>
     BPCPUModel<ModelType::Speed>::value_type
         BPCPUModel<ModelType::Speed>::lookupValue(const OPP &opp,
-                                                  const wclass_type &workload,
+                                                  WorkloadId workload,
                                                   freq_type) const {
         // This model was trained using frequencies in KHz
         const freq_type f = opp.frequency * 1000;
         const volt_type v = opp.voltage;
 
-        auto i = findParams(workload);
-        if (!foundParams(i)) {
-            i = findParams("idle");
+        auto params = findParams(workload);
+        if (params == nullptr) {
+            params = findParams(WorkloadId::IDLE);
             // throw std::exception{};
         }
-        const auto params = getParams(i);
 
-        long double disp = params.a;
-        long double ideal = params.b / static_cast<long double>(f);
+        long double disp = params->a;
+        long double ideal = params->b / static_cast<long double>(f);
         long double slope =
-            params.c * std::exp(-(static_cast<long double>(f) / params.d));
+            params->c * std::exp(-(static_cast<long double>(f) / params->d));
 
         return 1.0 / (disp + ideal + slope);
     }
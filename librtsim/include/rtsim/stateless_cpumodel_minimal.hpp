@@ -47,7 +47,7 @@ namespace RTSim {
     template <>
     MinimalCPUModel<ModelType::Power>::value_type
         MinimalCPUModel<ModelType::Power>::lookupValue(const OPP &opp,
-                                                       const wclass_type &,
+                                                       WorkloadId,
                                                        freq_type) const {
         return (opp.voltage * opp.voltage) * opp.frequency;
     }
@@ -55,7 +55,7 @@ namespace RTSim {
     template <>
     MinimalCPUModel<ModelType::Speed>::value_type
         MinimalCPUModel<ModelType::Speed>::lookupValue(const OPP &opp,
-                                                       const wclass_type &,
+                                                       WorkloadId,
                                                        freq_type f_max) const {
         return speed_type(f_max) / speed_type(opp.frequency);
     }
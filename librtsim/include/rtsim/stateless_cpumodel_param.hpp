@@ -14,6 +14,8 @@ email                : gabriele.ara@santannapisa.it, gabriele.ara@live.it
 #ifndef __STATELESSMODELS_PARAM_HPP__
 #define __STATELESSMODELS_PARAM_HPP__
 
+#include <vector>
+
 #include <rtsim/stateless_cpumodel_base.hpp>
 
 namespace RTSim {
@@ -25,30 +27,18 @@ namespace RTSim {
     // class. To accomplish this, inherit this class thanks to multiple
     // inheritance features of C++.
 
-    /// Simple implementation of a key-value map of parameters
+    /// Simple implementation of a key-value map of parameters, indexed by
+    /// the interned workload class
     template <class params_type>
-    class ParametrizedModel {
-    protected:
-        using map_type = std::map<wclass_type, params_type>;
-        using iter_type = typename map_type::iterator;
-        using citer_type = typename map_type::const_iterator;
-
+    class ParametrizedModel : public virtual FreezableModel {
     public:
-        /// @returns a const iterator to the params associated with the given
-        /// workload, if any. Use foundParams to check whether the params were
-        /// found or not
-        citer_type findParams(const wclass_type &workload) const {
-            return _params.find(workload);
-        }
-
-        /// @returns true if the iterator is "valid"
-        bool foundParams(const citer_type &i) const {
-            return i != _params.cend();
-        }
-
-        /// @returns the params from a "valid" iterator
-        const params_type &getParams(const citer_type &i) const {
-            return i->second;
+        /// @returns a pointer to the params associated with the given
+        /// workload, or nullptr if there are none
+        const params_type *findParams(WorkloadId workload) const {
+            const auto i = workload.index();
+            if (i >= _found.size() || !_found[i])
+                return nullptr;
+            return &_params[i];
         }
 
     protected:
@@ -58,13 +48,25 @@ namespace RTSim {
         /// is added to the set of supported workload classes
         /// @param params the parameters used to calculate the estimated
         /// value
+        ///
+        /// @throws std::logic_error if the model is frozen
         void setParams(const wclass_type &workload, const params_type &params) {
-            _params[workload] = params;
+            checkNotFrozen();
+            const auto i = WorkloadId(workload).index();
+            if (i >= _params.size()) {
+                _params.resize(i + 1);
+                _found.resize(i + 1, false);
+            }
+            _params[i] = params;
+            _found[i] = true;
         }
 
     private:
-        /// Stores all associations between workload classes and params
-        map_type _params;
+        /// Stores the params of each workload class, by index
+        std::vector<params_type> _params;
+
+        /// Whether each workload class has its params
+        std::vector<bool> _found;
     };
 
 } // namespace RTSim
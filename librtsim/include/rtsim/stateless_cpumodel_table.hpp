@@ -14,7 +14,7 @@ email                : gabriele.ara@santannapisa.it, gabriele.ara@live.it
 #ifndef __STATELESSMODELS_TABLE_HPP__
 #define __STATELESSMODELS_TABLE_HPP__
 
-#include <map>
+#include <vector>
 
 #include <rtsim/interpolate.hpp>
 #include <rtsim/stateless_cpumodel_base.hpp>
@@ -41,7 +41,7 @@ namespace RTSim {
     /// Simple implementation of a table-based map of parameters.
     /// The two values needed to get the params are a valid OPP and workload.
     template <class value_type>
-    class TableBasedModel {
+    class TableBasedModel : public virtual FreezableModel {
     protected:
         using mapping = std::pair<OPP, value_type>;
 
@@ -49,8 +49,9 @@ namespace RTSim {
             sorted_map<OPP, value_type,
                        less_pair<OPP, value_type, OPPLessSortByFrequencyOnly>>;
 
-        using map_map = std::map<std::string, smap>;
-        using map_map_citer = typename map_map::const_iterator;
+        /// One map per workload class, by index; empty maps are missing
+        /// workload classes
+        using map_map = std::vector<smap>;
 
     protected:
         /// Sets the parameters for the given workload class
@@ -59,60 +60,67 @@ namespace RTSim {
         /// added to the set of supported workload classes
         /// @param expected_value the parameters used to calculate the estimated
         /// value
+        ///
+        /// @throws std::logic_error if the model is frozen
         void setParams(const OPP &opp, const wclass_type &workload,
                        const value_type &expected_value) {
+            checkNotFrozen();
             mapping kv = std::make_pair(opp, expected_value);
-            _map[workload].insert(kv);
+            const auto i = WorkloadId(workload).index();
+            if (i >= _map.size())
+                _map.resize(i + 1);
+            _map[i].insert(kv);
+        }
+
+        inline const smap *find_map(WorkloadId workload) const {
+            const auto i = workload.index();
+            if (i >= _map.size() || _map[i].empty())
+                return nullptr;
+            return &_map[i];
         }
 
-        inline map_map_citer
-            find_suitable_map(const wclass_type &workload) const {
+        inline const smap *find_suitable_map(WorkloadId workload) const {
             // First look for the good workload
-            auto res = _map.find(workload);
-            if (res != _map.cend())
+            auto res = find_map(workload);
+            if (res)
                 return res;
 
             // TODO: WARN WHEN A WORKLOAD IS NOT FOUND!!!
 
             // If not found, use one of the following fallbacks
-            const wclass_type fallbacks[2] = {{"busy"}, {"idle"}};
-            for (auto key : fallbacks) {
-                res = _map.find(key);
-                if (res != _map.cend())
-                    return res;
-            }
-            return _map.cend();
+            res = find_map(WorkloadId::BUSY);
+            if (res)
+                return res;
+            return find_map(WorkloadId::IDLE);
         }
 
-        inline value_type exact_map_lookup(const smap &map, const OPP &key,
-                                           const wclass_type &workload) const {
+        inline value_type exact_map_lookup(const smap &map,
+                                           const OPP &key) const {
             auto res = map.find_from_key(key);
             if (res == map.cend())
                 return 0;
             return res->second;
         }
 
-        inline value_type
-            exact_table_lookup(const OPP &opp,
-                               const wclass_type &workload) const {
+        inline value_type exact_table_lookup(const OPP &opp,
+                                             WorkloadId workload) const {
             auto res_map = find_suitable_map(workload);
-            if (res_map == _map.end())
+            if (res_map == nullptr)
                 return 0;
 
-            auto &map = res_map->second;
-            return exact_map_lookup(map, opp, workload);
+            return exact_map_lookup(*res_map, opp);
         }
 
         template <class Distance_fn>
         inline value_type approx_table_lookup(const OPP &opp,
-                                              const wclass_type &workload,
+                                              WorkloadId workload,
                                               Distance_fn distance) const {
             // The beginning is the same as the exact table lookup
             const auto res_map = find_suitable_map(workload);
-            if (res_map == _map.end())
+            if (res_map == nullptr)
                 return 0;
 
-            auto &map = res_map->second;
+            auto &map = *res_map;
             // However, we do a simple index lookup now
             auto res = map.first_non_less_key(opp);
             if (res == map.cend()) {
@@ -74,7 +74,7 @@ namespace RTSim {
     template <ModelType model_type>
     typename TBCPUModel<model_type>::value_type
         TBCPUModel<model_type>::lookupValue(const OPP &opp,
-                                            const wclass_type &workload,
+                                            WorkloadId workload,
                                             freq_type) const {
         using value_type = typename TBCPUModel<model_type>::value_type;
 
@@ -59,7 +59,7 @@ namespace RTSim {
     template <ModelType model_type>
     typename TBApproxCPUModel<model_type>::value_type
         TBApproxCPUModel<model_type>::lookupValue(const OPP &opp,
-                                                  const wclass_type &workload,
+                                                  WorkloadId workload,
                                                   freq_type) const {
         // FIXME: measurement units!!!
         // OPP opp_copy = opp;
@@ -58,13 +58,20 @@ namespace RTSim {
 
         public:
             ChangeBudgetEvt(SuperCBS *s1, Server *s2, double b) :
-                Event("SuperCBSChangeBudget"),
+                Event(typeName()),
                 sp(s1),
                 ss(s2),
                 budget(b) {}
             void doit() override {
                 sp->onChangeBudget(this);
             }
+
+            /// These events are disposable, the name is interned once
+            static const std::string *typeName() {
+                static const std::string *name =
+                    intern_string("SuperCBSChangeBudget");
+                return name;
+            }
             Server *getServer() {
                 return ss;
             }
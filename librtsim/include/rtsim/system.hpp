@@ -8,6 +8,9 @@
 #include <metasim/memory.hpp>
 #include <vector>
 
+#include <metasim/simcontext.hpp>
+#include <metasim/tick.hpp>
+
 // Static system information
 #include <rtsim/cpu.hpp>
 #include <rtsim/kernel.hpp>
@@ -42,6 +45,11 @@ namespace RTSim {
     class System {
         // TODO: hide?
     public:
+        /// For the parallel execution, the context of each CPU, in the
+        /// same order as cpus; empty otherwise. Declared first, since the
+        /// contexts must outlive the entities created in them
+        std::vector<sptr<MetaSim::SimulationContext>> contexts;
+
         std::vector<sptr<CPUModel>> cpu_models;
         std::vector<sptr<CPUIsland>> islands;
         std::vector<sptr<CPU>> cpus;
@@ -50,7 +58,27 @@ namespace RTSim {
         std::vector<sptr<RTKernel>> kernels;
 
     public:
-        System(const std::string &fname);
+        /// With parallel set, each CPU of the system gets its own
+        /// SimulationContext, where its kernel and its scheduler are
+        /// created (the island belongs to the context of its first CPU),
+        /// and run() executes each CPU on its own thread. All the islands
+        /// must be partitioned.
+        System(const std::string &fname, bool parallel = false);
+
+        /// @returns the context where the entities of the given CPU (e.g.
+        /// the tasks placed on it) must be created: its own one with the
+        /// parallel execution, the current one otherwise
+        MetaSim::SimulationContext &getContext(size_t cpu) const;
+
+        /// Executes a single run of the given duration, with
+        /// MetaSim::PartitionedRunner for the parallel execution.
+        ///
+        /// The partitions must never interact: the CPUs must not share
+        /// resources, nor change the OPP of their island, and traces
+        /// must not be shared among CPUs. Then, each kernel executes
+        /// the same events as in a sequential run, so the statistics of
+        /// its tasks are the same.
+        void run(MetaSim::Tick duration);
     };
 
     // TODO:
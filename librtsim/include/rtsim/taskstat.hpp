@@ -65,7 +65,7 @@ namespace RTSim {
                 descTime = e.getLastTime();
                 count++;
             }
-            if (e.getLastTime() < Measure::_transitory)
+            if (e.getLastTime() < Measure::getTransitory())
                 count = 0;
         }
 
@@ -74,7 +74,7 @@ namespace RTSim {
                 schedTime = e.getLastTime();
             else
                 count--;
-            if (e.getLastTime() < Measure::_transitory)
+            if (e.getLastTime() < Measure::getTransitory())
                 count = 0;
         }
 
@@ -114,14 +114,14 @@ namespace RTSim {
         }
 
         void probe(const SchedEvt &se) {
-            if (SIMUL.getTime() < _transitory)
+            if (SIMUL.getTime() < getTransitory())
                 return;
             if (se.getTime() == descTime && se.getTask()->getID() == idDesched)
                 record(-1);
         }
 
         void probe(const DeschedEvt &de) {
-            if (SIMUL.getTime() < _transitory)
+            if (SIMUL.getTime() < getTransitory())
                 return;
             descTime = SIMUL.getTime();
             idDesched = de.getTask()->getID();
@@ -159,7 +159,7 @@ namespace RTSim {
         FinishingTimeStat(string name = "") : Measure(name){};
 
         void probe(const EndEvt &ee) {
-            if (ee.getLastTime() < Measure::_transitory)
+            if (ee.getLastTime() < Measure::getTransitory())
                 return;
             Task *t = ee.getTask();
             Measure::record(ee.getLastTime() - t->getLastArrival());
@@ -186,7 +186,7 @@ namespace RTSim {
         LatenessStat(string name = "") : Measure(name){};
 
         void probe(const EndEvt &ee) {
-            if (ee.getLastTime() < Measure::_transitory)
+            if (ee.getLastTime() < Measure::getTransitory())
                 return;
 
             Task *t = ee.getTask();
@@ -221,7 +221,7 @@ namespace RTSim {
         TardinessStat(string name = "") : Measure(name){};
 
         void probe(const EndEvt &ee) {
-            if (ee.getLastTime() < Measure::_transitory)
+            if (ee.getLastTime() < Measure::getTransitory())
                 return;
 
             Task *t = (Task *) ee.getTask();
@@ -249,7 +249,7 @@ namespace RTSim {
         UtilizationStat(string name = "") : Measure(name){};
 
         void probe(const EndEvt &ee) {
-            if (ee.getLastTime() < Measure::_transitory)
+            if (ee.getLastTime() < Measure::getTransitory())
                 return;
 
             Task *t = (Task *) ee.getTask();
@@ -277,7 +277,7 @@ namespace RTSim {
         MissPercentage(string name = "") : StatPercent(name){};
 
         void probe(const EndEvt &ee) {
-            if (ee.getLastTime() < _transitory)
+            if (ee.getLastTime() < getTransitory())
                 return;
 
             Task *task = (Task *) ee.getTask();
@@ -338,8 +338,7 @@ namespace RTSim {
         }
 
         virtual void probe(const MetaSim::GEvent<Timer> &e) {
-            Measure::record(cpu->getCurrentPowerConsumption() /
-                            cpu->getMaxPowerConsumption());
+            Measure::record(cpu->getPower() / cpu->getPowerMax());
         }
     };
 
@@ -1,208 +1,356 @@
+#ifndef __RTSIM_THERMALMODEL_HPP__
+#define __RTSIM_THERMALMODEL_HPP__
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
 #include <Eigen/Dense>
 #include <unsupported/Eigen/MatrixFunctions>
-#include <vector>
 
-class ThermalModel {
-public:
-    using scalar_type = double;
-
-private:
-    static_assert(
-        std::numeric_limits<scalar_type>::has_infinity,
-        "The type of scalar_type must be a type with an infinity value!");
-
-    size_t n_cpus;
-
-    using Matrix = Eigen::Matrix<scalar_type, Eigen::Dynamic, Eigen::Dynamic>;
-    using Vector = Eigen::Matrix<scalar_type, Eigen::Dynamic, 1>;
-
-    Matrix MatrixA() {
-        return Matrix(n_cpus, n_cpus);
-    }
-
-    Matrix MatrixB() {
-        return Matrix(n_cpus, n_cpus + 1);
-    }
-
-    Vector VectorA() {
-        return Vector(n_cpus);
-    }
-
-    Vector VectorB() {
-        return Vector(n_cpus + 1);
-    }
-};
-
-template <size_t n_cpus_, class scalar_type_ = double>
-class ThermalModel {
-public:
-    using scalar_type = scalar_type_;
-    static constexpr size_t n_cpus = n_cpus_;
-
-private:
-    static_assert(
-        std::numeric_limits<scalar_type>::has_infinity,
-        "The type of scalar_type must be a type with an infinity value!");
-
-private:
-    template <size_t rows, size_t cols>
-    using Matrix = Eigen::Matrix<scalar_type, rows, cols>;
-
-    template <size_t rows>
-    using Vector = Matrix<rows, 1>;
-
-public:
-    using MatrixA = Matrix<n_cpus, n_cpus>;
-    using MatrixB = Matrix<n_cpus, n_cpus + 1>;
-    using VectorA = Vector<n_cpus>;
-    using VectorB = Vector<n_cpus + 1>;
-
-private:
-    // The two matrices that drive the model
-    MatrixA A;
-    MatrixB B;
-
-    // Current input and initial condition
-    scalar_type t0{0};
-    VectorA T0 = VectorA::Zero();
-    VectorB U = VectorB::Zero();
-
-    // Other useful values to cache to optimize computation time
-    MatrixA I = MatrixA::Identity();
-    MatrixA Ainv;
-    VectorA BU;
-
-    // Builds the matrix A starting from the parameters
-    MatrixA matrix_A(double C, double Re, const MatrixA R) {
-        constexpr scalar_type inf =
-            std::numeric_limits<scalar_type>::infinity();
-
-        MatrixA Rcopy = R;
-        Rcopy.diagonal().array() = inf;
-
-        // Sum of the inverse of the values on each row
-        VectorA Rsums = Rcopy.cwiseInverse().rowwise().sum();
+namespace RTSim {
+
+    /// Thermal RC model of an island with n_cpus_ cores:
+    ///
+    ///     dT/dt = A * T + B * U
+    ///
+    /// where T are the temperatures of the cores and U holds their power
+    /// consumption followed by the environment temperature.
+    ///
+    /// The input is constant between two calls to input(), hence the
+    /// model is advanced with its discretization over each interval dt:
+    ///
+    ///     T(t + dt) = A_d(dt) * T(t) + B_d(dt) * U
+    ///     A_d(dt)   = exp(A * dt)
+    ///     B_d(dt)   = A^(-1) * (A_d(dt) - I) * B
+    ///
+    /// A_d and B_d are cached for each distinct dt (up to cacheSize()
+    /// entries), since a simulation usually advances the model by a few
+    /// recurring amounts of time. Once the cache is full, dt is split into
+    /// powers of two of quantum(), whose matrices are computed once by
+    /// squaring; the remainder (if any) is computed without caching.
+    ///
+    /// The temperatures are advanced lazily: advance() only records the
+    /// current time, the model is actually propagated when the
+    /// temperatures are queried or the input changes.
+    ///
+    /// Use a fixed number of cores (e.g. ThermalModel<4> for each island
+    /// of a big.LITTLE board) to keep all the matrices on the stack with
+    /// vectorized products, ThermalModel<> (i.e. Eigen::Dynamic) when the
+    /// number of cores is known only at run time.
+    ///
+    /// @code
+    /// ThermalModel<4> model(C, Re, R);
+    /// model.initial(T0).input(P, Te);
+    /// model.advance(0.005);
+    /// model.input(P2, Te); // propagated up to 0.005 s here
+    /// model.advance(0.010);
+    /// std::vector<double> T = model.curtemp();
+    /// @endcode
+    template <int n_cpus_ = Eigen::Dynamic, class scalar_type_ = double>
+    class ThermalModel {
+    public:
+        using scalar_type = scalar_type_;
+        static constexpr int n_cpus = n_cpus_;
+
+    private:
+        static_assert(
+            std::numeric_limits<scalar_type>::has_infinity,
+            "The type of scalar_type must be a type with an infinity value!");
+
+    private:
+        template <int rows, int cols>
+        using Matrix = Eigen::Matrix<scalar_type, rows, cols>;
+
+        template <int rows>
+        using Vector = Matrix<rows, 1>;
+
+        // One more column for the environment temperature
+        static constexpr int n_inputs =
+            n_cpus == Eigen::Dynamic ? Eigen::Dynamic : n_cpus + 1;
+
+    public:
+        using MatrixA = Matrix<n_cpus, n_cpus>;
+        using MatrixB = Matrix<n_cpus, n_inputs>;
+        using VectorA = Vector<n_cpus>;
+        using VectorB = Vector<n_inputs>;
+
+    private:
+        /// Discretization of the model over a given interval
+        struct Step {
+            MatrixA Ad;
+            MatrixB Bd;
+        };
+
+        // The two matrices that drive the model
         MatrixA A;
+        MatrixB B;
+
+        // Current input and the temperatures at time t0
+        scalar_type t0{0};
+        VectorA T0;
+        VectorB U;
+
+        // Time of the last advance(), the temperatures are propagated up to
+        // it only when needed
+        scalar_type t1{0};
+
+        // Other useful values to cache to optimize computation time
+        MatrixA I;
+        MatrixA Ainv;
+
+        // Discretizations for each distinct dt
+        std::unordered_map<scalar_type, Step> steps;
+        size_t max_steps = 64;
+
+        // Discretizations over quantum * 2^k, for each k
+        scalar_type q{0};
+        std::vector<Step> pow2;
+
+        // Builds the matrix A starting from the parameters
+        static MatrixA matrix_A(scalar_type C, scalar_type Re,
+                                const MatrixA &R) {
+            constexpr scalar_type inf =
+                std::numeric_limits<scalar_type>::infinity();
+            const Eigen::Index n = R.rows();
+
+            MatrixA Rcopy = R;
+            Rcopy.diagonal().array() = inf;
+
+            // Sum of the inverse of the values on each row
+            VectorA Rsums = Rcopy.cwiseInverse().rowwise().sum();
+            MatrixA A(n, n);
+
+            for (Eigen::Index r = 0; r < n; ++r) {
+                for (Eigen::Index c = 0; c < n; ++c) {
+                    if (r == c) {
+                        A(r, c) = -1. / Re - Rsums(r);
+                    } else {
+                        A(r, c) = 1 / R(r, c);
+                    }
+                }
+            }
+            A /= C;
+            return A;
+        }
+
+        // Builds the matrix B from the two parameters
+        static MatrixB matrix_B(scalar_type C, scalar_type Re,
+                                Eigen::Index n) {
+            MatrixB B(n, n + 1);
+            B.leftCols(n).setIdentity();
+            B.rightCols(1) = VectorA::Constant(n, 1 / Re);
+            B /= C;
+            return B;
+        }
+
+    public:
+        /// R is the n_cpus x n_cpus matrix of the thermal resistances
+        /// between the cores (only for a fixed number of cores)
+        ThermalModel(scalar_type C, scalar_type Re, const scalar_type *R) :
+            ThermalModel(C, Re, MatrixA(Eigen::Map<const MatrixA>(R))) {}
+
+        ThermalModel(scalar_type C, scalar_type Re,
+                     const std::vector<scalar_type> &R) :
+            ThermalModel(C, Re, from_square(R)) {}
+
+        ThermalModel(scalar_type C, scalar_type Re, const MatrixA &R) :
+            A(matrix_A(C, Re, R)),
+            B(matrix_B(C, Re, R.rows())),
+            T0(VectorA::Zero(R.rows())),
+            U(VectorB::Zero(R.rows() + 1)),
+            I(MatrixA::Identity(R.rows(), R.rows())),
+            Ainv(A.inverse()) {}
+
+        /// @returns the number of cores
+        Eigen::Index cpus() const {
+            return A.rows();
+        }
+
+        ThermalModel &initial(scalar_type t0_, const VectorA &T0_) {
+            assert(T0_.size() == cpus());
+            t0 = t1 = t0_;
+            T0 = T0_;
+            return *this;
+        }
+
+        ThermalModel &initial(scalar_type t0, const scalar_type *T0_) {
+            // NOTE: this assumes that T0 is the correct size!
+            return initial(t0, VectorA(Eigen::Map<const VectorA>(T0_, cpus())));
+        }
+
+        ThermalModel &initial(scalar_type t0,
+                              const std::vector<scalar_type> &T0_) {
+            assert(T0_.size() == size_t(cpus()));
+            return initial(t0, T0_.data());
+        }
+
+        ThermalModel &initial(const VectorA &T0_) {
+            return initial(0, T0_);
+        }
+
+        ThermalModel &initial(const scalar_type *T0_) {
+            // NOTE: this assumes that T0 is the correct size!
+            return initial(0, T0_);
+        }
+
+        ThermalModel &initial(const std::vector<scalar_type> &T0_) {
+            return initial(0, T0_);
+        }
+
+        /// Sets the power of the cores and the environment temperature
+        /// from the time of the last advance() on
+        ThermalModel &input(const VectorA &P, scalar_type Te) {
+            assert(P.size() == cpus());
+
+            // The old input applies up to now
+            update();
+            U.topRows(cpus()) = P;
+            U(cpus()) = Te;
+            return *this;
+        }
+
+        ThermalModel &input(const scalar_type *P, scalar_type Te) {
+            // NOTE: this assumes that P is the correct size!
+            return input(VectorA(Eigen::Map<const VectorA>(P, cpus())), Te);
+        }
+
+        ThermalModel &input(const std::vector<scalar_type> &P,
+                            scalar_type Te) {
+            assert(P.size() == size_t(cpus()));
+            return input(P.data(), Te);
+        }
+
+        /// Maximum number of distinct intervals whose discretization is
+        /// cached (64 by default)
+        ThermalModel &cacheSize(size_t n) {
+            max_steps = n;
+            if (steps.size() > max_steps)
+                steps.clear();
+            return *this;
+        }
 
-        for (size_t r = 0; r < n_cpus; ++r) {
-            for (size_t c = 0; c < n_cpus; ++c) {
-                if (r == c) {
-                    A(r, c) = -1. / Re - Rsums(r);
+        size_t cacheSize() const {
+            return max_steps;
+        }
+
+        /// Step used to split the intervals once the cache is full, e.g.
+        /// the duration of a tick (0, the default, disables splitting)
+        ThermalModel &quantum(scalar_type q_) {
+            assert(q_ >= 0);
+            q = q_;
+            pow2.clear();
+            return *this;
+        }
+
+        scalar_type quantum() const {
+            return q;
+        }
+
+        // NOTE: t must be an absolute, non-negative, correctly scaled value
+        // in seconds!
+        ThermalModel &advance(scalar_type t) {
+            assert(t >= t1);
+            t1 = t;
+            return *this;
+        }
+
+        VectorA curtemp_Vector() {
+            update();
+            return T0;
+        }
+
+        std::vector<scalar_type> curtemp() {
+            VectorA v = curtemp_Vector();
+            return std::vector<scalar_type>(v.data(),
+                                            v.data() + v.cols() * v.rows());
+        }
+
+    private:
+        static MatrixA from_square(const std::vector<scalar_type> &R) {
+            const auto n = Eigen::Index(std::lround(std::sqrt(R.size())));
+            assert(size_t(n * n) == R.size());
+            return Eigen::Map<const MatrixA>(R.data(), n, n);
+        }
+
+        // Propagates the temperatures from t0 to t1
+        void update() {
+            if (t1 > t0)
+                propagate(t1 - t0);
+            t0 = t1;
+        }
+
+        void propagate(scalar_type dt) {
+            auto it = steps.find(dt);
+            if (it != steps.end()) {
+                apply(it->second);
+                return;
+            }
+
+            if (steps.size() < max_steps) {
+                apply(steps.emplace(dt, discretize(dt)).first->second);
+                return;
+            }
+
+            if (q > 0 && dt / q < scalar_type(uint64_t(1) << 52)) {
+                // dt = n * q + r, n is split into powers of two
+                scalar_type n = std::round(dt / q);
+                scalar_type r = dt - n * q;
+                if (std::abs(r) <= q * 1e-9) {
+                    r = 0;
                 } else {
-                    A(r, c) = 1 / R(r, c);
+                    n = std::floor(dt / q);
+                    r = dt - n * q;
                 }
+
+                auto bits = uint64_t(n);
+                for (size_t k = 0; bits != 0; ++k, bits >>= 1)
+                    if (bits & 1)
+                        apply(power_of_two(k));
+                if (r > 0)
+                    apply(discretize(r));
+                return;
             }
+
+            apply(discretize(dt));
         }
-        A /= C;
-        return A;
-    }
 
-    // Builds the matrix B from the two parameters
-    MatrixB matrix_B(double C, double Re) {
-        MatrixB B;
-        B.leftCols(n_cpus).setIdentity();
-        B.rightCols(1) = VectorA::Constant(1 / Re);
-        B /= C;
-        return B;
-    }
-
-public:
-    ThermalModel(scalar_type C, scalar_type Re, const scalar_type *R) :
-        ThermalModel(C, Re, MatrixA(R)) {}
-
-    ThermalModel(scalar_type C, scalar_type Re,
-                 const std::vector<scalar_type> &R) :
-        ThermalModel(C, Re, R.data()) {}
-
-    ThermalModel(scalar_type C, scalar_type Re, const MatrixA &R) {
-        A = matrix_A(C, Re, R);
-        B = matrix_B(C, Re);
-        Ainv = A.inverse();
-        BU = B * U;
-    }
-
-    ThermalModel &initial(scalar_type t0_, const VectorA &T0_) {
-        t0 = t0_;
-        T0 = T0_;
-        return *this;
-    }
-
-    ThermalModel &initial(scalar_type t0, const scalar_type *T0_) {
-        // NOTE: this assumes that T0 is the correct size!
-        return initial(t0, VectorA(T0_));
-    }
-
-    ThermalModel &initial(scalar_type t0, const std::vector<scalar_type> &T0_) {
-        assert(T0_.size() == n_cpus);
-        return initial(t0, T0_.data());
-    }
-
-    ThermalModel &initial(const VectorA &T0_) {
-        return initial(0, T0_);
-    }
-
-    ThermalModel &initial(const scalar_type *T0_) {
-        // NOTE: this assumes that T0 is the correct size!
-        return initial(0, T0_);
-    }
-
-    ThermalModel &initial(const std::vector<scalar_type> &T0_) {
-        return initial(0, T0_);
-    }
-
-    ThermalModel &input(const VectorA &P, scalar_type Te) {
-        U.topRows(n_cpus) = P;
-        U(n_cpus) = Te;
-
-        // Cache new product
-        BU = B * U;
-        return *this;
-    }
-
-    ThermalModel &input(const scalar_type *P, scalar_type Te) {
-        // NOTE: this assumes that P is the correct size!
-        return input(VectorA(P), Te);
-    }
-
-    ThermalModel &input(const std::vector<scalar_type> &P, scalar_type Te) {
-        assert(P.size() == n_cpus);
-        return input(P.data(), Te);
-    }
-
-    // NOTE: t must be an absolute, non-negative, correctly scaled value in
-    // seconds!
-    ThermalModel &advance(scalar_type t) {
-        VectorA T = compute_direct(t - t0);
-        initial(t, T);
-        return *this;
-    }
-
-    VectorA curtemp_Vector() {
-        return T0;
-    }
-
-    std::vector<scalar_type> curtemp() {
-        VectorA v = curtemp_Vector();
-        return std::vector<scalar_type>(v.data(),
-                                        v.data() + v.cols() * v.rows());
-    }
-
-private:
-    VectorA compute_direct(scalar_type t) {
-        VectorA free, forced, res;
-        MatrixA Atexp = (A * t).exp();
-
-        // Free response:
-        // free(t) = exp(A * t) * T0
-        free = Atexp * T0;
-
-        // Forced response:
-        // forced(t) = - A^(-1) * (I - exp(A * t)) * B * U
-        forced = -Ainv * (I - Atexp) * BU;
-
-        // Output is the sum of the two
-        res = free + forced;
-
-        return res;
-    }
-};
+        const Step &power_of_two(size_t k) {
+            if (pow2.empty())
+                pow2.push_back(discretize(q));
+
+            // Over 2 * h:
+            // A_d(2h) = A_d(h)^2
+            // B_d(2h) = (A_d(h) + I) * B_d(h)
+            while (pow2.size() <= k) {
+                const Step &h = pow2.back();
+                Step s{h.Ad * h.Ad, (h.Ad + I) * h.Bd};
+                pow2.push_back(std::move(s));
+            }
+            return pow2[k];
+        }
+
+        Step discretize(scalar_type dt) const {
+            Step s;
+
+            // Free response:
+            // free(dt) = exp(A * dt) * T0
+            s.Ad = (A * dt).exp();
+
+            // Forced response:
+            // forced(dt) = - A^(-1) * (I - exp(A * dt)) * B * U
+            s.Bd = -Ainv * (I - s.Ad) * B;
+            return s;
+        }
+
+        void apply(const Step &s) {
+            T0 = s.Ad * T0 + s.Bd * U;
+        }
+    };
+
+} // namespace RTSim
+
+#endif // __RTSIM_THERMALMODEL_HPP__
@@ -38,7 +38,7 @@ namespace RTSim {
 
         /// Returns the workload type of the first fixed() instrution of the
         /// task t
-        static std::string getTaskWorkload(AbsRTTask *t) {
+        static WorkloadId getTaskWorkloadId(AbsRTTask *t) {
             auto task = dynamic_cast<Task *>(t);
             if (task == nullptr)
                 goto server_maybe;
@@ -46,7 +46,7 @@ namespace RTSim {
             for (auto &instr : task->getInstrQueue()) {
                 auto exec_instr = dynamic_cast<ExecInstr *>(instr.get());
                 if (exec_instr) {
-                    return exec_instr->getWorkload();
+                    return exec_instr->getWorkloadId();
                 }
             }
 
@@ -57,11 +57,16 @@ namespace RTSim {
             if (server == nullptr)
                 goto busy;
 
-            return getTaskWorkload(server->getFirstTask());
+            return getTaskWorkloadId(server->getFirstTask());
 
         busy:
             // FIXME: special kind of workload
-            return "busy";
+            return WorkloadId::BUSY;
+        }
+
+        /// Same as above, by name
+        static std::string getTaskWorkload(AbsRTTask *t) {
+            return getTaskWorkloadId(t).getName();
         }
 
         /// Vector to string
@@ -0,0 +1,80 @@
+#ifndef __RTSIM_WORKLOAD_HPP__
+#define __RTSIM_WORKLOAD_HPP__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace RTSim {
+
+    /// A workload class (e.g. "idle", "bzip2"), interned once into a
+    /// small index. Names are only used at the configuration boundary
+    /// (parsing, traces), everything else compares and indexes the ids.
+    ///
+    /// The registry is shared by all the simulations of the process and
+    /// is never shrunk, hence the same name always maps to the same id.
+    /// The empty name is the same as "idle".
+    class WorkloadId {
+    public:
+        using index_type = uint32_t;
+
+        /// The "idle" workload class
+        static const WorkloadId IDLE;
+
+        /// The "busy" workload class, used for tasks that do not specify
+        /// one
+        static const WorkloadId BUSY;
+
+        /// The idle workload class
+        constexpr WorkloadId() : _index(0) {}
+
+        /// Interns the given name, if not done already
+        explicit WorkloadId(const std::string &name);
+
+        /// Same as above, keeps string literals from being ambiguous
+        explicit WorkloadId(const char *name) :
+            WorkloadId(std::string(name)) {}
+
+        /// @returns the name this id was interned from
+        const std::string &getName() const;
+
+        /// @returns a dense index, lower than count()
+        index_type index() const {
+            return _index;
+        }
+
+        /// @returns the number of workload classes interned so far
+        static size_t count();
+
+        /// @returns the workload class with the given index, which must
+        /// be lower than count()
+        static WorkloadId fromIndex(index_type index) {
+            return WorkloadId(index, 0);
+        }
+
+        bool operator==(const WorkloadId &other) const {
+            return _index == other._index;
+        }
+
+        bool operator!=(const WorkloadId &other) const {
+            return _index != other._index;
+        }
+
+        bool operator<(const WorkloadId &other) const {
+            return _index < other._index;
+        }
+
+    private:
+        constexpr explicit WorkloadId(index_type index, int) :
+            _index(index) {}
+
+        index_type _index;
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const WorkloadId &wl) {
+        return os << wl.getName();
+    }
+
+} // namespace RTSim
+
+#endif // __RTSIM_WORKLOAD_HPP__
@@ -132,10 +132,10 @@ namespace RTSim {
 
         if (!_isContextSwitching) {
             DBGPRINT("onArrival, calling dispatch() while NOT contextSwitching");
-            dispatch();
+            dispatchOncePerBatch();
         } else {
             DBGPRINT("onArrival, calling dispatch() even if we're contextSwitching");
-            dispatch();
+            dispatchOncePerBatch();
         }
     }
 
@@ -161,6 +161,17 @@ namespace RTSim {
         beginDispatchEvt.post(SIMUL.getTime());
     }
 
+    void RTKernel::dispatchOncePerBatch() {
+        if (!SIMUL.deferToEndOfBatch(this))
+            dispatch();
+    }
+
+    void RTKernel::onEndOfBatch() {
+        DBGENTER(_KERNEL_DBG_LEV);
+
+        dispatch();
+    }
+
     void RTKernel::onBeginDispatch(Event *e) {
         DBGENTER(_KERNEL_DBG_LEV);
 
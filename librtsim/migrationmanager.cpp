@@ -33,8 +33,8 @@ namespace RTSim {
 
     void MigrationManager::addSchedulingEvent(AbsRTTask *t, Tick when,
                                               CPU *cpu) {
-        std::string wl = cpu->getWorkload();
-        cpu->setWorkload(Utils::getTaskWorkload(t));
+        WorkloadId wl = cpu->getWorkloadId();
+        cpu->setWorkload(Utils::getTaskWorkloadId(t));
         addTaskEvent(t, when, EventType::SCHEDULE, cpu);
         cpu->setWorkload(wl);
     }
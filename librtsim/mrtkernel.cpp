@@ -12,6 +12,7 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 
 #include <rtsim/cbserver.hpp>
@@ -87,62 +88,170 @@ namespace RTSim {
     // MRTKernel::MRTKernel(Scheduler *s, const string &name) :
     //     MRTKernel(s, 1, name) {}
 
-    /// Deletes elements pointed by maps
-    template <class IT>
-    static inline void clean_mapcontainer(IT b, IT e) {
-        for (IT i = b; i != e; i++)
-            delete i->second;
-    }
-
     MRTKernel::~MRTKernel() {
         // delete _CPUFactory;
-        clean_mapcontainer(_beginEvt.begin(), _beginEvt.end());
-        clean_mapcontainer(_endEvt.begin(), _endEvt.end());
+        for (auto &c : _cpus) {
+            delete c.beginEvt;
+            delete c.endEvt;
+        }
     }
 
     // =====================================================
     // Methods
     // =====================================================
 
+    int MRTKernel::getCPUSlot(const CPU *c) const {
+        auto it = _cpuSlot.find(c);
+        if (it == _cpuSlot.end())
+            throw RTKernelExc("CPU not found in kernel " + getName());
+        return it->second;
+    }
+
+    MRTKernel::TaskState *MRTKernel::getTaskState(const AbsRTTask *t) {
+        auto it = _taskSlot.find(t);
+        if (it == _taskSlot.end())
+            return nullptr;
+        return &_taskStates[it->second];
+    }
+
+    const MRTKernel::TaskState *
+        MRTKernel::getTaskState(const AbsRTTask *t) const {
+        auto it = _taskSlot.find(t);
+        if (it == _taskSlot.end())
+            return nullptr;
+        return &_taskStates[it->second];
+    }
+
+    void MRTKernel::updateFree(int i) {
+        uint64_t bit = uint64_t(1) << (i % 64);
+        if (_cpus[i].exe == nullptr && _cpus[i].dispatched == 0)
+            _freeCPUs[i / 64] |= bit;
+        else
+            _freeCPUs[i / 64] &= ~bit;
+    }
+
+    void MRTKernel::setExecuting(CPU *c, AbsRTTask *t) {
+        int i = getCPUSlot(c);
+        CPUState &cs = _cpus[i];
+
+        if (cs.exe != nullptr) {
+            TaskState *old = getTaskState(cs.exe);
+            if (old != nullptr && old->exe == i)
+                old->exe = -1;
+        }
+
+        cs.exe = t;
+        if (t != nullptr) {
+            TaskState *ts = getTaskState(t);
+            if (ts == nullptr)
+                throw RTKernelExc("Task not found in kernel " + getName());
+            ts->exe = i;
+        }
+        updateFree(i);
+    }
+
+    void MRTKernel::setDispatched(AbsRTTask *t, CPU *c) {
+        TaskState *ts = getTaskState(t);
+        if (ts == nullptr)
+            throw RTKernelExc("Task not found in kernel " + getName());
+
+        int i = (c == nullptr) ? -1 : getCPUSlot(c);
+        if (ts->dispatched == i)
+            return;
+
+        if (ts->dispatched >= 0) {
+            --_cpus[ts->dispatched].dispatched;
+            updateFree(ts->dispatched);
+            removeRanked(*ts);
+        }
+        ts->dispatched = i;
+        if (i >= 0) {
+            ++_cpus[i].dispatched;
+            updateFree(i);
+            addRanked(*ts);
+        }
+    }
+
+    void MRTKernel::addRanked(TaskState &ts) {
+        if (ts.ranked)
+            return;
+        ts.key = _sched->getSortKey(ts.task);
+        ts.ranked = true;
+        _ranked.insert({ts.key, ts.task});
+    }
+
+    void MRTKernel::removeRanked(TaskState &ts) {
+        if (!ts.ranked)
+            return;
+        _ranked.erase({ts.key, ts.task});
+        ts.ranked = false;
+    }
+
+    CPU *MRTKernel::getDispatched(const AbsRTTask *t) const {
+        const TaskState *ts = getTaskState(t);
+        if (ts == nullptr || ts->dispatched < 0)
+            return nullptr;
+        return _cpus[ts->dispatched].cpu;
+    }
+
+    void MRTKernel::setOldProcessor(AbsRTTask *t, CPU *c) {
+        TaskState *ts = getTaskState(t);
+        if (ts == nullptr)
+            throw RTKernelExc("Task not found in kernel " + getName());
+        ts->old = (c == nullptr) ? -1 : getCPUSlot(c);
+    }
+
     CPU *MRTKernel::getFreeProcessor() {
-        for (auto it : _m_currExe) {
-            if (it.second == nullptr)
-                return it.first;
+        for (auto &c : _cpus) {
+            if (c.exe == nullptr)
+                return c.cpu;
         }
         return nullptr;
     }
 
     bool MRTKernel::isDispatched(CPU *p) const {
-        for (auto it : _m_dispatched) {
-            if (it.second == p)
-                return true;
-        }
-        return false;
+        return _cpus[getCPUSlot(p)].dispatched > 0;
     }
 
-    MRTKernel::ITCPU MRTKernel::getNextFreeProc(ITCPU begin, ITCPU end) {
-        for (auto it = begin; it != end; ++it) {
-            if (it->second == nullptr && !isDispatched(it->first))
-                return it;
+    int MRTKernel::getNextFreeProc(int first) const {
+        if (first < 0 || size_t(first) >= _cpus.size())
+            return -1;
+
+        size_t w = first / 64;
+        uint64_t word = _freeCPUs[w] & (~uint64_t(0) << (first % 64));
+        for (;;) {
+            if (word != 0)
+                return int(w * 64 + __builtin_ctzll(word));
+            if (++w == _freeCPUs.size())
+                return -1;
+            word = _freeCPUs[w];
         }
-        return end;
     }
 
     void MRTKernel::addCPU(CPU *c) {
         DBGENTER(_KERNEL_DBG_LEV);
 
-        _m_currExe[c] = nullptr;
-        _isContextSwitching[c] = false;
-        _beginEvt[c] = new BeginDispatchMultiEvt(*this, *c);
-        _endEvt[c] = new EndDispatchMultiEvt(*this, *c);
+        if (_cpuSlot.count(c))
+            return;
+
+        int i = _cpus.size();
+        _cpuSlot[c] = i;
+        _cpus.push_back({c, nullptr, 0, false,
+                         new BeginDispatchMultiEvt(*this, *c),
+                         new EndDispatchMultiEvt(*this, *c)});
+        if (_freeCPUs.size() * 64 < _cpus.size())
+            _freeCPUs.push_back(0);
+        updateFree(i);
 
         c->setKernel(this);
     }
 
     void MRTKernel::addTask(AbsRTTask &t, const string &param) {
         RTKernel::addTask(t, param);
-        _m_oldExe[&t] = nullptr;
-        _m_dispatched[&t] = nullptr;
+        if (!_taskSlot.count(&t)) {
+            _taskSlot[&t] = _taskStates.size();
+            _taskStates.push_back({&t, -1, -1, -1, false, {}});
+        }
 
         CBServer *cbs = dynamic_cast<CBServer *>(&t);
         if (cbs != nullptr)
@@ -153,20 +262,27 @@ namespace RTSim {
         DBGENTER(_KERNEL_DBG_LEV);
 
         _sched->insert(task);
-        dispatch();
+        dispatchOncePerBatch();
     }
 
     void MRTKernel::suspend(AbsRTTask *task) {
         DBGENTER(_MRTKERNEL_DBG_LEV);
 
         _sched->extract(task);
+
+        // The task may still be dispatched, if it is suspended during the
+        // context switch, but it is no more in the queue
+        TaskState *ts = getTaskState(task);
+        if (ts != nullptr)
+            removeRanked(*ts);
+
         CPU *p = getProcessor(task);
         if (p != nullptr) {
             task->deschedule();
 
-            _m_currExe[p] = nullptr;
-            _m_oldExe[task] = p;
-            _m_dispatched[task] = nullptr;
+            setExecuting(p, nullptr);
+            setOldProcessor(task, p);
+            setDispatched(task, nullptr);
             dispatch(p);
         }
     }
@@ -180,9 +296,9 @@ namespace RTSim {
             throw RTKernelExc("Received a onEnd of a non executing task");
 
         _sched->extract(task);
-        _m_oldExe[task] = p;
-        _m_currExe[p] = nullptr;
-        _m_dispatched[task] = nullptr;
+        setOldProcessor(task, p);
+        setExecuting(p, nullptr);
+        setDispatched(task, nullptr);
 
         dispatch(p);
     }
@@ -194,53 +310,50 @@ namespace RTSim {
             throw RTKernelExc("Dispatch with NULL parameter");
         DBGPRINT("dispatching on processor ", p);
 
+        CPUState &cs = _cpus[getCPUSlot(p)];
+
         // Undo any previous "begin dispatch event" existing on this CPU
-        _beginEvt[p]->drop();
+        cs.beginEvt->drop();
 
-        if (_isContextSwitching[p]) {
+        if (cs.switching) {
             DBGPRINT("Context switch is disabled!");
 
             // Shifting forward the dispatch time on this cpu until the current
             // context switch (event) is done
-            _beginEvt[p]->post(_endEvt[p]->getTime());
+            cs.beginEvt->post(cs.endEvt->getTime());
 
             // The previous context switch is canceled (the time it took to run
             // will still be accounted though)
-            AbsRTTask *task = _endEvt[p]->getTask();
-            _endEvt[p]->drop();
+            AbsRTTask *task = cs.endEvt->getTask();
+            cs.endEvt->drop();
             if (task != nullptr) {
-                _endEvt[p]->setTask(nullptr);
-                _m_dispatched[task] = nullptr;
+                cs.endEvt->setTask(nullptr);
+                setDispatched(task, nullptr);
             }
         } else {
             // Perform the dispatch now (see onBeginDispatchMulti)
-            _beginEvt[p]->post(SIMUL.getTime());
+            cs.beginEvt->post(SIMUL.getTime());
         }
     }
 
     void MRTKernel::dispatch() {
         DBGENTER(_KERNEL_DBG_LEV);
 
-        size_t ncpu = _m_currExe.size();
+        size_t ntop = std::min<size_t>(_cpus.size(), _sched->getSize());
+        if (ntop == 0)
+            return;
+
+        // The last of the first ncpu tasks in the ready queue: the tasks that
+        // should be dispatched are the ones up to this one
+        AbsRTTask *last = _sched->getTaskN(ntop - 1);
+        RankedTask boundary{_sched->getSortKey(last), last};
 
         // Tells us how many of the first ncpu tasks in the ready queue are not
         // yet scheduled or dispatched for scheduling.
-        int num_newtasks = 0;
-
-        // Check whether the first ncpu tasks in the ready queue are already
-        // dispatched or not.
-        for (size_t i = 0; i < ncpu; ++i) {
-            AbsRTTask *t = _sched->getTaskN(i);
-            if (t == nullptr)
-                break;
-            else if (getProcessor(t) == nullptr && _m_dispatched[t] == nullptr)
-                ++num_newtasks;
-        }
-
-        // Technically, in the old impl i can be less than ncpu, but if we break
-        // before reaching ncpu for sure there are NO tasks to evict and i will
-        // never be used.
-        int i = ncpu;
+        size_t ndispatched = _ranked.rank(boundary);
+        if (_ranked.contains(boundary))
+            ++ndispatched;
+        int num_newtasks = ntop - ndispatched;
 
         DBGPRINT(_sched->toString());
         DBGPRINT("New tasks: ", num_newtasks);
@@ -249,41 +362,37 @@ namespace RTSim {
         if (num_newtasks < 1)
             return;
 
-        for (auto f = getNextFreeProc(_m_currExe.begin(), _m_currExe.end());
-             num_newtasks > 0; f = getNextFreeProc(f, _m_currExe.end())) {
-            if (f != _m_currExe.end()) {
-                DBGPRINT("Dispatching on free processor ", f->first);
-                dispatch(f->first);
-                --num_newtasks;
-                ++f;
-            } else {
-                // We have to "evict" a task from being scheduled/dispatched
-                // because there are no more CPUs and a task that is "higher" in
-                // the ready queue has to run on its CPU.
-
-                // ORIGINAL NOTE FROM TOMMASO:
-                // NON-SENSE: this is putting all new tasks on WHAT CPU ?!?
-
-                // NOTE: this loop takes a long while to complete
-                for (;;) {
-                    AbsRTTask *t = _sched->getTaskN(i++);
-                    if (t == nullptr) {
-                        throw RTKernelExc(
-                            "Can't find enough tasks to deschedule!");
-                    }
-
-                    // NOTE: does not check for running tasks, only dispatched
-                    // ones!
-                    CPU *c = _m_dispatched[t];
-                    if (c != nullptr) {
-                        DBGPRINT("Dispatching on processor ", c,
-                                 " which is executing task ", taskname(t));
-                        dispatch(c);
-                        --num_newtasks;
-                        break;
-                    }
-                }
-            }
+        for (int f = getNextFreeProc(0); num_newtasks > 0 && f >= 0;
+             f = getNextFreeProc(f + 1)) {
+            DBGPRINT("Dispatching on free processor ", _cpus[f].cpu);
+            dispatch(_cpus[f].cpu);
+            --num_newtasks;
+        }
+
+        if (num_newtasks < 1)
+            return;
+
+        // We have to "evict" a task from being scheduled/dispatched because
+        // there are no more CPUs and a task that is "higher" in the ready
+        // queue has to run on its CPU: the victims are the dispatched tasks
+        // after the boundary, in queue order (the CPU evicted first gets the
+        // first new task). They are collected first, because dispatch(c) may
+        // change _ranked.
+        //
+        // NOTE: does not check for running tasks, only dispatched ones!
+        _victims.clear();
+        for (auto it = _ranked.at(ndispatched); num_newtasks > 0; ++it) {
+            if (it == _ranked.end())
+                throw RTKernelExc("Can't find enough tasks to deschedule!");
+
+            _victims.push_back(getDispatched(it->task));
+            --num_newtasks;
+        }
+
+        for (CPU *c : _victims) {
+            DBGPRINT("Dispatching on processor ", c, " which is executing task ",
+                     taskname(getTask(c)));
+            dispatch(c);
         }
     }
 
@@ -292,23 +401,23 @@ namespace RTSim {
 
         // if necessary, deschedule the task.
         CPU *p = e->getCPU();
-        AbsRTTask *dt = _m_currExe[p];
+        CPUState &cs = _cpus[getCPUSlot(p)];
+        AbsRTTask *dt = cs.exe;
         AbsRTTask *st = nullptr;
 
         if (dt != nullptr) {
-            _m_oldExe[dt] = p;
-            _m_currExe[p] = nullptr;
-            _m_dispatched[dt] = nullptr;
+            setOldProcessor(dt, p);
+            setExecuting(p, nullptr);
+            setDispatched(dt, nullptr);
             dt->deschedule();
         }
 
         // select the first non dispatched task in the queue
-        int i = 0;
-        while ((st = _sched->getTaskN(i)) != nullptr)
-            if (_m_dispatched[st] == nullptr)
+        for (AbsRTTask *t : _sched->getTasks())
+            if (getDispatched(t) == nullptr) {
+                st = t;
                 break;
-            else
-                i++;
+            }
 
         if (st == nullptr) {
             DBGPRINT("Nothing to schedule, finishing");
@@ -317,13 +426,14 @@ namespace RTSim {
         DBGPRINT("Scheduling task ", taskname(st), " on cpu ", p->toString());
 
         if (st)
-            _m_dispatched[st] = p;
-        _endEvt[p]->setTask(st);
-        _isContextSwitching[p] = true;
+            setDispatched(st, p);
+        cs.endEvt->setTask(st);
+        cs.switching = true;
         Tick overhead(_contextSwitchDelay);
-        if (st != nullptr && _m_oldExe[st] != p && _m_oldExe[st] != nullptr)
+        CPU *old = (st != nullptr) ? getOldProcessor(st) : nullptr;
+        if (old != p && old != nullptr)
             overhead += _migrationDelay;
-        _endEvt[p]->post(SIMUL.getTime() + overhead);
+        cs.endEvt->post(SIMUL.getTime() + overhead);
     }
 
     void MRTKernel::onEndDispatchMulti(EndDispatchMultiEvt *e) {
@@ -333,7 +443,7 @@ namespace RTSim {
         AbsRTTask *st = e->getTask();
         CPU *p = e->getCPU();
 
-        _m_currExe[p] = st;
+        setExecuting(p, st);
 
         DBGPRINT("CPU: ", p->toString());
         DBGPRINT("Task: ", taskname(st));
@@ -343,98 +453,100 @@ namespace RTSim {
         if (st)
             st->schedule();
 
-        _isContextSwitching[p] = false;
+        setContextSwitching(p, false);
         _sched->notify(st);
     }
 
     CPU *MRTKernel::getProcessor(const AbsRTTask *t) const {
         DBGENTER(_KERNEL_DBG_LEV);
-        CPU *ret = nullptr;
 
-        for (auto i = _m_currExe.cbegin(); i != _m_currExe.cend(); i++)
-            if (i->second == t)
-                ret = i->first;
-        return ret;
+        const TaskState *ts = getTaskState(t);
+        if (ts == nullptr || ts->exe < 0)
+            return nullptr;
+        return _cpus[ts->exe].cpu;
     }
 
     CPU *MRTKernel::getOldProcessor(const AbsRTTask *t) const {
-        CPU *ret = nullptr;
-
         DBGENTER(_KERNEL_DBG_LEV);
 
-        auto it = _m_oldExe.find(t);
-        if (it != _m_oldExe.cend())
-            ret = it->second;
-
-        return ret;
+        const TaskState *ts = getTaskState(t);
+        if (ts == nullptr || ts->old < 0)
+            return nullptr;
+        return _cpus[ts->old].cpu;
     }
 
     // std::vector<CPU *> MRTKernel::getProcessors() const {
-    //     std::vector<CPU *> s(_m_currExe.size());
-    //     int j = 0;
-    //     for (auto i = _m_currExe.cbegin(); i != _m_currExe.cend(); i++, j++)
-    //         s[j] = i->first;
+    //     std::vector<CPU *> s(_cpus.size());
+    //     for (size_t i = 0; i < _cpus.size(); i++)
+    //         s[i] = _cpus[i].cpu;
     //     return s;
     // }
 
     void MRTKernel::newRun() {
-        for (auto i = _m_currExe.begin(); i != _m_currExe.end(); i++) {
-            if (i->second != nullptr)
-                _sched->extract(i->second);
-            i->second = nullptr;
+        for (auto &c : _cpus) {
+            if (c.exe != nullptr)
+                _sched->extract(c.exe);
+            c.exe = nullptr;
+            c.dispatched = 0;
         }
 
-        for (auto j = _m_dispatched.begin(); j != _m_dispatched.end(); ++j) {
-            j->second = nullptr;
+        for (auto &t : _taskStates) {
+            t.exe = -1;
+            t.dispatched = -1;
+            t.old = -1;
+            t.ranked = false;
         }
+        _ranked.clear();
 
-        for (auto j = _m_oldExe.begin(); j != _m_oldExe.end(); ++j) {
-            j->second = nullptr;
-        }
+        for (size_t i = 0; i < _cpus.size(); ++i)
+            updateFree(i);
     }
 
     void MRTKernel::endRun() {
-        for (auto i = _m_currExe.begin(); i != _m_currExe.end(); i++) {
-            if (i->second != nullptr)
-                _sched->extract(i->second);
-            i->second = nullptr;
+        for (auto &c : _cpus) {
+            if (c.exe != nullptr) {
+                _sched->extract(c.exe);
+                setExecuting(c.cpu, nullptr);
+            }
         }
     }
 
     void MRTKernel::print() const {
         DBGPRINT("Executing");
-        for (auto i = _m_currExe.cbegin(); i != _m_currExe.cend(); ++i)
-            DBGPRINT("  [", i->first, "] --> ", taskname(i->second));
+        for (auto &c : _cpus)
+            DBGPRINT("  [", c.cpu, "] --> ", taskname(c.exe));
 
         DBGPRINT("Dispatched");
-        for (auto j = _m_dispatched.cbegin(); j != _m_dispatched.cend(); ++j)
-            DBGPRINT("  [", taskname(j->first), "] --> ", j->second);
+        for (auto &t : _taskStates)
+            DBGPRINT("  [", taskname(t.task), "] --> ",
+                     t.dispatched < 0 ? nullptr : _cpus[t.dispatched].cpu);
     }
 
     void MRTKernel::printState() const {
         Entity *task;
         std::cout << "MRTKernel::printstate(), time " << SIMUL.getTime() << " ";
-        for (auto i = _m_currExe.cbegin(); i != _m_currExe.cend(); i++) {
-            task = dynamic_cast<Entity *>(i->second);
+        for (auto &c : _cpus) {
+            task = dynamic_cast<Entity *>(c.exe);
             if (task != nullptr)
-                std::cout << i->first->getName() << " : " << task->getName()
+                std::cout << c.cpu->getName() << " : " << task->getName()
                           << "   ";
             else
-                std::cout << i->first->getName() << " :   0   ";
+                std::cout << c.cpu->getName() << " :   0   ";
         }
         std::cout << std::endl;
     }
 
     AbsRTTask *MRTKernel::getTask(const CPU *c) {
-        // Not the cleanest solution, but the comparison operator doesn't care
-        // about the pointd element anyway
-        return _m_currExe[const_cast<CPU *>(c)];
+        auto it = _cpuSlot.find(c);
+        if (it == _cpuSlot.end())
+            return nullptr;
+        return _cpus[it->second].exe;
     }
 
     std::vector<std::string> MRTKernel::getRunningTasks() {
         std::vector<std::string> tmp_ts;
-        for (auto i = _m_currExe.cbegin(); i != _m_currExe.cend(); i++) {
-            std::string tmp_name = taskname((*i).second);
+        for (auto &c : _cpus) {
+            std::string tmp_name = taskname(c.exe);
             if (tmp_name != "(nil)")
                 tmp_ts.push_back(tmp_name);
         }
@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+// RTSim
+#include <rtsim/schedanalysis.hpp>
+
+namespace RTSim {
+
+    size_t TaskArray::add(int64_t c, int64_t t, int64_t d, int prio,
+                          int core) {
+        if (t <= 0)
+            throw SchedAnalysis::Exc("The period must be positive");
+        if (c < 0)
+            throw SchedAnalysis::Exc("The WCET must not be negative");
+
+        wcet.push_back(c);
+        period.push_back(t);
+        dline.push_back(d > 0 ? d : t);
+        priority.push_back(prio >= 0 ? prio : int(size()));
+        cpu.push_back(core);
+        return size() - 1;
+    }
+
+    void TaskArray::clear() {
+        wcet.clear();
+        period.clear();
+        dline.clear();
+        priority.clear();
+        cpu.clear();
+    }
+
+    namespace {
+        // The tasks of a CPU, with the WCETs at its speed, in contiguous
+        // arrays
+        struct LocalTasks {
+            std::vector<int64_t> c, t, d;
+            std::vector<size_t> index;
+
+            size_t size() const {
+                return c.size();
+            }
+        };
+    } // namespace
+
+    static int64_t scaleWCET(int64_t c, double speed) {
+        return speed == 1.0 ? c : int64_t(std::ceil(double(c) / speed));
+    }
+
+    static void checkSpeed(double speed) {
+        if (!(speed > 0.0))
+            throw SchedAnalysis::Exc("The speed must be positive");
+    }
+
+    // Collects the tasks on cpu (all of them if cpu is NONE), by
+    // decreasing priority if byPriority is true
+    static void gather(const TaskArray &ts, int cpu, double speed,
+                       bool byPriority, LocalTasks &l) {
+        checkSpeed(speed);
+
+        l.index.clear();
+        for (size_t i = 0; i < ts.size(); ++i)
+            if (cpu == TaskArray::NONE || ts.cpu[i] == cpu)
+                l.index.push_back(i);
+
+        if (byPriority)
+            std::stable_sort(l.index.begin(), l.index.end(),
+                             [&ts](size_t a, size_t b) {
+                                 return ts.priority[a] < ts.priority[b];
+                             });
+
+        const size_t n = l.index.size();
+        l.c.resize(n);
+        l.t.resize(n);
+        l.d.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = l.index[k];
+            l.c[k] = scaleWCET(ts.wcet[i], speed);
+            l.t[k] = ts.period[i];
+            l.d[k] = ts.dline[i];
+        }
+    }
+
+    // Fixed point of the response-time recurrence of level i, or its
+    // first iterate past the deadline
+    static int64_t responseTime(const LocalTasks &l, size_t i) {
+        const int64_t c = l.c[i];
+        int64_t r = c;
+        for (;;) {
+            int64_t next = c;
+            for (size_t j = 0; j < i; ++j)
+                next += (r + l.t[j] - 1) / l.t[j] * l.c[j];
+            if (next <= r || next > l.d[i])
+                return next;
+            r = next;
+        }
+    }
+
+    static int64_t demand(const LocalTasks &l, int64_t t) {
+        int64_t h = 0;
+        for (size_t i = 0; i < l.size(); ++i)
+            if (l.d[i] <= t)
+                h += ((t - l.d[i]) / l.t[i] + 1) * l.c[i];
+        return h;
+    }
+
+    // The latest absolute deadline strictly before x, 0 if none
+    static int64_t prevDeadline(const LocalTasks &l, int64_t x) {
+        int64_t best = 0;
+        for (size_t i = 0; i < l.size(); ++i)
+            if (l.d[i] < x)
+                best = std::max(best, (x - 1 - l.d[i]) / l.t[i] * l.t[i] +
+                                          l.d[i]);
+        return best;
+    }
+
+    // Longest synchronous busy period that is computed, see
+    // isQPASchedulable()
+    static const int64_t MAX_BUSY_PERIOD = int64_t(1) << 40;
+
+    static bool qpa(const LocalTasks &l) {
+        const size_t n = l.size();
+        if (n == 0)
+            return true;
+
+        long double u = 0;
+        bool implicit = true;
+        int64_t dmin = l.d[0], dmax = l.d[0];
+        for (size_t i = 0; i < n; ++i) {
+            u += (long double) l.c[i] / l.t[i];
+            implicit = implicit && l.d[i] >= l.t[i];
+            dmin = std::min(dmin, l.d[i]);
+            dmax = std::max(dmax, l.d[i]);
+        }
+
+        const long double eps = 1e-12;
+        if (u > 1 + eps)
+            return false;
+        if (implicit)
+            return true;
+
+        // Upper bound of the interval to check: the synchronous busy
+        // period and, if the utilization is below 1, the bound of Baruah
+        int64_t limit = MAX_BUSY_PERIOD;
+        if (u < 1 - 1e-9) {
+            long double la = 0;
+            for (size_t i = 0; i < n; ++i)
+                la += (long double) (l.t[i] - l.d[i]) * l.c[i] / l.t[i];
+            la /= 1 - u;
+            limit = std::max(dmax, int64_t(std::ceil(la)));
+        }
+
+        int64_t w = std::accumulate(l.c.begin(), l.c.end(), int64_t(0));
+        while (w < limit) {
+            int64_t next = 0;
+            for (size_t i = 0; i < n; ++i)
+                next += (w + l.t[i] - 1) / l.t[i] * l.c[i];
+            if (next == w)
+                break;
+            w = next;
+        }
+        if (w >= MAX_BUSY_PERIOD)
+            return false;
+        const int64_t L = std::min(w, limit);
+
+        int64_t t = prevDeadline(l, L);
+        int64_t h = demand(l, t);
+        while (h <= t && h > dmin) {
+            if (h < t)
+                t = h;
+            else
+                t = prevDeadline(l, t);
+            h = demand(l, t);
+        }
+        return h <= dmin;
+    }
+
+    double SchedAnalysis::getUtilization(const TaskArray &ts, int cpu,
+                                         double speed) {
+        checkSpeed(speed);
+        double u = 0;
+        for (size_t i = 0; i < ts.size(); ++i)
+            if (cpu == TaskArray::NONE || ts.cpu[i] == cpu)
+                u += double(ts.wcet[i]) / double(ts.period[i]);
+        return u / speed;
+    }
+
+    double SchedAnalysis::getDensity(const TaskArray &ts, int cpu,
+                                     double speed) {
+        checkSpeed(speed);
+        double u = 0;
+        for (size_t i = 0; i < ts.size(); ++i)
+            if (cpu == TaskArray::NONE || ts.cpu[i] == cpu)
+                u += double(ts.wcet[i]) /
+                     double(std::min(ts.dline[i], ts.period[i]));
+        return u / speed;
+    }
+
+    bool SchedAnalysis::isLLSchedulable(const TaskArray &ts, int cpu,
+                                        double speed) {
+        size_t n = 0;
+        for (size_t i = 0; i < ts.size(); ++i)
+            if (cpu == TaskArray::NONE || ts.cpu[i] == cpu)
+                ++n;
+        if (n == 0)
+            return true;
+        return getUtilization(ts, cpu, speed) <=
+               n * (std::pow(2.0, 1.0 / n) - 1);
+    }
+
+    bool SchedAnalysis::isHyperbolicSchedulable(const TaskArray &ts, int cpu,
+                                                double speed) {
+        checkSpeed(speed);
+        double p = 1;
+        for (size_t i = 0; i < ts.size(); ++i)
+            if (cpu == TaskArray::NONE || ts.cpu[i] == cpu)
+                p *= double(ts.wcet[i]) / (double(ts.period[i]) * speed) + 1;
+        return p <= 2;
+    }
+
+    bool SchedAnalysis::isRTASchedulable(const TaskArray &ts, int cpu,
+                                         double speed) {
+        LocalTasks l;
+        gather(ts, cpu, speed, true, l);
+        for (size_t i = 0; i < l.size(); ++i)
+            if (responseTime(l, i) > l.d[i])
+                return false;
+        return true;
+    }
+
+    int64_t SchedAnalysis::getResponseTime(const TaskArray &ts, size_t i,
+                                           double speed) {
+        LocalTasks l;
+        gather(ts, ts.cpu.at(i), speed, true, l);
+        size_t k = std::find(l.index.begin(), l.index.end(), i) -
+                   l.index.begin();
+        return responseTime(l, k);
+    }
+
+    int64_t SchedAnalysis::getDemand(const TaskArray &ts, int64_t t, int cpu,
+                                     double speed) {
+        LocalTasks l;
+        gather(ts, cpu, speed, false, l);
+        return demand(l, t);
+    }
+
+    bool SchedAnalysis::isQPASchedulable(const TaskArray &ts, int cpu,
+                                         double speed) {
+        LocalTasks l;
+        gather(ts, cpu, speed, false, l);
+        return qpa(l);
+    }
+
+    bool SchedAnalysis::isSchedulable(const TaskArray &ts, Policy policy,
+                                      int cpu, double speed) {
+        if (policy == Policy::EDF)
+            return isQPASchedulable(ts, cpu, speed);
+        return isRTASchedulable(ts, cpu, speed);
+    }
+
+    bool SchedAnalysis::partition(TaskArray &ts,
+                                  const std::vector<double> &speeds, Fit fit,
+                                  Policy policy, bool decreasing) {
+        std::vector<size_t> order(ts.size());
+        std::iota(order.begin(), order.end(), 0);
+        if (decreasing)
+            std::stable_sort(order.begin(), order.end(),
+                             [&ts](size_t a, size_t b) {
+                                 return ts.wcet[a] * ts.period[b] >
+                                        ts.wcet[b] * ts.period[a];
+                             });
+
+        std::fill(ts.cpu.begin(), ts.cpu.end(), TaskArray::NONE);
+        std::vector<double> load(speeds.size(), 0.0);
+        bool all = true;
+
+        for (size_t i : order) {
+            const double u = double(ts.wcet[i]) / double(ts.period[i]);
+            int best = TaskArray::NONE;
+            double bestLoad = 0;
+
+            for (size_t c = 0; c < speeds.size(); ++c) {
+                ts.cpu[i] = int(c);
+                if (!isSchedulable(ts, policy, int(c), speeds[c]))
+                    continue;
+
+                double l = load[c] + u / speeds[c];
+                if (best == TaskArray::NONE ||
+                    (fit == Fit::BEST && l > bestLoad) ||
+                    (fit == Fit::WORST && l < bestLoad)) {
+                    best = int(c);
+                    bestLoad = l;
+                }
+                if (fit == Fit::FIRST)
+                    break;
+            }
+
+            ts.cpu[i] = best;
+            if (best == TaskArray::NONE)
+                all = false;
+            else
+                load[best] = bestLoad;
+        }
+        return all;
+    }
+
+    size_t SchedAnalysis::getMinOPP(const TaskArray &ts, int cpu,
+                                    const std::vector<double> &speeds,
+                                    Policy policy) {
+        // Schedulability does not get worse with the speed
+        size_t lo = 0, hi = speeds.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (isSchedulable(ts, policy, cpu, speeds[mid]))
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        return lo;
+    }
+
+    std::vector<char>
+        SchedAnalysis::evaluate(const std::vector<TaskArray> &sets,
+                                const Test &test, unsigned int workers) {
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        workers = std::min<size_t>(workers, std::max<size_t>(1, sets.size()));
+
+        std::vector<char> results(sets.size(), 0);
+
+        // Workers take the sets in chunks, to keep the contention on the
+        // counter low when the tests are short
+        const size_t chunk = 16;
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex error_mtx;
+
+        auto worker = [&]() {
+            try {
+                for (;;) {
+                    size_t first = next.fetch_add(chunk);
+                    if (first >= sets.size())
+                        break;
+                    size_t last = std::min(first + chunk, sets.size());
+                    for (size_t i = first; i < last; ++i)
+                        results[i] = test(sets[i]);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if (!error)
+                    error = std::current_exception();
+                // stop the others as soon as possible
+                next = sets.size();
+            }
+        };
+
+        if (workers == 1) {
+            worker();
+        } else {
+            std::vector<std::thread> threads;
+            for (unsigned int w = 0; w < workers; ++w)
+                threads.emplace_back(worker);
+            for (auto &t : threads)
+                t.join();
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+        return results;
+    }
+
+} // namespace RTSim
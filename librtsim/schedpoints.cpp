@@ -17,6 +17,7 @@ namespace RTSim {
         period.push_back(pp);
         wcet.push_back(cc);
         U.push_back(double(cc) / double(pp));
+        analysis.addLevel(cc, pp);
     }
 
     SchedPoint::SchedPoint(const string &name) :
@@ -31,7 +32,9 @@ namespace RTSim {
         exactConstraints(),
         schedpoints(),
         U(),
-        task(0) {}
+        task(0),
+        analysis(),
+        product() {}
 
     SchedPoint::~SchedPoint() {}
 
@@ -67,6 +70,7 @@ namespace RTSim {
             wcet[index] = 1;
         DBGVAR(wcet[index]);
         U[index] = (double) wcet[index] / double(period[index]);
+        analysis.setWCET(index, wcet[index]);
         DBGVAR(U[index]);
 
         DBGVAR(last_change_time);
@@ -154,9 +158,9 @@ namespace RTSim {
 
         exactConstraints.clear();
         for (int curTask = 0; curTask < ntasks; curTask++) {
-            row_t schedP;
-            // compute the scheduling points
-            schedP = SetP(period[curTask], period, curTask);
+            // the scheduling points, as computed by SetP(), are computed
+            // only the first time
+            const row_t &schedP = analysis.getSchedPoints(curTask);
 
             // initialize the empty matrix
             OneTaskConstraints.clear();
@@ -207,10 +211,6 @@ namespace RTSim {
     double SchedPoint::sensitivity(int task) {
         //        DBGENTER(_SERVER_DBG_LEV);
         int nTask = U.size();
-        u_row_t lambdaVec;
-        matriz curConstraint;
-        u_row_t product;
-        double suma;
         DBGPRINT("Sensitivity");
         DBGVAR(nTask);
         DBGVAR(exactConstraints.size());
@@ -221,47 +221,32 @@ namespace RTSim {
         DBGVECTOR(wcet);
         DBGPRINT("period");
         DBGVECTOR(period);
-        for (int i = 0; i < nTask; i++) {
-            curConstraint = exactConstraints[i];
-            DBGPRINT("curConstraints");
-            for (unsigned row = 0; row < curConstraint.size(); row++) {
-                DBGVAR(row);
-                DBGVECTOR(curConstraint[row]);
-            }
+
+        // The constraints of the servers with higher priority than task
+        // have a null coefficient for it, so they do not bound lambda
+        double minimo = 0;
+        for (int i = task; i < nTask; i++) {
+            const matriz &curConstraint = exactConstraints[i];
+            product.clear();
             for (unsigned row = 0; row < curConstraint.size(); row++) {
-                suma = 0;
+                double suma = 0;
                 for (int col = 0; col < nTask; col++) {
                     suma += curConstraint[row][col] * U[col];
                 }
-                product.push_back(suma);
-            }
-            for (unsigned col = 0; col < product.size(); col++) {
-                product[col] = 1 - product[col];
-            }
-            for (unsigned row = 0; row < product.size(); row++) {
                 if (curConstraint[row][task] == 0)
-                    product[row] = 100000000;
+                    product.push_back(100000000);
                 else
-                    product[row] = product[row] / curConstraint[row][task];
+                    product.push_back((1 - suma) / curConstraint[row][task]);
             }
             DBGPRINT("Product after dividing by curConstraint");
             DBGVECTOR(product);
             double maximo = 0;
-            for (int i = 0; i < (int) product.size(); i++) {
-                if (maximo < product[i])
-                    maximo = product[i];
+            for (int h = 0; h < (int) product.size(); h++) {
+                if (maximo < product[h])
+                    maximo = product[h];
             }
-            lambdaVec.push_back(maximo);
-            // DBGVAR(maximo);
-            product.clear();
-        }
-        double minimo = lambdaVec[0];
-        DBGPRINT("lambdaVec");
-        DBGVECTOR(lambdaVec);
-        for (int i = 0; i < (int) lambdaVec.size(); i++) {
-            if (minimo > lambdaVec[i])
-                minimo = lambdaVec[i];
-            // DBGVAR(minimo);
+            if (i == task || minimo > maximo)
+                minimo = maximo;
         }
         // DBGVAR(minimo);
         return (minimo);
@@ -270,6 +255,7 @@ namespace RTSim {
     void SchedPoint::updateU(int task, Tick req) {
         wcet[task] = req;
         U[task] = double(double(wcet[task]) / double(period[task]));
+        analysis.setWCET(task, req);
     }
     void SchedPoint::newRun() {
         last_change_time = 0;
@@ -15,6 +15,12 @@ namespace RTSim {
     void SchedRTA::addServer(Server *s) {
         servers.push_back(ServerInfo(s));
         std::sort(servers.begin(), servers.end(), less_rm);
+
+        // priorities may have changed, restart the analysis
+        analysis.clear();
+        for (const ServerInfo &si : servers)
+            analysis.addLevel(si.Q, si.P);
+
         Tick cc = s->getBudget();
         Tick pp = s->getPeriod();
         DBGVAR(cc);
@@ -28,23 +34,9 @@ namespace RTSim {
 
     SchedRTA::~SchedRTA() {}
 
-    Tick SchedRTA::computeResponseTime(int i) const {
-        Tick r_cur;
-        Tick r_new = servers[i].Q;
-        do {
-            r_cur = r_new;
-            r_new = servers[i].Q;
-            for (int j = 0; j < i; ++j)
-                // This is a ceil()
-                r_new += (r_cur + servers[j].P - 1) / int(servers[j].P) *
-                         servers[j].Q;
-        } while (r_new > r_cur && r_new <= servers[i].P);
-        return r_new;
-    }
-
     void SchedRTA::updateResponseTimes() {
         for (int i = 0; i < (int) servers.size(); ++i) {
-            servers[i].R = computeResponseTime(i);
+            servers[i].R = analysis.getResponseTime(i);
             // DBGVAR(servers[i].R);
         }
     }
@@ -52,48 +44,15 @@ namespace RTSim {
     bool SchedRTA::tryBudget(int i, Tick b) {
         //      DBGENTER(_SERVER_DBG_LEV);
 
-        Tick old_b = servers[i].Q;
-        servers[i].Q = b;
-        for (int h = 0; h < i + 1; h++) {
-            DBGVAR(servers[h].Q);
-            DBGVAR(servers[h].P);
-            DBGVAR(U[h]);
-        }
-        bool schedules = computeResponseTime(i) <= servers[i].P;
-        for (int j = i + 1; schedules && j < (int) servers.size(); ++j) {
-            schedules = computeResponseTime(j) <= servers[j].P;
-            DBGVAR(j);
-            DBGVAR(computeResponseTime(j));
-            DBGVAR(servers[j].Q);
-            DBGVAR(servers[j].P);
-        }
-        servers[i].Q = old_b;
+        bool schedules = analysis.tryWCET(i, b);
         DBGVAR(schedules);
         DBGVAR(b);
         return schedules;
     }
 
-    Tick SchedRTA::searchBudget(int i, Tick b1, Tick b2) {
-        if (b1 == b2)
-            return b1;
-
-        if (b2 == b1 + 1) {
-            if (tryBudget(i, b2))
-                return b2;
-            else
-                return b1;
-        }
-
-        Tick b = (b1 + b2) / 2;
-        if (tryBudget(i, b))
-            return searchBudget(i, b, b2);
-        else
-            return searchBudget(i, b1, b);
-    }
-
     Tick SchedRTA::searchBudget(int i) {
         //        DBGENTER(_SERVER_DBG_LEV);
-        Tick budget = searchBudget(i, servers[i].Q, servers[i].P);
+        Tick budget = analysis.getMaxWCET(i, servers[i].P);
         DBGVAR(budget);
         return budget;
     }
@@ -111,6 +70,7 @@ namespace RTSim {
             new_b = max_b;
         servers[i].p_server->changeBudget(new_b);
         servers[i].Q = new_b;
+        analysis.setWCET(i, new_b);
         return new_b - cur_b;
     }
 
@@ -125,6 +85,7 @@ namespace RTSim {
         wcet[task] = req;
         U[task] = double(double(wcet[task]) / double(period[task]));
         servers[task].Q = req;
+        analysis.setWCET(task, req);
     }
 
     void SchedRTA::newRun() {}
@@ -30,6 +30,7 @@ namespace RTSim {
     }
 
     void EDFModel::changePriority(Tick p) {
+        checkNotQueued();
         if (p == _rtTask->getDeadline())
             extP = false;
         else {
@@ -68,12 +69,6 @@ namespace RTSim {
         double utilization = 0.0;
         double capacity = c->getSpeed();
 
-        if (toBeAdmitted->getWCET(capacity) == 0.0)
-            std::cout << "" << toBeAdmitted->getWCET(capacity);
-        printf("\t\t\tEDFSched::isAdmissible WCET %.17g cap %f speed %f\n",
-               toBeAdmitted->getWCET(capacity), capacity,
-               double(c->getSpeed()));
-
         for (AbsRTTask *t : tasks) {
             utilization += t->getWCET(capacity) / double(t->getPeriod());
         }
@@ -205,12 +205,16 @@ namespace RTSim {
     }
 
     void MultiCoresScheds::insertTask(AbsRTTask *task, CPU *cpu) {
+        DBGENTER(_MULTISCHED_DBG_LEV);
         try {
             _queues[cpu]->insert(task);
+            if (_utilizations.contains(task))
+                _utilizations.migrate(task, cpu);
+            else
+                _utilizations.addTask(cpu, task);
         } catch (RTSchedExc &e) {
             // core schedulers/queues do not know tasks until this point
-            std::cout << "Receiving this error once per task is ok"
-                      << std::endl;
+            DBGPRINT("Receiving this error once per task is ok");
             addTask(task, cpu, "");
             insertTask(task, cpu);
         }
@@ -253,13 +257,12 @@ namespace RTSim {
     }
 
     void MultiCoresScheds::onEnd(AbsRTTask *t, CPU *cpu) {
+        DBGENTER(_MULTISCHED_DBG_LEV);
         assert(cpu != nullptr);
         assert(t != nullptr);
 
-        std::cout << "\t" << cpu->getName()
-                  << " has now wl: " << cpu->getWorkload()
-                  << ", speed: " << cpu->getSpeed() << std::endl
-                  << std::endl;
+        DBGPRINT("\t", cpu->getName(), " has now wl: ", cpu->getWorkload(),
+                 ", speed: ", cpu->getSpeed());
 
         // check if there is consistency still
         AbsRTTask *tt = getRunningTask(cpu);
@@ -271,12 +274,12 @@ namespace RTSim {
 
     void MultiCoresScheds::onMigrationFinished(AbsRTTask *task, CPU *original,
                                                CPU *final) {
+        DBGENTER(_MULTISCHED_DBG_LEV);
         assert(task != nullptr);
         assert(original != nullptr);
         assert(final != nullptr);
-        std::cout << "\t\tMCS::" << __func__ << "() migrate "
-                  << task->toString() << " from " << original->toString()
-                  << " to " << final->toString() << std::endl;
+        DBGPRINT("\t\tMCS::", __func__, "() migrate ", task->toString(),
+                 " from ", original->toString(), " to ", final->toString());
 
         try {
             removeFromQueue(original, task);
@@ -357,6 +360,8 @@ namespace RTSim {
         assert(task != nullptr);
         if (_queues[cpu]->isFound(task))
             _queues[cpu]->extract(task);
+        if (_utilizations.getProcessor(task) == cpu)
+            _utilizations.removeTask(task);
         dropEvt(cpu, task);
     }
 
@@ -408,14 +413,14 @@ namespace RTSim {
     }
 
     void MultiCoresScheds::yield(CPU *cpu) {
+        DBGENTER(_MULTISCHED_DBG_LEV);
         assert(cpu != nullptr); // running task might have already ended
 
-        std::cout << "\tCore status: " << _queues[cpu]->toString() << std::endl;
+        DBGPRINT("\tCore status: ", _queues[cpu]->toString());
         AbsRTTask *nextReady = getFirstReady(cpu);
         if (nextReady != nullptr) {
             // todo remove
-            std::cout << "\tYielding in favour of " << nextReady->toString()
-                      << std::endl;
+            DBGPRINT("\tYielding in favour of ", nextReady->toString());
             AbsRTTask *runningTask = getRunningTask(cpu);
             if (runningTask != nullptr) {
                 makeReady(cpu);
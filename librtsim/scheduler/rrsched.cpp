@@ -100,13 +100,12 @@ namespace RTSim {
 
         if (model->isRoundExpired()) {
             DBGPRINT("Round expired");
-            _queue.erase(model);
+            dequeue(model);
             // todo temp
             std::cout << "\tRound expired for task " << model->toString()
                       << " => removed" << std::endl;
             if (model->isActive()) {
-                model->setInsertTime(SIMUL.getTime());
-                _queue.insert(model);
+                enqueue(model);
                 // todo temp
                 std::cout << "\tand then reinserted into queue" << std::endl;
             }
@@ -12,6 +12,8 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
 
 #include <iostream>
@@ -29,22 +31,28 @@ namespace RTSim {
     TaskModel::TaskModel(AbsRTTask *t) :
         _rtTask(t),
         active(false),
-        _insertTime(0)
+        _key{0, 0, 0},
+        _queued(false)
     // , _threshold(INT_MAX)
     {}
 
     TaskModel::~TaskModel() {}
 
+    void TaskModel::checkNotQueued() const {
+        if (_queued)
+            throw RTSchedExc("Cannot change the key of a queued task model");
+    }
+
+    void TaskModel::refreshKey(Tick insertTime) {
+        checkNotQueued();
+
+        _key.priority = getPriority();
+        _key.insertTime = insertTime;
+        _key.taskNumber = getTaskNumber();
+    }
+
     bool TaskModel::TaskModelCmp::operator()(TaskModel *a, TaskModel *b) const {
-        // Order by priority, then inserion time, and finally task number using
-        // tuple's partial ordering instead of writing our own (less error
-        // prone)
-        auto a_tuple = std::tuple(a->getPriority(), a->getInsertTime(),
-                                  a->getTaskNumber());
-        auto b_tuple = std::tuple(b->getPriority(), b->getInsertTime(),
-                                  b->getTaskNumber());
-
-        return a_tuple < b_tuple;
+        return a->_key < b->_key;
     }
 
     void TaskModel::setActive() {
@@ -79,12 +87,17 @@ namespace RTSim {
 
     /*-----------------------------------------------------------------*/
 
+    // Ids are never reused, so that the handle left in a task by a
+    // destroyed scheduler cannot match a new one
+    static std::atomic<uint64_t> next_sched_id(1);
+
     Scheduler::Scheduler() :
         Entity(""),
         _kernel(0),
         _queue(),
         _tasks(),
-        _currExe(0) {}
+        _currExe(0),
+        _schedId(next_sched_id++) {}
 
     Scheduler::~Scheduler() {}
 
@@ -93,9 +106,19 @@ namespace RTSim {
         if (find(task) != nullptr)
             throw RTSchedExc("Element already present");
         _tasks[task] = model;
+        task->_schedModels.emplace_back(_schedId, model);
     }
 
     TaskModel *Scheduler::find(AbsRTTask *task) const {
+        if (task == nullptr)
+            return nullptr;
+
+        // Fast path: the handle stored in the task
+        for (auto &h : task->_schedModels)
+            if (h.first == _schedId)
+                return h.second;
+
+        // Fallback on the map, for tasks without a handle
         auto mi = _tasks.find(task);
         if (mi == _tasks.end())
             return nullptr;
@@ -129,10 +152,8 @@ namespace RTSim {
             throw RTSchedExc("AbsRTTaskNotFound");
         }
 
-        model->setInsertTime(SIMUL.getTime());
         model->setActive();
-
-        _queue.insert(model);
+        enqueue(model);
     }
 
     void Scheduler::extract(AbsRTTask *task) { // throw(RTSchedExc, BaseExc) {
@@ -142,10 +163,27 @@ namespace RTSim {
         if (model == nullptr) // raise an exception
             throw RTSchedExc("AbsRTTask not found");
 
-        _queue.erase(model);
+        dequeue(model);
         model->setInactive();
     }
 
+    void Scheduler::enqueue(TaskModel *model) {
+        if (model->_queued)
+            return;
+
+        model->refreshKey(SIMUL.getTime());
+        _queue.insert(model);
+        model->_queued = true;
+    }
+
+    void Scheduler::dequeue(TaskModel *model) {
+        if (!model->_queued)
+            return;
+
+        _queue.erase(model);
+        model->_queued = false;
+    }
+
     int Scheduler::getPriority(AbsRTTask *task) const { // throw(RTSchedExc) {
         TaskModel *model = find(task);
         if (model == nullptr)
@@ -154,6 +192,14 @@ namespace RTSim {
         return model->getPriority();
     }
 
+    const TaskModel::SortKey &Scheduler::getSortKey(AbsRTTask *task) const {
+        TaskModel *model = find(task);
+        if (model == nullptr)
+            throw RTSchedExc("AbsRTTask not found");
+
+        return model->getKey();
+    }
+
     // NOTE: deprecated
     // int Scheduler::getThreshold(AbsRTTask *task) { // throw(RTSchedExc) {
     //     TaskModel *model = find(task);
@@ -201,8 +247,20 @@ namespace RTSim {
     void Scheduler::discardTasks(bool f) {
         DBGENTER(_SCHED_DBG_LEVEL);
 
+        for (TaskModel *model : _queue)
+            model->_queued = false;
         _queue.clear();
 
+        // Drop the handles to the models in the tasks
+        for (auto [task, model] : _tasks) {
+            auto &h = task->_schedModels;
+            h.erase(std::remove_if(h.begin(), h.end(),
+                                   [this](const auto &x) {
+                                       return x.first == _schedId;
+                                   }),
+                    h.end());
+        }
+
         if (f) {
             // Free all task models
             for (auto [task, model] : _tasks) {
@@ -219,29 +277,28 @@ namespace RTSim {
     AbsRTTask *Scheduler::getTaskN(unsigned int n) {
         DBGENTER(_SCHED_DBG_LEVEL);
 
-        if (_queue.size() <= n) {
+        auto it = _queue.at(n);
+        if (it == _queue.end()) {
             return nullptr;
         }
 
-        // Jump to nth element in queue
-        auto it = _queue.begin();
-        std::advance(it, n);
         return (*it)->getTask();
     }
 
+    void Scheduler::getTopTasks(unsigned int m,
+                                std::vector<AbsRTTask *> &v) const {
+        for (auto it = _queue.begin(); m > 0 && it != _queue.end(); ++it, --m)
+            v.push_back((*it)->getTask());
+    }
+
     bool Scheduler::isFound(AbsRTTask *t) {
         TaskModel *model = find(t);
         return model != nullptr;
     }
 
     bool Scheduler::isInQueue(AbsRTTask *t) {
-        auto task_is_t = [t](TaskModel *model) {
-            return model->getTask() == t;
-        };
-
-        // If not found, returns the end of the queue
-        auto found = std::find_if(_queue.begin(), _queue.end(), task_is_t);
-        return found != _queue.end();
+        TaskModel *model = find(t);
+        return model != nullptr && _queue.contains(model);
     }
 
     void Scheduler::notify(AbsRTTask *task) {
@@ -254,6 +311,7 @@ namespace RTSim {
 
         for (auto [task, model] : _tasks) {
             model->setInactive();
+            model->_queued = false;
         }
     }
 
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iostream>
 
+#include <rtsim/fpanalysis.hpp>
 #include <rtsim/sparepot.hpp>
 
 namespace RTSim {
@@ -48,31 +49,18 @@ namespace RTSim {
 
         DBGPRINT("Now the vector is sorted, compute response times");
         // then compute response times
-        vector<double> response_time(server_vector.size());
-        response_time[0] = server_vector[0].wcet;
-
-        DBGVAR(response_time[0]);
+        FPAnalysis analysis;
+        for (const server_struct &ss : server_vector)
+            analysis.addLevel(ss.wcet, ss.period);
 
-        for (unsigned int i = 1; i < server_vector.size(); i++) {
+        vector<double> response_time(server_vector.size());
+        for (unsigned int i = 0; i < server_vector.size(); i++) {
             DBGVAR(i);
-            double rtime = server_vector[i].wcet;
-            double old_rtime = 0;
-            while (old_rtime != rtime) {
-                old_rtime = rtime;
-                rtime = server_vector[i].wcet;
-                for (unsigned int j = 0; j < i; j++)
-                    rtime +=
-                        ceil(old_rtime / (double) server_vector[j].period) *
-                        (double) server_vector[j].wcet;
-
-                if (rtime > (double) server_vector[i].period) {
-                    std::cerr << "Response time greater than period"
-                              << std::endl;
-                    exit(-1);
-                }
-                DBGVAR(rtime);
+            response_time[i] = double(analysis.getResponseTime(i));
+            if (i > 0 && response_time[i] > double(server_vector[i].period)) {
+                std::cerr << "Response time greater than period" << std::endl;
+                exit(-1);
             }
-            response_time[i] = rtime;
             DBGVAR(response_time[i]);
         }
 
@@ -9,6 +9,7 @@
 #include <rtsim/scheduler/rrsched.hpp>
 
 #include <metasim/factory.hpp>
+#include <metasim/partition.hpp>
 
 namespace RTSim {
     uptr<Scheduler> make_scheduler(const std::string &name) {
@@ -61,7 +62,9 @@ namespace RTSim {
 
     // TODO: Errors are not presented in a "nice" way to the user, especially
     // when the user simply forgot to set a required attribute!
-    System::System(const string &fname) {
+    System::System(const string &fname, bool parallel) {
+        using MetaSim::SimulationContext;
+
         const SystemDescriptor sys_des{fname};
 
         int cnt_cpus = 0;
@@ -88,9 +91,24 @@ namespace RTSim {
             // model, for homogeneous multiple-islands systems), since the
             // Models are now completely stateless. But oh well.
 
+            if (parallel) {
+                if (island_des.kernel.placement != "partitioned") {
+                    throw BaseExc("The parallel execution needs partitioned "
+                                  "islands, '" +
+                                  island_des.name + "' is not!");
+                }
+
+                for (size_t i = 0; i < island_des.numcpus; ++i)
+                    contexts.emplace_back(
+                        std::make_shared<SimulationContext>());
+            }
+
             model = make_model(sys_des.power_models, opps,
                                island_des.power_model, island_des.speed_model);
-            island = make_island(island_des.name, opps, model.get());
+            {
+                SimulationContext::Scope scope(getContext(cnt_cpus));
+                island = make_island(island_des.name, opps, model.get());
+            }
 
             cpu_models.emplace_back(model);
             islands.emplace_back(island);
@@ -111,9 +129,11 @@ namespace RTSim {
                 const std::string cpuname =
                     basename_cpu + std::to_string(cnt_cpus);
 
+                SimulationContext::Scope scope(getContext(cnt_cpus));
+
                 cpu = make_cpu(cpuname);
                 cpu->setIsland(island.get());
-                cpu->setWorkload("idle");
+                cpu->setWorkload(WorkloadId::IDLE);
 
                 if (island_des.kernel.placement == "partitioned") {
                     // One RTKernel for each CPU, with its own scheduler
@@ -154,4 +174,26 @@ namespace RTSim {
         }
     }
 
+    MetaSim::SimulationContext &System::getContext(size_t cpu) const {
+        if (contexts.empty())
+            return MetaSim::SimulationContext::current();
+        return *contexts.at(cpu);
+    }
+
+    void System::run(MetaSim::Tick duration) {
+        if (contexts.empty()) {
+            SIMUL.run(duration);
+            return;
+        }
+
+        std::vector<MetaSim::SimulationContext *> parts;
+        for (const auto &ctx : contexts)
+            parts.push_back(ctx.get());
+
+        // The partitions never send events to each other, a single
+        // window covers the whole run
+        MetaSim::PartitionedRunner runner(parts, MAXTICK);
+        runner.run(duration);
+    }
+
 } // namespace RTSim
@@ -63,7 +63,11 @@ namespace RTSim {
         deschedEvt(this),
         fakeArrEvt(this),
         killEvt(this),
-        deadEvt(this, false, false) {}
+        deadEvt(this, false, false) {
+        // Arrivals do not depend on the draws of other entities
+        if (int_time != nullptr)
+            int_time->setStream(getID());
+    }
 
     string Task::getStateString() {
         string s = std::to_string(double(SIMUL.getTime())) + " ";
@@ -260,6 +264,8 @@ namespace RTSim {
         unique_ptr<RandomVar> ret = std::move(int_time);
 
         int_time = std::move(iat);
+        if (int_time != nullptr)
+            int_time->setStream(getID());
         return ret;
     }
 
@@ -422,7 +428,7 @@ namespace RTSim {
         // handled.
         auto cpu = getCPU();
         if (cpu) {
-            cpu->setWorkload(Utils::getTaskWorkload(this));
+            cpu->setWorkload(Utils::getTaskWorkloadId(this), this);
         }
 
         (*actInstr)->schedule();
@@ -476,7 +482,7 @@ namespace RTSim {
         CPU *p = getCPU();
         if (!dynamic_cast<CPU *>(p))
             throw InstrExc("No CPU!", "Task::onInstrEnd()");
-        p->setWorkload("idle");
+        p->setWorkload(WorkloadId::IDLE);
 
         execdTime += (*actInstr)->getExecTime();
         actInstr++;
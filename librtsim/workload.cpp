@@ -0,0 +1,64 @@
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+// RTSim
+#include <rtsim/workload.hpp>
+
+namespace RTSim {
+
+    namespace {
+        // Names are kept in a deque, so that the references returned by
+        // getName() stay valid while new classes are interned
+        struct Registry {
+            std::mutex mtx;
+            std::deque<std::string> names;
+            std::unordered_map<std::string, WorkloadId::index_type> ids;
+
+            Registry() {
+                // Same order as WorkloadId::IDLE and WorkloadId::BUSY
+                add("idle");
+                add("busy");
+                ids.emplace("", 0);
+            }
+
+            WorkloadId::index_type add(const std::string &name) {
+                auto it = ids.find(name);
+                if (it != ids.end())
+                    return it->second;
+
+                WorkloadId::index_type index = names.size();
+                names.push_back(name);
+                ids.emplace(name, index);
+                return index;
+            }
+        };
+
+        Registry &registry() {
+            static Registry r;
+            return r;
+        }
+    } // namespace
+
+    const WorkloadId WorkloadId::IDLE(0, 0);
+    const WorkloadId WorkloadId::BUSY(1, 0);
+
+    WorkloadId::WorkloadId(const std::string &name) {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        _index = r.add(name);
+    }
+
+    const std::string &WorkloadId::getName() const {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        return r.names[_index];
+    }
+
+    size_t WorkloadId::count() {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        return r.names.size();
+    }
+
+} // namespace RTSim
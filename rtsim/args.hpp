@@ -121,6 +121,39 @@ static inline cmdarg::Options parse_arguments(int argc, char *argv[]) {
         .action = store_txt,
     });
 
+    parser.addArgument({
+        .long_opt = "event-queue",
+        .required = false,
+        .parameter_required = cmdarg::Argument::ParameterRequired::REQUIRED,
+        .help = "The event queue implementation (set, heap or calendar)",
+        .default_value = "",
+    });
+    parser.addArgument({
+        .long_opt = "batch",
+        .required = false,
+        .parameter_required = cmdarg::Argument::ParameterRequired::NO,
+        .help = "Executes simultaneous events in batches",
+        .default_value = "false",
+        .action = cmdarg::actions::store_true,
+    });
+    parser.addArgument({
+        .long_opt = "parallel",
+        .required = false,
+        .parameter_required = cmdarg::Argument::ParameterRequired::NO,
+        .help = "Executes each CPU of a partitioned system on its own thread "
+                "(no resources, traces, debug prints or profile)",
+        .default_value = "false",
+        .action = cmdarg::actions::store_true,
+    });
+    parser.addArgument({
+        .long_opt = "profile",
+        .required = false,
+        .parameter_required = cmdarg::Argument::ParameterRequired::REQUIRED,
+        .help = "The file name where to store a profile of the event engine "
+                "(either csv or json)",
+        .default_value = "",
+    });
+
     return parser.parse(argc, argv);
 }
 
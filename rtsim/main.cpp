@@ -57,7 +57,7 @@ struct placement_t {
 
 using TaskSet = std::vector<placement_t>;
 
-TaskSet read_taskset(const std::string &tset_file) {
+TaskSet read_taskset(const std::string &tset_file, const RTSim::System &sys) {
     yaml::Object_ptr tset_spec = yaml::parse(tset_file);
 
     TaskSet taskset;
@@ -81,6 +81,9 @@ TaskSet read_taskset(const std::string &tset_file) {
 
         int startcpu = str_startcpu.length() ? std::stoi(str_startcpu) : 0;
 
+        // The task (and its server) belong to the context of its CPU
+        MetaSim::SimulationContext::Scope scope(sys.getContext(startcpu));
+
         auto iat = str_iat.length() ? Tick(std::stol(str_iat)) : Tick(0);
         auto deadline = str_deadline.length() ? Tick(std::stol(str_deadline)) : iat;
         auto cbs_runtime =
@@ -121,7 +124,7 @@ TaskSet read_taskset(const std::string &tset_file) {
 }
 
 std::unique_ptr<RTSim::ResManager>
-    read_resources(const std::string &tset_file) {
+    read_resources(const std::string &tset_file, bool parallel) {
     yaml::Object_ptr tset_spec = yaml::parse(tset_file);
 
     auto resources = std::make_unique<RTSim::FCFSResManager>();
@@ -133,6 +136,12 @@ std::unique_ptr<RTSim::ResManager>
         // TODO: more general specification in YML for any kind of resource
         int n_initial = str_initial_state == "locked" ? 0 : 1;
 
+        if (parallel) {
+            std::cerr << "Cannot share resources among parallel CPUs: "
+                      << str_name << std::endl;
+            throw std::exception{};
+        }
+
         if (!resources->hasResource(str_name)) {
             resources->addResource(str_name, 1, n_initial);
         } else {
@@ -192,7 +201,23 @@ struct Tracer {
 int main(int argc, char *argv[]) {
     auto opts = parse_arguments(argc, argv);
 
+    const bool parallel = opts["parallel"] == "true";
+    if (parallel && (!opts["trace"].empty() || opts["debug"] == "true" ||
+                     !opts["profile"].empty())) {
+        std::cerr << "Error: argument --parallel: traces, debug prints and "
+                     "profile are not supported!"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
     MetaSim::Simulation &simulation = MetaSim::Simulation::getInstance();
+    simulation.setEventQueue(opts["event-queue"]);
+    simulation.setBatching(opts["batch"] == "true");
+
+    if (!opts["profile"].empty()) {
+        simulation.getProfiler().setOutput(opts["profile"]);
+        simulation.getProfiler().enable();
+    }
 
     if (opts["debug"] == "true") {
         simulation.dbg.enable("All");
@@ -204,14 +229,18 @@ int main(int argc, char *argv[]) {
         tracers.emplace_back(fname);
     }
 
-    RTSim::System sys{opts["system"]};
+    RTSim::System sys{opts["system"], parallel};
+    for (auto &ctx : sys.contexts) {
+        ctx->getSimulation().setEventQueue(opts["event-queue"]);
+        ctx->getSimulation().setBatching(opts["batch"] == "true");
+    }
 
-    auto resmanager = read_resources(opts["taskset"]);
+    auto resmanager = read_resources(opts["taskset"], parallel);
     for (auto &kernel : sys.kernels) {
         kernel->setResManager(resmanager.get());
     }
 
-    TaskSet taskset = read_taskset(opts["taskset"]);
+    TaskSet taskset = read_taskset(opts["taskset"], sys);
     for (auto &[tasksrv, cpu] : taskset) {
         if (tasksrv.getServer()) {
             sys.cpus[cpu]->getKernel()->addTask(*tasksrv.getServer());
@@ -230,7 +259,7 @@ int main(int argc, char *argv[]) {
     }
 
     try {
-        simulation.run(std::stoi(opts["duration"]));
+        sys.run(std::stoi(opts["duration"]));
     } catch (std::exception &e) {
         std::cerr << "EXCEPTION: " << e.what() << std::endl;
         std::cerr << "TERMINATING!" << std::endl;
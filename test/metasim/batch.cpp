@@ -0,0 +1,80 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::BatchHook;
+using MetaSim::Entity;
+using MetaSim::Event;
+using MetaSim::GEvent;
+using MetaSim::Simulation;
+using MetaSim::SimulationContext;
+using MetaSim::Tick;
+
+// Three periodic events that fire together; the first one drops
+// the last one at every other period, and each of them requests
+// the same end-of-batch hook
+class Burst : public Entity, public BatchHook {
+public:
+    Burst() :
+        Entity("burst"),
+        _a("a", this, &Burst::onEvent),
+        _b("b", this, &Burst::onEvent),
+        _c("c", this, &Burst::onEvent) {}
+
+    void newRun() override {
+        _a.post(10);
+        _b.post(10);
+        _c.post(10);
+    }
+    void endRun() override {}
+
+    void onEvent(Event *e) {
+        _log.push_back(e == &_a ? "a" : e == &_b ? "b" : "c");
+        if (e == &_a && SIMUL.getTime() == Tick(20))
+            _c.drop();
+        if (!SIMUL.deferToEndOfBatch(this))
+            _log.push_back("immediate");
+
+        e->post(SIMUL.getTime() + 10);
+    }
+
+    void onEndOfBatch() override {
+        _log.push_back("hook");
+    }
+
+    std::vector<std::string> _log;
+
+private:
+    GEvent<Burst> _a, _b, _c;
+};
+
+TEST(Simulation, BatchedStepping) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+
+    Burst burst;
+    SIMUL.setBatching(true);
+    SIMUL.initRuns();
+    SIMUL.initSingleRun();
+
+    EXPECT_EQ(SIMUL.sim_batch(), Tick(10));
+    EXPECT_EQ(burst._log,
+              (std::vector<std::string>{"a", "b", "c", "hook"}));
+
+    burst._log.clear();
+    EXPECT_EQ(SIMUL.sim_batch(), Tick(20));
+    EXPECT_EQ(burst._log, (std::vector<std::string>{"a", "b", "hook"}));
+
+    // Without batching, the hook is never deferred
+    SIMUL.setBatching(false);
+    burst._log.clear();
+    SIMUL.sim_step();
+    EXPECT_EQ(burst._log, (std::vector<std::string>{"a", "immediate"}));
+
+    SIMUL.endSingleRun();
+}
@@ -0,0 +1,80 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Entity;
+using MetaSim::GEvent;
+using MetaSim::Simulation;
+using MetaSim::SimulationContext;
+using MetaSim::Tick;
+
+// An entity that wakes up periodically and records the wake-up times
+class Ticker : public Entity {
+public:
+    Ticker(Tick period) :
+        Entity("ticker"),
+        _period(period),
+        _evt("tick", this, &Ticker::onTick) {}
+
+    void newRun() override {
+        _times.clear();
+        _evt.post(_period);
+    }
+
+    void endRun() override {}
+
+    void onTick(MetaSim::Event *) {
+        _times.push_back(SIMUL.getTime());
+        _evt.post(SIMUL.getTime() + _period);
+    }
+
+    std::vector<Tick> _times;
+
+private:
+    Tick _period;
+    GEvent<Ticker> _evt;
+};
+
+static std::vector<Tick> run_in_context(SimulationContext &ctx, Tick period) {
+    SimulationContext::Scope scope(ctx);
+
+    Ticker t(period);
+    SIMUL.run(1000);
+
+    EXPECT_EQ(&SIMUL, &ctx.getSimulation());
+    EXPECT_EQ(Entity::_find("ticker"), &t);
+    return t._times;
+}
+
+TEST(SimulationContext, IndependentThreads) {
+    std::vector<Tick> res1, res2;
+
+    std::thread t1([&res1] {
+        SimulationContext ctx;
+        res1 = run_in_context(ctx, 7);
+    });
+    std::thread t2([&res2] {
+        SimulationContext ctx("calendar");
+        res2 = run_in_context(ctx, 13);
+    });
+    t1.join();
+    t2.join();
+
+    // The first event past the end of the simulation is processed too
+    ASSERT_EQ(res1.size(), 1000u / 7 + 1);
+    ASSERT_EQ(res2.size(), 1000u / 13 + 1);
+    for (int i = 0; i < int(res1.size()); ++i)
+        EXPECT_EQ(res1[i], Tick(7 * (i + 1)));
+    for (int i = 0; i < int(res2.size()); ++i)
+        EXPECT_EQ(res2[i], Tick(13 * (i + 1)));
+
+    // Nothing leaked into the default context
+    EXPECT_EQ(&SIMUL, &SimulationContext::getDefault().getSimulation());
+    EXPECT_EQ(Entity::_find("ticker"), nullptr);
+}
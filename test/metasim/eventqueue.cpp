@@ -0,0 +1,85 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/event.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Event;
+using MetaSim::Simulation;
+using MetaSim::Tick;
+
+class RecordEvt : public Event {
+public:
+    RecordEvt(int id, int prio, std::vector<int> &log) :
+        Event("RecordEvt", prio),
+        _id(id),
+        _log(log) {}
+
+    void doit() override {
+        _log.push_back(_id);
+    }
+
+private:
+    int _id;
+    std::vector<int> &_log;
+};
+
+// Posts a mix of events with clustered times and random priorities, drops
+// some of them and reposts some others, then returns the order in which the
+// remaining events are triggered.
+static std::vector<int> run_with_queue(const std::string &type) {
+    auto &simulation = Simulation::getInstance();
+    simulation.clearEventQueue();
+    simulation.setEventQueue(type);
+
+    std::vector<int> log;
+    std::vector<std::unique_ptr<RecordEvt>> events;
+
+    unsigned long seed = 12345;
+    auto rnd = [&seed](int n) {
+        seed = (seed * 1103515245 + 12345) % 2147483648UL;
+        return int(seed % n);
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+        events.emplace_back(
+            std::make_unique<RecordEvt>(i, 8 + rnd(3) - 1, log));
+        events.back()->post(Tick(rnd(50) * 10 + rnd(2) * 1000));
+    }
+
+    for (int i = 0; i < 2000; i += 3)
+        events[i]->drop();
+
+    for (int i = 0; i < 2000; i += 9)
+        events[i]->post(Tick(rnd(5000)));
+
+    while (Event::getFirst() != NULL)
+        simulation.sim_step();
+
+    simulation.clearEventQueue();
+    return log;
+}
+
+TEST(EventQueue, SameOrderOnAllBackends) {
+    auto expected = run_with_queue("set");
+    EXPECT_EQ(expected.size(), 2000u - 667u + 223u);
+
+    EXPECT_EQ(run_with_queue("heap"), expected);
+    EXPECT_EQ(run_with_queue("calendar"), expected);
+
+    Simulation::getInstance().setEventQueue("");
+}
+
+TEST(EventQueue, ReplaceNonEmptyQueue) {
+    std::vector<int> log;
+    RecordEvt e(0, Event::_DEFAULT_PRIORITY, log);
+
+    e.post(Tick(10));
+    EXPECT_THROW(Simulation::getInstance().setEventQueue("heap"), Event::Exc);
+    e.drop();
+
+    EXPECT_THROW(Simulation::getInstance().setEventQueue("unknown"),
+                 MetaSim::EventQueue::Exc);
+}
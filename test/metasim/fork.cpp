@@ -0,0 +1,71 @@
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Entity;
+using MetaSim::Event;
+using MetaSim::GEvent;
+using MetaSim::Simulation;
+using MetaSim::SimulationContext;
+using MetaSim::Tick;
+
+// Counts its own periodic wake-ups
+class Counter : public Entity {
+public:
+    Counter() : Entity("counter"), _evt("tick", this, &Counter::onTick) {}
+
+    void newRun() override {
+        _count = 0;
+        _evt.post(_period);
+    }
+    void endRun() override {}
+
+    void onTick(Event *) {
+        ++_count;
+        _evt.post(SIMUL.getTime() + _period);
+    }
+
+    int _count = 0;
+    Tick _period = 10;
+
+private:
+    GEvent<Counter> _evt;
+};
+
+TEST(Simulation, ForkFromCheckpoint) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+
+    Counter c;
+    SIMUL.initRuns();
+    SIMUL.initSingleRun();
+    SIMUL.run_to(500);
+    ASSERT_EQ(c._count, 50);
+
+    // Each child changes the period after the common prefix and
+    // reports its count through the exit status
+    std::vector<pid_t> children;
+    for (int i = 1; i <= 2; ++i) {
+        pid_t pid = SIMUL.fork();
+        if (pid == 0) {
+            c._period = 10 * (i + 1);
+            SIMUL.continueRun(1000);
+            _exit(c._count);
+        }
+        children.push_back(pid);
+    }
+
+    // The wake-up at 510 was posted before the fork; the run stops
+    // after the first wake-up past 1000
+    EXPECT_EQ(Simulation::waitFork(children[0]), 50 + 25 + 1);
+    EXPECT_EQ(Simulation::waitFork(children[1]), 50 + 17 + 1);
+
+    // The parent still holds the checkpoint
+    EXPECT_EQ(c._count, 50);
+    SIMUL.continueRun(1000);
+    EXPECT_EQ(c._count, 100);
+}
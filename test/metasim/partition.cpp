@@ -0,0 +1,133 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/partition.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Entity;
+using MetaSim::Event;
+using MetaSim::GEvent;
+using MetaSim::PartitionedRunner;
+using MetaSim::Simulation;
+using MetaSim::SimulationContext;
+using MetaSim::Tick;
+
+// Wakes up periodically; if it has a peer, every wake-up also
+// sends a message to the peer's partition, 'delay' ticks later
+class Node : public Entity {
+public:
+    Node(Tick period) :
+        Entity("node"),
+        _period(period),
+        _tick("tick", this, &Node::onTick) {}
+
+    void newRun() override {
+        _times.clear();
+        _received.clear();
+        _tick.post(_period);
+    }
+    void endRun() override {}
+
+    void onTick(Event *) {
+        _times.push_back(SIMUL.getTime());
+        _tick.post(SIMUL.getTime() + _period);
+        if (_runner != nullptr) {
+            auto *msg = new GEvent<Node>("msg", _peer, &Node::onMessage);
+            _runner->send(_peerPartition, msg, SIMUL.getTime() + _delay,
+                          true);
+        }
+    }
+
+    void onMessage(Event *) {
+        _received.push_back(SIMUL.getTime());
+    }
+
+    std::vector<Tick> _times;
+    std::vector<Tick> _received;
+
+    PartitionedRunner *_runner = nullptr;
+    Node *_peer = nullptr;
+    int _peerPartition = 0;
+    Tick _delay = 0;
+
+private:
+    Tick _period;
+    GEvent<Node> _tick;
+};
+
+TEST(PartitionedRunner, IndependentPartitions) {
+    const std::vector<int> periods{7, 11, 13};
+
+    // Reference: each partition alone, sequentially
+    std::vector<std::vector<Tick>> expected;
+    for (int p : periods) {
+        SimulationContext ctx;
+        SimulationContext::Scope scope(ctx);
+        Node n(p);
+        SIMUL.initRuns();
+        SIMUL.initSingleRun();
+        SIMUL.advance(1000);
+        expected.push_back(n._times);
+        SIMUL.endSingleRun();
+    }
+
+    std::vector<std::unique_ptr<SimulationContext>> ctx;
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<SimulationContext *> parts;
+    for (int p : periods) {
+        ctx.emplace_back(new SimulationContext());
+        SimulationContext::Scope scope(*ctx.back());
+        nodes.emplace_back(new Node(p));
+        parts.push_back(ctx.back().get());
+    }
+
+    PartitionedRunner runner(parts, MAXTICK);
+    runner.run(1000);
+    EXPECT_EQ(runner.getWindows(), 1u);
+    for (size_t i = 0; i < periods.size(); ++i)
+        EXPECT_EQ(nodes[i]->_times, expected[i]);
+
+    // Objects of the model must die before their context
+    nodes.clear();
+}
+
+TEST(PartitionedRunner, MessagesBetweenPartitions) {
+    std::vector<std::unique_ptr<SimulationContext>> ctx;
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<SimulationContext *> parts;
+    for (int p : {10, 15}) {
+        ctx.emplace_back(new SimulationContext());
+        SimulationContext::Scope scope(*ctx.back());
+        nodes.emplace_back(new Node(p));
+        parts.push_back(ctx.back().get());
+    }
+
+    PartitionedRunner runner(parts, 5);
+    for (int i = 0; i < 2; ++i) {
+        nodes[i]->_runner = &runner;
+        nodes[i]->_peer = nodes[1 - i].get();
+        nodes[i]->_peerPartition = 1 - i;
+        nodes[i]->_delay = 5;
+    }
+
+    runner.run(100);
+
+    std::vector<Tick> from0, from1;
+    for (Tick t = 10; t < 100; t += 10)
+        from0.push_back(t + 5);
+    for (Tick t = 15; t < 100; t += 15)
+        from1.push_back(t + 5);
+
+    EXPECT_EQ(nodes[1]->_received, from0);
+    EXPECT_EQ(nodes[0]->_received, from1);
+
+    // Sending with less than the lookahead is an error
+    nodes[0]->_delay = 1;
+    EXPECT_THROW(runner.run(100), PartitionedRunner::Exc);
+
+    nodes.clear();
+}
@@ -0,0 +1,47 @@
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/plist.hpp>
+
+TEST(IndexedPriorityList, SameAsSet) {
+    indexed_priority_list<int> list;
+    std::set<int> reference;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> value(0, 199);
+
+    for (int i = 0; i < 2000; ++i) {
+        int x = value(gen);
+        if (gen() % 3 == 0) {
+            list.erase(x);
+            reference.erase(x);
+        } else {
+            EXPECT_EQ(list.insert(x).second, reference.insert(x).second);
+        }
+
+        ASSERT_EQ(list.size(), reference.size());
+        EXPECT_EQ(list.contains(x), reference.count(x) == 1);
+        EXPECT_EQ(list.rank(x),
+                  size_t(std::distance(reference.begin(),
+                                       reference.lower_bound(x))));
+    }
+
+    // Forward, backward and random access
+    std::vector<int> expected(reference.begin(), reference.end());
+    EXPECT_EQ(std::vector<int>(list.begin(), list.end()), expected);
+    EXPECT_EQ(std::vector<int>(std::make_reverse_iterator(list.end()),
+                               std::make_reverse_iterator(list.begin())),
+              std::vector<int>(expected.rbegin(), expected.rend()));
+    for (size_t n = 0; n < expected.size(); ++n)
+        EXPECT_EQ(*list.at(n), expected[n]);
+    EXPECT_EQ(list.at(expected.size()), list.end());
+    EXPECT_EQ(list.front(), expected.front());
+    EXPECT_EQ(list.back(), expected.back());
+
+    indexed_priority_list<int> copy = list;
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), expected);
+}
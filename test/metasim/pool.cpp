@@ -0,0 +1,76 @@
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/event.hpp>
+#include <metasim/pool.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Event;
+using MetaSim::Simulation;
+using MetaSim::SmallObjectPool;
+using MetaSim::Tick;
+
+class OneShotEvt : public Event {
+public:
+    OneShotEvt(int &count) : Event("OneShotEvt"), _count(count) {}
+    void doit() override {
+        ++_count;
+    }
+
+private:
+    int &_count;
+};
+
+TEST(SmallObjectPool, DisposedEventsAreRecycled) {
+    auto &simulation = Simulation::getInstance();
+    simulation.clearEventQueue();
+
+    int count = 0;
+
+    Event *e = new OneShotEvt(count);
+    void *first = e;
+    e->post(Tick(1), true);
+    simulation.sim_step();
+
+    // The block released by the disposed event is reused
+    e = new OneShotEvt(count);
+    EXPECT_EQ(static_cast<void *>(e), first);
+    EXPECT_EQ(e->toString(), "OneShotEvt");
+    e->post(Tick(2), true);
+    simulation.sim_step();
+
+    EXPECT_EQ(count, 2);
+    simulation.clearEventQueue();
+}
+
+TEST(SmallObjectPool, ExitedThreadsHandBackTheirBlocks) {
+    // A size class that no other object uses
+    const std::size_t size = SmallObjectPool::MAX_SIZE;
+    const int n = 100;
+
+    std::set<void *> freed;
+    std::thread([&] {
+        std::vector<void *> blocks;
+        for (int i = 0; i < n; ++i)
+            blocks.push_back(SmallObjectPool::allocate(size));
+        for (void *p : blocks) {
+            freed.insert(p);
+            SmallObjectPool::deallocate(p, size);
+        }
+    }).join();
+
+    // The blocks freed by the first thread are reused by the second one
+    std::vector<void *> reused;
+    std::thread([&] {
+        for (int i = 0; i < n; ++i)
+            reused.push_back(SmallObjectPool::allocate(size));
+        for (void *p : reused)
+            SmallObjectPool::deallocate(p, size);
+    }).join();
+
+    for (void *p : reused)
+        EXPECT_EQ(freed.count(p), 1u);
+}
@@ -0,0 +1,83 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::Entity;
+using MetaSim::Event;
+using MetaSim::GEvent;
+using MetaSim::Profiler;
+using MetaSim::Simulation;
+using MetaSim::SimulationContext;
+
+// Two events every 10 ticks; the second one is dropped and
+// re-posted by the first one
+class Pair : public Entity {
+public:
+    Pair() :
+        Entity("pair"),
+        _a("a", this, &Pair::onA),
+        _b("b", this, &Pair::onB) {}
+
+    void newRun() override {
+        _a.post(10);
+        _b.post(10);
+    }
+    void endRun() override {}
+
+    void onA(Event *) {
+        _b.drop();
+        _b.post(SIMUL.getTime());
+        _a.post(SIMUL.getTime() + 10);
+    }
+    void onB(Event *) {
+        _b.post(SIMUL.getTime() + 10);
+    }
+
+private:
+    GEvent<Pair> _a, _b;
+};
+
+TEST(Profiler, CountsEventsPerType) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+
+    Pair pair;
+    Profiler &prof = SIMUL.getProfiler();
+    EXPECT_FALSE(prof.isEnabled());
+    prof.enable();
+
+    SIMUL.run(95);
+
+    // All events are GEvent<Pair>. The run stops after a fires at
+    // tick 100: 10 fires of a, 9 of b. Each fire of a drops b and
+    // posts 2 events, each fire of b posts one event, and the 2
+    // events left in the queue are dropped at the end of the run.
+    auto stats = prof.getEventStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_NE(stats[0].name.find("GEvent<Pair>"), std::string::npos);
+    EXPECT_EQ(stats[0].fires, 19u);
+    EXPECT_EQ(stats[0].drops, 10u + 2u);
+    EXPECT_EQ(stats[0].posts, 2u + 20u + 9u);
+
+    EXPECT_EQ(prof.getFires(), 19u);
+    EXPECT_EQ(prof.getTicks(), 10u);
+    EXPECT_EQ(prof.getMaxEventsPerTick(), 2u);
+    EXPECT_GT(prof.getMaxQueueDepth(), 0u);
+
+    std::stringstream csv, json;
+    prof.printCSV(csv);
+    prof.printJSON(json);
+    EXPECT_NE(csv.str().find("fires,19"), std::string::npos);
+    EXPECT_NE(json.str().find("\"fires\": 19"), std::string::npos);
+
+    // Nothing is recorded while disabled
+    prof.reset();
+    prof.enable(false);
+    SIMUL.run(95);
+    EXPECT_TRUE(prof.getEventStats().empty());
+    EXPECT_EQ(prof.getFires(), 0u);
+}
@@ -0,0 +1,101 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/randomvar.hpp>
+#include <metasim/simul.hpp>
+
+using MetaSim::PhiloxGen;
+using MetaSim::RandomVar;
+using MetaSim::RandNum;
+using MetaSim::SimulationContext;
+
+TEST(PhiloxGen, KnownAnswer) {
+    // Known-answer tests of the Random123 library
+    uint32_t ctr[4] = {0, 0, 0, 0};
+    const uint32_t key[2] = {0, 0};
+    PhiloxGen::philox(ctr, key);
+    EXPECT_EQ(ctr[0], 0x6627e8d5u);
+    EXPECT_EQ(ctr[1], 0xe169c58du);
+    EXPECT_EQ(ctr[2], 0xbc57ac4cu);
+    EXPECT_EQ(ctr[3], 0x9b00dbd8u);
+
+    uint32_t ctr2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    const uint32_t key2[2] = {0xa4093822, 0x299f31d0};
+    PhiloxGen::philox(ctr2, key2);
+    EXPECT_EQ(ctr2[0], 0xd16cfe09u);
+    EXPECT_EQ(ctr2[1], 0x94fdccebu);
+    EXPECT_EQ(ctr2[2], 0x5001e420u);
+    EXPECT_EQ(ctr2[3], 0x24126ea1u);
+}
+
+TEST(PhiloxGen, StreamsDoNotDependOnInterleaving) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+
+    std::vector<RandNum> a, b;
+    PhiloxGen ga(1), gb(2);
+    for (int i = 0; i < 10; ++i)
+        a.push_back(ga.sample());
+    for (int i = 0; i < 10; ++i)
+        b.push_back(gb.sample());
+
+    // Same streams, interleaved draws
+    PhiloxGen ha(1), hb(2);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(hb.sample(), b[i]);
+        EXPECT_EQ(ha.sample(), a[i]);
+    }
+    EXPECT_NE(a, b);
+
+    // A new run restarts the streams on a different sequence, and
+    // re-seeding restarts the same runs again
+    RandomVar::newRun();
+    EXPECT_NE(ga.sample(), a[0]);
+    RandomVar::init(1);
+    EXPECT_EQ(ga.sample(), a[0]);
+    for (int i = 0; i < 10; ++i) {
+        RandNum x = ga.sample();
+        EXPECT_GE(x, 1);
+        EXPECT_LT(x, ga.getModule());
+    }
+}
+
+TEST(UniformVar, BlockGeneration) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+
+    // Without blocks, the sample is drawn once
+    MetaSim::ExponentialVar once(2);
+    once.setStream(7);
+    EXPECT_EQ(once.get(), once.get());
+
+    MetaSim::ExponentialVar a(2), b(2);
+    a.setStream(7);
+    b.setStream(7);
+    a.setBlockSize(256);
+    b.setBlockSize(16);
+
+    // The same stream gives the same variates with any block size
+    double sum = 0;
+    for (int i = 0; i < 10000; ++i) {
+        double x = a.get();
+        EXPECT_DOUBLE_EQ(x, b.get());
+        sum += x;
+    }
+    EXPECT_NEAR(sum / 10000, 0.5, 0.05);
+
+    MetaSim::NormalVar n(10, 2);
+    n.setStream(8);
+    n.setBlockSize(255);
+    double nsum = 0, nsq = 0;
+    for (int i = 0; i < 10000; ++i) {
+        double x = n.get();
+        nsum += x;
+        nsq += x * x;
+    }
+    double mean = nsum / 10000;
+    EXPECT_NEAR(mean, 10, 0.1);
+    EXPECT_NEAR(std::sqrt(nsq / 10000 - mean * mean), 2, 0.1);
+}
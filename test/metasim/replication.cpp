@@ -0,0 +1,73 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <metasim/basestat.hpp>
+#include <metasim/entity.hpp>
+#include <metasim/gevent.hpp>
+#include <metasim/randomvar.hpp>
+#include <metasim/replication.hpp>
+#include <metasim/simul.hpp>
+
+using namespace MetaSim;
+
+// A uniform variable that draws a new sample at each call
+class DrawVar : public RandomVar {
+public:
+    double get() override {
+        return double(_gen->sample()) / _gen->getModule();
+    }
+    double getMaximum() override {
+        return 1;
+    }
+    double getMinimum() override {
+        return 0;
+    }
+    CLONEABLE(RandomVar, DrawVar, override)
+};
+
+// Wakes up at random intervals and records the interval in a stat
+class Sampler : public Entity {
+public:
+    Sampler() : Entity("sampler"), _evt("sample", this, &Sampler::onSample) {}
+
+    void newRun() override {
+        _evt.post(Tick::ceil(_var.get() * 10));
+    }
+    void endRun() override {}
+
+    void onSample(Event *) {
+        double v = _var.get() * 10;
+        _stat.record(v);
+        _evt.post(SIMUL.getTime() + Tick::ceil(v));
+    }
+
+    StatMean _stat{"mean_interval"};
+
+private:
+    DrawVar _var;
+    GEvent<Sampler> _evt;
+};
+
+static std::shared_ptr<void> build_model() {
+    return std::make_shared<Sampler>();
+}
+
+TEST(ReplicationRunner, SameResultsWithAnyNumberOfWorkers) {
+    SimulationContext ctx;
+    SimulationContext::Scope scope(ctx);
+    auto model = std::static_pointer_cast<Sampler>(build_model());
+
+    ReplicationRunner(build_model, 1).run(1000, 10, 42);
+    double mean = model->_stat.getMean();
+    double conf = model->_stat.getConfInterval();
+    EXPECT_EQ(model->_stat.getExpNum(), 10u);
+    EXPECT_NEAR(mean, 5, 1);
+
+    ReplicationRunner(build_model, 4).run(1000, 10, 42);
+    EXPECT_EQ(model->_stat.getMean(), mean);
+    EXPECT_EQ(model->_stat.getConfInterval(), conf);
+
+    ReplicationRunner(build_model, 4).run(1000, 10, 43);
+    EXPECT_NE(model->_stat.getMean(), mean);
+}
@@ -0,0 +1,47 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/powermodel.hpp>
+#include <rtsim/system_descriptor.hpp>
+
+namespace RTSim::Mocks {
+    /// Power and speed of a workload class at an OPP
+    struct TBPoint {
+        double power;
+        double speed;
+    };
+
+    /// Returns the point of the given workload class at the OPP with the
+    /// given index
+    using TBTable = std::function<TBPoint(const std::string &, size_t)>;
+
+    /// Creates an island with a table-based model, with one entry for
+    /// each of the workload classes at each OPP
+    inline std::unique_ptr<CPUIsland>
+        createTBIsland(const std::string &name, const std::vector<OPP> &opps,
+                       const std::vector<std::string> &workloads,
+                       const TBTable &table) {
+        CPUMDescriptor d;
+        d.type = CPUModelTBParams::key;
+        for (const auto &wl : workloads) {
+            for (size_t i = 0; i < opps.size(); ++i) {
+                TBPoint point = table(wl, i);
+                auto p = std::make_unique<CPUModelTBParams>();
+                p->workload = wl;
+                p->freq = opps[i].frequency;
+                p->volt = opps[i].voltage;
+                p->power = point.power;
+                p->speed = point.speed;
+                d.params.push_back(std::move(p));
+            }
+        }
+
+        return std::make_unique<CPUIsland>(
+            std::vector<CPU *>{}, CPUIsland::Type::GENERIC, name, opps,
+            CPUModel::create(d, d, opps.back(), opps.back().frequency)
+                .release());
+    }
+} // namespace RTSim::Mocks
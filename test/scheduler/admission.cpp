@@ -0,0 +1,89 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <rtsim/admission.hpp>
+#include <rtsim/cpu.hpp>
+#include <rtsim/rttask.hpp>
+
+#include "../mocks/island.hpp"
+
+using RTSim::CPU;
+using RTSim::OPP;
+using RTSim::PeriodicTask;
+using RTSim::UtilizationTracker;
+using RTSim::WorkloadId;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+TEST(Scheduler, UtilizationTracker) {
+    // Four OPPs; with the bzip2 workload the speed grows linearly with the
+    // frequency
+    std::vector<OPP> opps = {{500, 1}, {1000, 1}, {1500, 1}, {2000, 1}};
+    auto island = createTBIsland(
+        "admission", opps, {"bzip2"}, [&](const std::string &, size_t i) {
+            return TBPoint{1, opps[i].frequency / 2000.0};
+        });
+    CPU c0("admission_cpu0", nullptr), c1("admission_cpu1", nullptr);
+    c0.setIsland(island.get());
+    c1.setIsland(island.get());
+
+    // | Task | WCET | Period |
+    // | :--: | :--: | :----: |
+    // |  0   |  20  |  100   |
+    // |  1   |  30  |  100   |
+    // |  2   |  20  |  100   |
+    //
+    // PeriodicTask has relative deadline = period, hence density =
+    // utilization
+    PeriodicTask t0(100, 100, 0, "admission_t0");
+    PeriodicTask t1(100, 100, 0, "admission_t1");
+    PeriodicTask t2(100, 100, 0, "admission_t2");
+    t0.insertCode("fixed(20,bzip2);");
+    t1.insertCode("fixed(30,bzip2);");
+    t2.insertCode("fixed(20,bzip2);");
+
+    UtilizationTracker tracker;
+    tracker.addTask(&c0, &t0);
+    tracker.addTask(&c0, &t1);
+    EXPECT_THROW(tracker.addTask(&c1, &t0), UtilizationTracker::Exc);
+
+    EXPECT_EQ(tracker.getNumTasks(&c0), 2);
+    EXPECT_EQ(tracker.getProcessor(&t1), &c0);
+    EXPECT_DOUBLE_EQ(tracker.getUtilization(&c0), 0.5);
+    EXPECT_DOUBLE_EQ(tracker.getUtilization(&c0, 0.5), 1.0);
+    EXPECT_DOUBLE_EQ(tracker.getDensity(&c0, 0.5), 1.0);
+    EXPECT_DOUBLE_EQ(tracker.getUtilization(&c1), 0.0);
+
+    // t2 does not need to be accounted to be tested
+    const WorkloadId bzip2("bzip2");
+    EXPECT_TRUE(tracker.isAdmissible(&c0, &t2, 0.75));
+    EXPECT_FALSE(tracker.isAdmissible(&c0, &t2, 0.5));
+    EXPECT_EQ(tracker.getMinOPP(&c0, &t2, bzip2), 2);
+    EXPECT_EQ(tracker.getMinOPP(&c0, &t2, bzip2, 3), 3);
+    EXPECT_EQ(UtilizationTracker::getMinOPP(&c0, 1.1, bzip2), opps.size());
+
+    tracker.migrate(&t1, &c1);
+    EXPECT_EQ(tracker.getProcessor(&t1), &c1);
+    EXPECT_DOUBLE_EQ(tracker.getUtilization(&c0), 0.2);
+    EXPECT_DOUBLE_EQ(tracker.getUtilization(&c1), 0.3);
+    EXPECT_EQ(tracker.getMinOPP(&c0, &t2, bzip2), 1);
+
+    tracker.removeTask(&t0);
+    EXPECT_FALSE(tracker.contains(&t0));
+    EXPECT_EQ(tracker.getNumTasks(&c0), 0);
+    EXPECT_EQ(tracker.getUtilization(&c0), 0.0);
+    EXPECT_EQ(tracker.getMinOPP(&c0, &t2, bzip2), 0);
+
+    // The tables used by the search match the CPU getters
+    const auto &table = island->getOPPTable("bzip2");
+    for (size_t i = 0; i < opps.size(); ++i) {
+        EXPECT_EQ(table.speed[i], c0.getSpeedByOPP(i, "bzip2"));
+        EXPECT_EQ(table.power[i], c0.getPowerByOPP(i, "bzip2"));
+    }
+
+    tracker.clear(&c1);
+    EXPECT_FALSE(tracker.contains(&t1));
+    EXPECT_THROW(tracker.migrate(&t1, &c0), UtilizationTracker::Exc);
+}
@@ -0,0 +1,105 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/kernel.hpp>
+#include <rtsim/scheduler/fpsched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using MetaSim::Tick;
+using RTSim::AbsRTTask;
+using RTSim::CPU;
+using RTSim::FPScheduler;
+using RTSim::RTKernel;
+using RTSim::Scheduler;
+using RTSim::Task;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+namespace {
+    // Counts the dispatches requested to the kernel
+    class CountingKernel : public RTKernel {
+    public:
+        using RTKernel::RTKernel;
+
+        void dispatch() override {
+            ++dispatches;
+            RTKernel::dispatch();
+        }
+
+        int dispatches = 0;
+    };
+
+    struct Outcome {
+        int dispatches;
+        size_t first;
+        std::vector<Tick> ends;
+    };
+
+    // Three tasks with different priorities arrive at the same time
+    Outcome simulate(bool batching) {
+        const std::string name = batching ? "batching_on" : "batching_off";
+        auto island = createTBIsland(
+            name, {{1000, 1}}, {"idle", "bzip2"},
+            [](const std::string &, size_t) { return TBPoint{1, 1}; });
+        CPU c(name + "_cpu", nullptr);
+        c.setIsland(island.get());
+
+        FPScheduler sched;
+        CountingKernel kernel(&sched, name + "_kernel", &c);
+
+        std::vector<std::unique_ptr<Task>> tasks;
+        for (int i = 0; i < 3; ++i) {
+            tasks.push_back(std::make_unique<Task>(
+                nullptr, 100, 0, name + "_t" + std::to_string(i)));
+            tasks.back()->insertCode("fixed(10,bzip2);");
+            kernel.addTask(*tasks.back(), std::to_string(3 - i));
+        }
+
+        auto &simulation = Simulation::getInstance();
+        simulation.setBatching(batching);
+        simulation.initSingleRun();
+
+        simulation.run_to(0);
+        for (auto &t : tasks)
+            t->activate(5);
+        simulation.run_to(5);
+
+        Outcome outcome{kernel.dispatches, tasks.size(), {}};
+        for (size_t i = 0; i < tasks.size(); ++i)
+            if (kernel.getCurrExe() == tasks[i].get())
+                outcome.first = i;
+
+        simulation.run_to(40);
+        for (auto &t : tasks)
+            outcome.ends.push_back(t->endEvt.getLastTime());
+
+        simulation.setBatching(false);
+        simulation.endSingleRun();
+        return outcome;
+    }
+} // namespace
+
+TEST(Scheduler, BatchedDispatch) {
+    Outcome batched = simulate(true);
+    Outcome unbatched = simulate(false);
+
+    // One dispatch for the three arrivals instead of one each
+    EXPECT_EQ(batched.dispatches, 1);
+    EXPECT_EQ(unbatched.dispatches, 3);
+
+    // Same schedule in both cases, the task with priority 1 first
+    EXPECT_EQ(batched.first, 2u);
+    EXPECT_EQ(unbatched.first, 2u);
+    EXPECT_EQ(batched.ends, (std::vector<Tick>{35, 25, 15}));
+    EXPECT_EQ(unbatched.ends, batched.ends);
+}
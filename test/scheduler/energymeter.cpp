@@ -0,0 +1,97 @@
+#include <memory>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/energymeter.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using RTSim::CPU;
+using RTSim::EnergyMeter;
+using RTSim::Task;
+using RTSim::WorkloadId;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+TEST(Scheduler, EnergyMeter) {
+    // Power of the island with one CPU running the workload (the other
+    // idle), the CPUs get half of the idle power each
+    //
+    // | Workload | OPP 0 | OPP 1 |
+    // | :------: | :---: | :---: |
+    // |   idle   |   2   |   4   |
+    // |  bzip2   |   1   |   3   |
+    auto island = createTBIsland(
+        "energymeter", {{500, 1}, {1000, 1}}, {"idle", "bzip2"},
+        [](const std::string &wl, size_t i) {
+            return TBPoint{wl == "idle" ? 2 + 2. * i : 1 + 2. * i, 1};
+        });
+    CPU c0("energymeter_cpu0", nullptr), c1("energymeter_cpu1", nullptr);
+    c0.setIsland(island.get());
+    c1.setIsland(island.get());
+
+    Task t0(nullptr, 100, 0, "energymeter_t0");
+    t0.insertCode("fixed(10,bzip2);");
+
+    EnergyMeter meter("energymeter");
+    meter.attach(island.get());
+    EXPECT_THROW(EnergyMeter("energymeter_other").attach(&c0),
+                 EnergyMeter::Exc);
+
+    auto &simulation = Simulation::getInstance();
+    simulation.initSingleRun();
+
+    std::stringstream trace;
+    meter.setTrace(&trace);
+
+    // | Interval | OPP | c0 (task)  | c0 power | c1 power |
+    // | :------: | :-: | :--------: | :------: | :------: |
+    // | [0, 10)  |  1  |    idle    |    2     |    2     |
+    // | [10, 30) |  1  | bzip2 (t0) |    5     |    2     |
+    // | [30, 40) |  0  | bzip2 (t0) |    2     |    1     |
+    // | [40, 50) |  0  |    idle    |    1     |    1     |
+    simulation.run_to(10);
+    c0.setWorkload(WorkloadId("bzip2"), &t0);
+    EXPECT_EQ(c0.getTask(), &t0);
+
+    simulation.run_to(20);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(&t0), 50);
+
+    simulation.run_to(30);
+    island->setOPP(0);
+
+    simulation.run_to(40);
+    c0.setWorkload(WorkloadId::IDLE);
+    EXPECT_EQ(c0.getTask(), nullptr);
+
+    simulation.run_to(50);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(&c0), 20 + 100 + 20 + 10);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(&c1), 60 + 20);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(island.get()), 230);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(), 230);
+    EXPECT_DOUBLE_EQ(meter.getEnergy(&t0), 100 + 20);
+    EXPECT_DOUBLE_EQ(meter.getAveragePower(&c0), 3);
+    EXPECT_DOUBLE_EQ(meter.getAveragePower(island.get()), 4.6);
+
+    // A disabled CPU consumes the idle power, no change here
+    c1.disable();
+    EXPECT_EQ(c1.getPower(), 1);
+
+    // One line per change of power: 10, 30 (both CPUs) and 40
+    std::string line;
+    int lines = 0;
+    while (std::getline(trace, line))
+        ++lines;
+    EXPECT_EQ(lines, 4);
+
+    meter.detach(&c1);
+    EXPECT_THROW(meter.getEnergy(&c1), EnergyMeter::Exc);
+    EXPECT_EQ(c1.getEnergyMeter(), nullptr);
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <rtsim/fpanalysis.hpp>
+#include <rtsim/schedpoints.hpp>
+
+using MetaSim::Tick;
+using RTSim::FPAnalysis;
+using RTSim::SchedPoint;
+
+// Response time of level i computed from scratch, as SchedRTA did
+static int64_t coldResponseTime(const std::vector<int64_t> &c,
+                                const std::vector<int64_t> &p, size_t i) {
+    int64_t r_cur, r_new = c[i];
+    do {
+        r_cur = r_new;
+        r_new = c[i];
+        for (size_t j = 0; j < i; ++j)
+            r_new += (r_cur + p[j] - 1) / p[j] * c[j];
+    } while (r_new > r_cur && r_new <= p[i]);
+    return r_new;
+}
+
+TEST(Scheduler, FPAnalysis) {
+    // | Level | WCET | Period | Response time |
+    // | :---: | :--: | :----: | :-----------: |
+    // |   0   |  1   |   4    |       1       |
+    // |   1   |  2   |   6    |       3       |
+    // |   2   |  3   |   13   |      10       |
+    FPAnalysis a;
+    a.addLevel(1, 4);
+    a.addLevel(2, 6);
+    a.addLevel(3, 13);
+
+    EXPECT_EQ(a.getResponseTime(0), 1);
+    EXPECT_EQ(a.getResponseTime(1), 3);
+    EXPECT_EQ(a.getResponseTime(2), 10);
+    EXPECT_EQ(a.getDeadline(2), 13);
+    EXPECT_THROW(a.addLevel(1, 0), FPAnalysis::Exc);
+
+    // With WCET 3 for level 1, level 2 has response time 12, with 4 it
+    // misses its deadline
+    EXPECT_TRUE(a.tryWCET(1, 3));
+    EXPECT_FALSE(a.tryWCET(1, 4));
+    EXPECT_EQ(a.getWCET(1), 2);
+    EXPECT_EQ(a.getMaxWCET(1, 6), 3);
+
+    a.setWCET(1, 3);
+    EXPECT_EQ(a.getResponseTime(2), 12);
+    a.setWCET(1, 1);
+    EXPECT_EQ(a.getResponseTime(2), 6);
+
+    // Same scheduling points as SchedPoint::SetP()
+    SchedPoint sp("fpanalysis_sp");
+    SchedPoint::row_t periods = {4, 6, 13};
+    for (size_t i = 0; i < periods.size(); ++i)
+        EXPECT_EQ(a.getSchedPoints(i), sp.SetP(periods[i], periods, i));
+}
+
+TEST(Scheduler, FPAnalysisWarmStart) {
+    // Random budget changes, the warm-started analysis must give the same
+    // results as the analysis from scratch
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int64_t> period(10, 200);
+
+    const size_t n = 8;
+    std::vector<int64_t> c(n), p(n);
+    for (size_t i = 0; i < n; ++i)
+        p[i] = period(gen);
+    std::sort(p.begin(), p.end());
+
+    FPAnalysis a;
+    for (size_t i = 0; i < n; ++i) {
+        c[i] = 1;
+        a.addLevel(c[i], p[i]);
+    }
+
+    std::uniform_int_distribution<size_t> level(0, n - 1);
+    std::uniform_int_distribution<int64_t> delta(-3, 5);
+    for (int step = 0; step < 500; ++step) {
+        size_t i = level(gen);
+        c[i] = std::max<int64_t>(1, std::min(p[i], c[i] + delta(gen)));
+        a.setWCET(i, c[i]);
+
+        for (size_t j = 0; j < n; ++j) {
+            int64_t r = coldResponseTime(c, p, j);
+            if (r <= p[j])
+                ASSERT_EQ(a.getResponseTime(j), r);
+            else
+                ASSERT_GT(a.getResponseTime(j), p[j]);
+        }
+
+        // The binary search agrees with a linear one
+        size_t k = level(gen);
+        int64_t expected = c[k];
+        for (int64_t b = c[k] + 1; b <= p[k]; ++b) {
+            std::vector<int64_t> cc = c;
+            cc[k] = b;
+            bool ok = true;
+            for (size_t j = k; ok && j < n; ++j)
+                ok = coldResponseTime(cc, p, j) <= p[j];
+            if (!ok)
+                break;
+            expected = b;
+        }
+        ASSERT_EQ(a.getMaxWCET(k, p[k]), expected);
+    }
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/mrtkernel.hpp>
+#include <rtsim/rttask.hpp>
+#include <rtsim/scheduler/edfsched.hpp>
+#include <rtsim/scheduler/fpsched.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using MetaSim::Tick;
+using RTSim::CPU;
+using RTSim::EDFScheduler;
+using RTSim::FPScheduler;
+using RTSim::MRTKernel;
+using RTSim::PeriodicTask;
+using RTSim::Scheduler;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+namespace {
+    /// The schedule of a run, sampled at each tick
+    struct Schedule {
+        /// One row per tick, each with a character per CPU: the index of
+        /// the task dispatched on it or '-'. Rows are separated by a
+        /// space, or a newline every 10 ticks
+        std::string rows;
+
+        /// Tasks taken off their CPU before the end of their job
+        int preemptions = 0;
+
+        /// Preempted tasks resumed on another CPU
+        int migrations = 0;
+    };
+
+    // m + 2 periodic tasks on m CPUs of speed 1, released at 0:
+    //
+    // | Task | Period | WCET | Priority (FP) |
+    // | :--: | :----: | :--: | :-----------: |
+    // |  0   |   10   |  4   |       1       |
+    // |  1   |   12   |  5   |       2       |
+    // |  2   |   15   |  6   |       3       |
+    // |  3   |   20   |  7   |       4       |
+    // |  4   |   24   |  8   |       5       |
+    // |  5   |   30   |  9   |       6       |
+    Schedule simulate(const std::string &name, bool edf, int m, Tick cs,
+                      Tick md, int horizon) {
+        static const int periods[] = {10, 12, 15, 20, 24, 30};
+        static const int wcets[] = {4, 5, 6, 7, 8, 9};
+
+        auto island = createTBIsland(
+            name, {{1000, 1}}, {"idle", "bzip2"},
+            [](const std::string &, size_t) { return TBPoint{1, 1}; });
+
+        // The CPUs are added in order of address, the order in which the
+        // kernel used to visit them when it kept them in a map; the
+        // expected schedules below were recorded with that kernel
+        std::vector<std::unique_ptr<CPU>> cpus;
+        for (int i = 0; i < m; ++i) {
+            cpus.push_back(std::make_unique<CPU>(
+                name + "_cpu" + std::to_string(i), nullptr));
+            cpus.back()->setIsland(island.get());
+        }
+        std::sort(cpus.begin(), cpus.end());
+
+        std::unique_ptr<Scheduler> sched;
+        if (edf)
+            sched = std::make_unique<EDFScheduler>();
+        else
+            sched = std::make_unique<FPScheduler>();
+
+        MRTKernel kernel(sched.get(), {}, name + "_kernel");
+        for (auto &c : cpus)
+            kernel.addCPU(c.get());
+        kernel.setContextSwitchDelay(cs);
+        kernel.setMigrationDelay(md);
+
+        std::vector<std::unique_ptr<PeriodicTask>> tasks;
+        for (int i = 0; i < m + 2; ++i) {
+            tasks.push_back(std::make_unique<PeriodicTask>(
+                periods[i], periods[i], 0, name + "_t" + std::to_string(i)));
+            tasks.back()->insertCode("fixed(" + std::to_string(wcets[i]) +
+                                     ",bzip2);");
+            kernel.addTask(*tasks.back(), std::to_string(i + 1));
+        }
+
+        auto &simulation = Simulation::getInstance();
+        simulation.initSingleRun();
+
+        Schedule s;
+        std::vector<CPU *> last(tasks.size(), nullptr);
+        std::map<size_t, CPU *> preempted;
+        for (int k = 0; k < horizon; ++k) {
+            simulation.run_to(Tick(k));
+
+            std::string row(m, '-');
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                CPU *c = kernel.getProcessor(tasks[i].get());
+                for (int j = 0; j < m; ++j)
+                    if (c == cpus[j].get())
+                        row[j] = char('0' + i);
+
+                if (last[i] != nullptr && c != last[i]) {
+                    if (tasks[i]->endEvt.getLastTime() == Tick(k)) {
+                        preempted.erase(i);
+                    } else {
+                        ++s.preemptions;
+                        preempted[i] = last[i];
+                    }
+                }
+
+                auto it = preempted.find(i);
+                if (c != nullptr && it != preempted.end()) {
+                    if (c != it->second)
+                        ++s.migrations;
+                    preempted.erase(it);
+                }
+                last[i] = c;
+            }
+
+            if (k > 0)
+                s.rows += k % 10 == 0 ? '\n' : ' ';
+            s.rows += row;
+        }
+
+        simulation.endSingleRun();
+        return s;
+    }
+} // namespace
+
+// The expected schedules, preemptions and migrations below are the ones of
+// the kernel before the CPUs and the tasks were kept in dense slots
+
+TEST(Scheduler, GlobalFP) {
+    auto s = simulate("gfp_2", false, 2, 1, 2, 80);
+    EXPECT_EQ(s.rows, "-- 01 01 01 01 -1 2- 23 23 23\n"
+                      "2- 2- -- -0 -0 10 10 1- 1- 1-\n"
+                      "-2 -2 -2 02 0- 0- 0- -1 -1 -1\n"
+                      "-1 01 0- 02 02 -- -- -1 21 21\n"
+                      "-1 01 0- 0- 0- -2 -2 -2 -2 --\n"
+                      "-- 1- 1- 10 10 10 -0 -- -3 23\n"
+                      "-- -- -- 01 01 01 01 -1 2- 23\n"
+                      "2- 2- -- -0 -0 10 10 1- 1- 1-");
+    EXPECT_EQ(s.preemptions, 7);
+    EXPECT_EQ(s.migrations, 1);
+
+    s = simulate("gfp_3", false, 3, 1, 3, 80);
+    EXPECT_EQ(s.rows, "--- 012 012 012 012 -12 3-2 34- 34- 34-\n"
+                      "34- 34- 3-- -1- -10 -10 -10 -10 --- -4-\n"
+                      "--- 2-0 2-0 2-0 2-0 21- 21- -1- -1- -13\n"
+                      "--3 --3 2-3 2-3 203 203 20- 20- --- ---\n"
+                      "--1 -01 -01 -01 -01 --- 3-- 3-- 3-- 32-\n"
+                      "-21 -21 -21 -21 021 0-- 0-- 0-- --- -34\n"
+                      "--- 0-- 0-- 0-- 012 -12 -12 -12 -12 3-2\n"
+                      "3-- --- 3-- 3-- 310 -10 -10 -10 -1- 2--");
+    EXPECT_EQ(s.preemptions, 6);
+    EXPECT_EQ(s.migrations, 3);
+
+    s = simulate("gfp_4", false, 4, 3, 1, 80);
+    EXPECT_EQ(s.rows, "---- ---- ---- 0123 0123 0123 0123 -123 --23 ---3\n"
+                      "4--- 45-- 45-- 45-- 45-0 4--0 4-10 4-10 --1- -21-\n"
+                      "-21- -2-- -2-- -2-- -2-0 --30 --30 --30 --3- 413-\n"
+                      "-13- -13- -1-- -1-- 0--- 0--- 0-42 0-42 --42 --42\n"
+                      "-1-2 -1-2 -1-- -1-- -10- --0- 3-04 3-04 3--4 32--\n"
+                      "32-- 32-- 321- -21- -21- --1- --10 4--0 45-0 45-0\n"
+                      "---- ---- ---- ---- 2301 2301 2301 2301 23-1 23--\n"
+                      "-3-- ---- --4- --45 0-45 0-4- 0-4- 0--- -1-- -1-2");
+    EXPECT_EQ(s.preemptions, 6);
+    EXPECT_EQ(s.migrations, 4);
+}
+
+TEST(Scheduler, GlobalEDF) {
+    auto s = simulate("gedf_2", true, 2, 1, 3, 80);
+    EXPECT_EQ(s.rows, "-- 01 01 01 01 -1 2- 23 23 23\n"
+                      "23 23 -3 03 0- 01 01 -1 21 21\n"
+                      "2- 2- 2- 2- -0 -0 -0 -0 1- 13\n"
+                      "13 13 13 -3 -3 -3 -- 0- 0- 0-\n"
+                      "02 -2 12 12 12 12 1- -- -- --\n"
+                      "-0 30 30 30 3- 32 32 32 -2 12\n"
+                      "12 1- 10 10 -0 10 1- 10 10 10\n"
+                      "-0 -- -- -- 2- 23 23 23 23 23");
+    EXPECT_EQ(s.preemptions, 0);
+    EXPECT_EQ(s.migrations, 0);
+
+    s = simulate("gedf_3", true, 3, 2, 1, 80);
+    EXPECT_EQ(s.rows, "--- --- 012 012 012 012 -12 --2 3-- 34-\n"
+                      "34- 34- 34- 340 340 -40 -40 --- 1-- 1--\n"
+                      "12- 12- 120 -20 -20 -20 --- 1-- 1-- 134\n"
+                      "13- 13- -30 -30 -30 230 2-- 2-- 2-- 241\n"
+                      "241 -41 -41 -41 04- 04- 0-- 0-3 --3 -23\n"
+                      "-23 123 123 123 12- 1-- --- -40 -40 -40\n"
+                      "-40 -4- 14- 140 140 1-0 1-0 -2- -2- -2-\n"
+                      "32- 32- 320 3-0 3-0 3-0 31- -1- -1- -12");
+    EXPECT_EQ(s.preemptions, 1);
+    EXPECT_EQ(s.migrations, 1);
+
+    s = simulate("gedf_4", true, 4, 2, 3, 80);
+    EXPECT_EQ(s.rows, "---- ---- 0123 0123 0123 0123 -123 --23 4--3 45--\n"
+                      "45-- 45-- 45-- 45-- 45-- 450- -50- -501 --01 ---1\n"
+                      "---1 2--1 2--- 2--- 2--- 20-- 2031 -031 -031 4-31\n"
+                      "--31 --3- --3- ---- ---- 0--- 02-4 02-4 02-4 -2-4\n"
+                      "-2-4 -2-4 ---4 --1- --1- --1- --1- -01- -0-5 30-5\n"
+                      "30-5 3--5 3--5 3-25 3-25 3-25 -125 -12- -12- -1-4\n"
+                      "-1-4 0--4 0--4 0124 0124 -124 -124 012- 0-2- 0---\n"
+                      "0--- ---- ---3 05-3 05-3 05-3 05-3 -513 -513 -51-");
+    EXPECT_EQ(s.preemptions, 1);
+    EXPECT_EQ(s.migrations, 1);
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/mrtkernel.hpp>
+#include <rtsim/rttask.hpp>
+#include <rtsim/scheduler/edfsched.hpp>
+#include <rtsim/scheduler/fpsched.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using MetaSim::Tick;
+using RTSim::CPU;
+using RTSim::EDFScheduler;
+using RTSim::FPScheduler;
+using RTSim::MRTKernel;
+using RTSim::PeriodicTask;
+using RTSim::Scheduler;
+using RTSim::Task;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+namespace {
+    /// The schedule of a run, sampled at each tick, along with the ticks
+    /// of the events that change the state of the kernel
+    struct Schedule {
+        /// One row per tick, each with a character per CPU: the index of
+        /// the task dispatched on it or '-'. Rows are separated by a
+        /// space, or a newline every 10 ticks
+        std::string rows;
+
+        /// End of the one-shot task
+        Tick ended = -1;
+
+        Tick suspended = -1;
+        Tick killed = -1;
+    };
+
+    // Two CPUs at first, a third one is added at tick 30:
+    //
+    // | Task | Period | Deadline | Phase | WCET | Priority (FP) |
+    // | :--: | :----: | :------: | :---: | :--: | :-----------: |
+    // |  0   |   10   |    10    |   0   |  3   |       1       |
+    // |  1   |   15   |    15    |   1   |  6   |       3       |
+    // |  2   |   12   |    12    |   0   |  7   |       4       |
+    // |  3   |   -    |    40    |   2   |  15  |       5       |
+    // |  4   |   20   |    14    |   3   |  9   |       6       |
+    // |  5   |   25   |    25    |   0   |  6   |       2       |
+    //
+    // Task 3 is one-shot; task 1 is suspended for 4 ticks the first time
+    // it is found executing from tick 15 on; the current job of task 5
+    // is killed the first time it is found executing (past its context
+    // switch) from tick 45 on.
+    Schedule simulate(const std::string &name, bool edf, Tick cs, Tick md,
+                      int horizon) {
+        auto island = createTBIsland(
+            name, {{1000, 1}}, {"idle", "bzip2"},
+            [](const std::string &, size_t) { return TBPoint{1, 1}; });
+
+        // Added in order of address, as in the GlobalFP test
+        std::vector<std::unique_ptr<CPU>> cpus;
+        for (int i = 0; i < 3; ++i) {
+            cpus.push_back(std::make_unique<CPU>(
+                name + "_cpu" + std::to_string(i), nullptr));
+            cpus.back()->setIsland(island.get());
+        }
+        std::sort(cpus.begin(), cpus.end());
+
+        std::unique_ptr<Scheduler> sched;
+        if (edf)
+            sched = std::make_unique<EDFScheduler>();
+        else
+            sched = std::make_unique<FPScheduler>();
+
+        MRTKernel kernel(sched.get(), {}, name + "_kernel");
+        kernel.addCPU(cpus[0].get());
+        kernel.addCPU(cpus[1].get());
+        kernel.setContextSwitchDelay(cs);
+        kernel.setMigrationDelay(md);
+
+        std::vector<std::unique_ptr<Task>> tasks;
+        auto add = [&](Task *t, int wcet, const std::string &prio) {
+            tasks.emplace_back(t);
+            t->insertCode("fixed(" + std::to_string(wcet) + ",bzip2);");
+            kernel.addTask(*t, prio);
+        };
+        add(new PeriodicTask(10, 10, 0, name + "_t0"), 3, "1");
+        add(new PeriodicTask(15, 15, 1, name + "_t1"), 6, "3");
+        add(new PeriodicTask(12, 12, 0, name + "_t2"), 7, "4");
+        add(new Task(nullptr, 40, 2, name + "_t3"), 15, "5");
+        add(new PeriodicTask(20, 14, 3, name + "_t4"), 9, "6");
+        add(new PeriodicTask(25, 25, 0, name + "_t5"), 6, "2");
+
+        auto &simulation = Simulation::getInstance();
+        simulation.initSingleRun();
+
+        // The one-shot task is activated by hand
+        tasks[3]->activate(2);
+
+        Schedule s;
+        CPU *last5 = nullptr;
+        int since5 = 0;
+        for (int k = 0; k < horizon; ++k) {
+            simulation.run_to(Tick(k));
+            if (k == 30)
+                kernel.addCPU(cpus[2].get());
+
+            if (s.suspended < 0 && k >= 15 && tasks[1]->isExecuting() &&
+                kernel.getProcessor(tasks[1].get())) {
+                kernel.suspend(tasks[1].get());
+                s.suspended = k;
+                simulation.run_to(Tick(k));
+            } else if (s.suspended >= 0 && Tick(k) == s.suspended + 4) {
+                kernel.onArrival(tasks[1].get());
+                simulation.run_to(Tick(k));
+            }
+
+            // Killing a task during its context switch crashes the
+            // kernel, hence the task must have been on the same CPU for
+            // longer than the switch
+            CPU *c5 = kernel.getProcessor(tasks[5].get());
+            if (c5 != last5) {
+                last5 = c5;
+                since5 = k;
+            }
+            if (s.killed < 0 && k >= 45 && c5 && Tick(k - since5) > cs + md &&
+                tasks[5]->isExecuting()) {
+                tasks[5]->killInstance();
+                s.killed = k;
+                simulation.run_to(Tick(k));
+            }
+
+            std::string row(3, '-');
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                CPU *c = kernel.getProcessor(tasks[i].get());
+                for (int j = 0; j < 3; ++j)
+                    if (c == cpus[j].get())
+                        row[j] = char('0' + i);
+            }
+
+            if (k > 0)
+                s.rows += k % 10 == 0 ? '\n' : ' ';
+            s.rows += row;
+        }
+
+        s.ended = tasks[3]->endEvt.getLastTime();
+        simulation.endSingleRun();
+        return s;
+    }
+} // namespace
+
+// The expected schedules below are the ones of the kernel before the CPUs
+// and the tasks were kept in dense slots
+
+TEST(Scheduler, GlobalKernelStateFP) {
+    auto s = simulate("kfp_12", false, 1, 2, 90);
+    EXPECT_EQ(s.ended, 79);
+    EXPECT_EQ(s.suspended, 19);
+    EXPECT_EQ(s.killed, 57);
+    EXPECT_EQ(s.rows, "--- 05- 05- 05- -5- 15- 15- 1-- 12- 12-\n"
+                      "1-- --- --- -0- 20- 20- 2-- 2-- 2-- ---\n"
+                      "2-- 20- 20- -0- --- --- 1-- 1-- 15- 15-\n"
+                      "-5- -5- -5- 05- 0-- 0-- --- 21- 21- 2--\n"
+                      "21- -1- 21- 210 210 210 2-- 213 213 -13\n"
+                      "-1- -1- -1- 0-5 0-5 0-5 -25 -2- -24 324\n"
+                      "32- -2- -2- --0 120 120 12- 12- 12- 123\n"
+                      "-23 --3 -23 023 023 023 -23 123 123 1--\n"
+                      "12- 12- 12- -20 -20 -20 42- 4-- 42- 42-");
+}
+
+TEST(Scheduler, GlobalKernelStateEDF) {
+    auto s = simulate("kedf_21", true, 2, 1, 90);
+    EXPECT_EQ(s.ended, 62);
+    EXPECT_EQ(s.suspended, 31);
+    EXPECT_EQ(s.killed, 60);
+    EXPECT_EQ(s.rows, "--- --- 02- 02- 02- -2- -2- 12- 12- 1--\n"
+                      "1-- 14- 14- -4- -4- 04- 04- 04- -4- -4-\n"
+                      "--- 2-- 25- 25- 25- 25- 25- 25- --- ---\n"
+                      "0-- 0-- 0-- --- -2- -2- 42- 42- 42- 421\n"
+                      "421 4-1 4-1 4-1 401 -0- -0- 3-1 3-1 321\n"
+                      "321 321 321 32- 32- 32- 3-5 3-5 305 305\n"
+                      "30- 3-- --- -24 -24 024 024 024 -24 -24\n"
+                      "--4 1-4 1-- 10- 10- 102 1-2 --2 --2 142\n"
+                      "142 142 14- 14- 14- -40 -40 -40 2-- 2--");
+
+    s = simulate("kedf_13", true, 1, 3, 90);
+    EXPECT_EQ(s.ended, 57);
+    EXPECT_EQ(s.suspended, 27);
+    EXPECT_EQ(s.killed, 61);
+    EXPECT_EQ(s.rows, "--- 02- 02- 02- -2- 12- 12- 12- 1-- 14-\n"
+                      "14- -4- 04- 04- 04- -4- -4- -4- --- 25-\n"
+                      "25- 25- 25- 25- 25- 2-- --- --- 2-- 20-\n"
+                      "20- 20- 2-- 24- 24- -41 -41 -41 -41 041\n"
+                      "041 04- --3 --3 --3 --3 123 123 123 123\n"
+                      "123 123 -23 --3 --3 --3 5-3 50- 50- 50-\n"
+                      "5-- -24 -24 -24 -24 024 024 024 --4 1-4\n"
+                      "1-- 1-- 10- 10- 102 --2 1-2 1-2 1-2 142\n"
+                      "142 14- -4- -4- -4- -40 240 240 2-- 2--");
+}
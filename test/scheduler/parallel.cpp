@@ -0,0 +1,136 @@
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/basestat.hpp>
+#include <metasim/simcontext.hpp>
+
+#include <rtsim/rttask.hpp>
+#include <rtsim/system.hpp>
+#include <rtsim/taskstat.hpp>
+
+using MetaSim::SimulationContext;
+using MetaSim::StatMax;
+using MetaSim::StatMean;
+using MetaSim::Tick;
+using RTSim::FinishingTimeStat;
+using RTSim::MissCount;
+using RTSim::PeriodicTask;
+using RTSim::System;
+
+namespace {
+    // Four CPUs, each with its own EDF kernel
+    const char *system_yml = R"(cpu_islands:
+  - name: island
+    numcpus: 4
+    kernel:
+      scheduler: edf
+      task_placement: partitioned
+    volts:
+      [ 5 ]
+    freqs:
+      [ 1000 ]
+    power_model: no_scaling
+    speed_model: no_scaling
+power_models:
+  - name: no_scaling
+    type: balsini_pannocchi
+    params:
+      - workload: idle
+        power_params: [0, 0, 0, 0]
+        speed_params: [1, 0, 0, 0]
+      - workload: bzip2
+        power_params: [1, 0, 0, 0]
+        speed_params: [1, 0, 0, 0]
+)";
+
+    /// A task placed on a CPU, along with its statistics
+    struct Placed {
+        std::unique_ptr<PeriodicTask> task;
+        std::unique_ptr<FinishingTimeStat<StatMax>> maxft;
+        std::unique_ptr<FinishingTimeStat<StatMean>> meanft;
+        std::unique_ptr<MissCount> misses;
+    };
+
+    struct Stats {
+        double maxft;
+        double meanft;
+        double misses;
+    };
+
+    // Three tasks on each CPU; the last CPU is overloaded, so that its
+    // tasks miss some deadlines
+    //
+    // | Task | Period  |  WCET  |
+    // | :--: | :-----: | :----: |
+    // |  0   | 10 + c  |   3    |
+    // |  1   |   15    | 4 + 2c |
+    // |  2   | 40 - c  |   8    |
+    std::vector<Stats> simulate(const std::string &fname, bool parallel,
+                                Tick duration) {
+        System sys{fname, parallel};
+
+        std::vector<Placed> tasks;
+        for (size_t c = 0; c < sys.cpus.size(); ++c) {
+            // The tasks and their statistics belong to their CPU
+            SimulationContext::Scope scope(sys.getContext(c));
+
+            const int cc = int(c);
+            const int periods[] = {10 + cc, 15, 40 - cc};
+            const int wcets[] = {3, 4 + 2 * cc, 8};
+            for (int i = 0; i < 3; ++i) {
+                const std::string name =
+                    "t" + std::to_string(c) + "_" + std::to_string(i);
+
+                Placed p;
+                p.task = std::make_unique<PeriodicTask>(periods[i], periods[i],
+                                                        0, name);
+                p.task->insertCode("fixed(" + std::to_string(wcets[i]) +
+                                   ",bzip2);");
+                sys.cpus[c]->getKernel()->addTask(*p.task, "");
+
+                p.maxft = std::make_unique<FinishingTimeStat<StatMax>>(
+                    name + "_maxft");
+                p.maxft->attachToTask(p.task.get());
+                p.meanft = std::make_unique<FinishingTimeStat<StatMean>>(
+                    name + "_meanft");
+                p.meanft->attachToTask(p.task.get());
+                p.misses = std::make_unique<MissCount>(name + "_misses");
+                p.misses->attachToTask(p.task.get());
+                tasks.push_back(std::move(p));
+            }
+        }
+
+        sys.run(duration);
+
+        std::vector<Stats> stats;
+        for (auto &p : tasks)
+            stats.push_back({p.maxft->getLastValue(),
+                             p.meanft->getLastValue(),
+                             p.misses->getLastValue()});
+        return stats;
+    }
+} // namespace
+
+TEST(Scheduler, ParallelPartitionedSystem) {
+    const std::string fname = "parallel_system.yml";
+    std::ofstream(fname) << system_yml;
+
+    // The same model, on one thread and on one thread per CPU
+    auto expected = simulate(fname, false, 10000);
+    auto stats = simulate(fname, true, 10000);
+
+    ASSERT_EQ(stats.size(), expected.size());
+    for (size_t i = 0; i < stats.size(); ++i) {
+        EXPECT_EQ(stats[i].maxft, expected[i].maxft) << "task " << i;
+        EXPECT_EQ(stats[i].meanft, expected[i].meanft) << "task " << i;
+        EXPECT_EQ(stats[i].misses, expected[i].misses) << "task " << i;
+    }
+
+    // The last CPU misses some deadlines, the others none
+    EXPECT_GT(expected.back().misses, 0);
+    EXPECT_EQ(expected.front().misses, 0);
+}
@@ -0,0 +1,56 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/scheduler/fpsched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/kernel.hpp"
+
+using MetaSim::Simulation;
+using RTSim::AbsRTTask;
+using RTSim::FPScheduler;
+using RTSim::Task;
+
+using RTSim::Mocks::KernelMock;
+
+TEST(Scheduler, ReadyQueueRank) {
+    auto &simulation = Simulation::getInstance();
+    auto kernel = KernelMock();
+    FPScheduler sched;
+
+    // Task i has priority 4 - i, hence the queue is in reverse order
+    std::vector<std::unique_ptr<Task>> tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.emplace_back(std::make_unique<Task>(nullptr, 100));
+        tasks.back()->insertCode("fixed(10,bzip2);");
+        kernel.addTask(*tasks.back(), "");
+        sched.addTask(tasks.back().get(), std::to_string(4 - i));
+    }
+
+    simulation.initSingleRun();
+    for (auto &t : tasks)
+        sched.insert(t.get());
+
+    for (int n = 0; n < 4; ++n)
+        EXPECT_EQ(sched.getTaskN(n), tasks[3 - n].get());
+    EXPECT_EQ(sched.getTaskN(4), nullptr);
+    EXPECT_TRUE(sched.isInQueue(tasks[1].get()));
+
+    std::vector<AbsRTTask *> top;
+    sched.getTopTasks(2, top);
+    EXPECT_EQ(top, (std::vector<AbsRTTask *>{tasks[3].get(), tasks[2].get()}));
+
+    sched.extract(tasks[2].get());
+    EXPECT_FALSE(sched.isInQueue(tasks[2].get()));
+    EXPECT_EQ(sched.getTaskN(1), tasks[1].get());
+
+    top.clear();
+    sched.getTopTasks(8, top);
+    EXPECT_EQ(top, (std::vector<AbsRTTask *>{tasks[3].get(), tasks[1].get(),
+                                             tasks[0].get()}));
+}
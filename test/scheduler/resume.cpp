@@ -0,0 +1,87 @@
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/kernel.hpp>
+#include <rtsim/scheduler/fpsched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using MetaSim::Tick;
+using RTSim::CPU;
+using RTSim::FPScheduler;
+using RTSim::RTKernel;
+using RTSim::Task;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+namespace {
+    // A task preempted in the middle of its instruction, then resumed;
+    // returns the end times of the low and the high priority task
+    std::pair<Tick, Tick> simulate(const std::string &name, double speed) {
+        auto island = createTBIsland(
+            name, {{1000, 1}}, {"idle", "bzip2"},
+            [speed](const std::string &, size_t) {
+                return TBPoint{1, speed};
+            });
+        CPU c(name + "_cpu", nullptr);
+        c.setIsland(island.get());
+
+        FPScheduler sched;
+        RTKernel kernel(&sched, name + "_kernel", &c);
+
+        Task low(nullptr, 100, 0, name + "_low");
+        low.insertCode("fixed(10,bzip2);");
+        kernel.addTask(low, "2");
+
+        Task high(nullptr, 100, 0, name + "_high");
+        high.insertCode("fixed(4,bzip2);");
+        kernel.addTask(high, "1");
+
+        auto &simulation = Simulation::getInstance();
+        simulation.initSingleRun();
+
+        simulation.run_to(0);
+        low.activate(0);
+        high.activate(4);
+        simulation.run_to(50);
+
+        std::pair<Tick, Tick> ends{low.endEvt.getLastTime(),
+                                   high.endEvt.getLastTime()};
+        simulation.endSingleRun();
+        return ends;
+    }
+} // namespace
+
+TEST(Scheduler, ResumedInstrEnd) {
+    // | Interval | Task | Cycles executed (speed 1) |
+    // | :------: | :--: | :-----------------------: |
+    // |  [0, 4)  | low  |             4             |
+    // |  [4, 8)  | high |             4             |
+    // |  [8, 14) | low  |             6             |
+    //
+    // At speed 1 counting the cycles twice made no difference
+    auto ends = simulate("resume_full", 1);
+    EXPECT_EQ(ends.second, 8);
+    EXPECT_EQ(ends.first, 14);
+
+    // | Interval | Task | Cycles executed (speed 0.5) |
+    // | :------: | :--: | :-------------------------: |
+    // |  [0, 4)  | low  |              2              |
+    // |  [4, 12) | high |              4              |
+    // | [12, 28) | low  |              8              |
+    //
+    // The 2 cycles executed before the preemption used to be scaled by
+    // the speed once more, leaving 10 - 2 * 0.5 = 9 cycles and moving
+    // the end of low to 30
+    ends = simulate("resume_half", 0.5);
+    EXPECT_EQ(ends.second, 12);
+    EXPECT_EQ(ends.first, 28);
+}
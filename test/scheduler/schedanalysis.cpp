@@ -0,0 +1,140 @@
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <rtsim/schedanalysis.hpp>
+
+using RTSim::SchedAnalysis;
+using RTSim::TaskArray;
+
+// EDF test by brute force: the demand in [0, t] does not exceed t at any
+// absolute deadline up to the hyperperiod plus the largest deadline
+static bool bruteForceEDF(const TaskArray &ts) {
+    int64_t h = 1, dmax = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        h = std::lcm(h, ts.period[i]);
+        dmax = std::max(dmax, ts.dline[i]);
+    }
+    if (SchedAnalysis::getUtilization(ts) > 1)
+        return false;
+    for (int64_t t = 1; t <= h + dmax; ++t)
+        if (SchedAnalysis::getDemand(ts, t) > t)
+            return false;
+    return true;
+}
+
+TEST(Scheduler, SchedAnalysisUniprocessor) {
+    // | Task | WCET | Period | Response time |
+    // | :--: | :--: | :----: | :-----------: |
+    // |  0   |  1   |   4    |       1       |
+    // |  1   |  2   |   6    |       3       |
+    // |  2   |  3   |   13   |      10       |
+    TaskArray ts;
+    ts.add(1, 4);
+    ts.add(2, 6);
+    ts.add(3, 13);
+
+    EXPECT_DOUBLE_EQ(SchedAnalysis::getUtilization(ts),
+                     1.0 / 4 + 2.0 / 6 + 3.0 / 13);
+    EXPECT_FALSE(SchedAnalysis::isLLSchedulable(ts));
+    EXPECT_FALSE(SchedAnalysis::isHyperbolicSchedulable(ts));
+    EXPECT_TRUE(SchedAnalysis::isRTASchedulable(ts));
+    EXPECT_EQ(SchedAnalysis::getResponseTime(ts, 0), 1);
+    EXPECT_EQ(SchedAnalysis::getResponseTime(ts, 1), 3);
+    EXPECT_EQ(SchedAnalysis::getResponseTime(ts, 2), 10);
+    EXPECT_TRUE(SchedAnalysis::isQPASchedulable(ts));
+
+    // At half speed the WCETs double, task 1 misses its deadline
+    EXPECT_FALSE(SchedAnalysis::isRTASchedulable(ts, TaskArray::NONE, 0.5));
+    EXPECT_GT(SchedAnalysis::getResponseTime(ts, 1, 0.5), 6);
+
+    // Lowering the priority of task 0 below the others
+    ts.priority[0] = 10;
+    EXPECT_EQ(SchedAnalysis::getResponseTime(ts, 1), 2);
+    EXPECT_EQ(SchedAnalysis::getResponseTime(ts, 0), 6);
+
+    EXPECT_THROW(ts.add(1, 0), SchedAnalysis::Exc);
+    EXPECT_THROW(SchedAnalysis::getUtilization(ts, TaskArray::NONE, 0),
+                 SchedAnalysis::Exc);
+
+    // Constrained deadlines, compared with the brute-force EDF test
+    std::mt19937 gen(7);
+    std::vector<int64_t> periods = {4, 5, 6, 8, 10, 12, 15, 20};
+    std::uniform_int_distribution<size_t> pick(0, periods.size() - 1);
+    for (int k = 0; k < 300; ++k) {
+        TaskArray r;
+        for (int i = 0; i < 4; ++i) {
+            int64_t t = periods[pick(gen)];
+            int64_t c = std::uniform_int_distribution<int64_t>(1, t / 2)(gen);
+            int64_t d = std::uniform_int_distribution<int64_t>(c, t)(gen);
+            r.add(c, t, d);
+        }
+        ASSERT_EQ(SchedAnalysis::isQPASchedulable(r), bruteForceEDF(r));
+    }
+}
+
+TEST(Scheduler, SchedAnalysisPartition) {
+    // Utilizations 0.6, 0.5, 0.4 and 0.3 on two CPUs
+    TaskArray ts;
+    ts.add(3, 10);
+    ts.add(6, 10);
+    ts.add(5, 10);
+    ts.add(4, 10);
+
+    using Fit = SchedAnalysis::Fit;
+    EXPECT_TRUE(SchedAnalysis::partition(ts, {1, 1}, Fit::FIRST));
+    EXPECT_EQ(ts.cpu, std::vector<int>({1, 0, 1, 0}));
+    EXPECT_TRUE(SchedAnalysis::partition(ts, {1, 1}, Fit::BEST));
+    EXPECT_EQ(ts.cpu, std::vector<int>({1, 0, 1, 0}));
+    EXPECT_TRUE(SchedAnalysis::partition(ts, {1, 1}, Fit::WORST));
+    EXPECT_EQ(ts.cpu, std::vector<int>({0, 0, 1, 1}));
+    EXPECT_DOUBLE_EQ(SchedAnalysis::getUtilization(ts, 1), 0.9);
+
+    // At half speed CPU 1 is filled by the 0.5 task
+    EXPECT_FALSE(SchedAnalysis::partition(ts, {1, 0.5}, Fit::FIRST));
+    EXPECT_EQ(ts.cpu, std::vector<int>({TaskArray::NONE, 0, 1, 0}));
+
+    // Lowest OPP of CPU 1 for its tasks (utilization 0.9). At speed 0.9
+    // the WCETs are rounded up to 6 and 5, hence it is not enough.
+    EXPECT_TRUE(SchedAnalysis::partition(ts, {1, 1}, Fit::WORST));
+    std::vector<double> speeds = {0.25, 0.5, 0.75, 0.9, 1.0};
+    EXPECT_EQ(SchedAnalysis::getMinOPP(ts, 1, speeds), 4);
+    EXPECT_EQ(SchedAnalysis::getMinOPP(ts, 1, {0.25, 0.5}), 2);
+}
+
+TEST(Scheduler, SchedAnalysisBatch) {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int64_t> period(10, 100);
+
+    std::vector<TaskArray> sets(1000);
+    for (auto &ts : sets) {
+        for (int i = 0; i < 6; ++i) {
+            int64_t t = period(gen);
+            ts.add(std::uniform_int_distribution<int64_t>(1, t / 4)(gen), t);
+        }
+    }
+
+    SchedAnalysis::Test test = [](const TaskArray &ts) {
+        TaskArray p = ts;
+        return SchedAnalysis::partition(p, {0.5, 0.5},
+                                        SchedAnalysis::Fit::FIRST,
+                                        SchedAnalysis::Policy::FP);
+    };
+
+    std::vector<char> parallel = SchedAnalysis::evaluate(sets, test, 4);
+    ASSERT_EQ(parallel.size(), sets.size());
+    for (size_t i = 0; i < sets.size(); ++i)
+        ASSERT_EQ(bool(parallel[i]), test(sets[i]));
+    EXPECT_EQ(SchedAnalysis::evaluate(sets, test, 1), parallel);
+
+    EXPECT_THROW(SchedAnalysis::evaluate(
+                     sets,
+                     [](const TaskArray &) -> bool {
+                         throw std::runtime_error("test");
+                     },
+                     4),
+                 std::runtime_error);
+}
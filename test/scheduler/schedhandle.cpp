@@ -0,0 +1,82 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/scheduler/fpsched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/kernel.hpp"
+
+using MetaSim::Simulation;
+using RTSim::FPScheduler;
+using RTSim::RTSchedExc;
+using RTSim::Task;
+
+using RTSim::Mocks::KernelMock;
+using testing::NiceMock;
+
+TEST(Scheduler, TaskInTwoSchedulers) {
+    auto &simulation = Simulation::getInstance();
+    NiceMock<KernelMock> kernel;
+
+    Task t(nullptr, 100);
+    t.insertCode("fixed(10,bzip2);");
+    kernel.addTask(t, "");
+
+    Task u(nullptr, 100);
+    u.insertCode("fixed(10,bzip2);");
+    kernel.addTask(u, "");
+
+    FPScheduler a;
+    FPScheduler b;
+
+    // Each scheduler finds its own model of t
+    a.addTask(&t, "1");
+    b.addTask(&t, "7");
+    b.addTask(&u, "3");
+    EXPECT_THROW(a.addTask(&t, "2"), RTSchedExc);
+
+    EXPECT_EQ(a.getPriority(&t), 1);
+    EXPECT_EQ(b.getPriority(&t), 7);
+    EXPECT_THROW(a.getPriority(&u), RTSchedExc);
+
+    simulation.initSingleRun();
+    a.insert(&t);
+    b.insert(&t);
+    b.insert(&u);
+
+    EXPECT_EQ(a.getFirst(), &t);
+    EXPECT_EQ(b.getFirst(), &u);
+
+    a.extract(&t);
+    EXPECT_FALSE(a.isInQueue(&t));
+    EXPECT_TRUE(b.isInQueue(&t));
+    EXPECT_EQ(b.getTaskN(1), &t);
+
+    // Removing t from a leaves its model in b alone
+    a.discardTasks(true);
+    EXPECT_THROW(a.getPriority(&t), RTSchedExc);
+    EXPECT_EQ(b.getPriority(&t), 7);
+    EXPECT_TRUE(b.isInQueue(&t));
+
+    // And t can be added back, with a new model
+    a.addTask(&t, "4");
+    EXPECT_EQ(a.getPriority(&t), 4);
+    EXPECT_EQ(b.getPriority(&t), 7);
+
+    a.insert(&t);
+    EXPECT_EQ(a.getFirst(), &t);
+    EXPECT_EQ(a.getSortKey(&t).priority, 4);
+    EXPECT_EQ(b.getSortKey(&t).priority, 7);
+
+    // A scheduler created later does not see the models of the others
+    FPScheduler c;
+    EXPECT_THROW(c.getPriority(&t), RTSchedExc);
+    c.addTask(&t, "9");
+    EXPECT_EQ(c.getPriority(&t), 9);
+    EXPECT_EQ(a.getPriority(&t), 4);
+
+    simulation.endSingleRun();
+}
@@ -0,0 +1,167 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/scheduler/edfsched.hpp>
+#include <rtsim/scheduler/fpsched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/kernel.hpp"
+
+using MetaSim::Simulation;
+using RTSim::EDFScheduler;
+using RTSim::FPScheduler;
+using RTSim::RTSchedExc;
+using RTSim::Task;
+
+using RTSim::Mocks::KernelMock;
+using testing::NiceMock;
+
+namespace {
+    // Gives access to the task models
+    class FPProbe : public FPScheduler {
+    public:
+        using FPScheduler::find;
+    };
+
+    class EDFProbe : public EDFScheduler {
+    public:
+        using EDFScheduler::find;
+    };
+
+    std::vector<std::unique_ptr<Task>> createTasks(KernelMock &kernel,
+                                                   int n) {
+        std::vector<std::unique_ptr<Task>> tasks;
+        for (int i = 0; i < n; ++i) {
+            tasks.emplace_back(std::make_unique<Task>(nullptr, 100));
+            tasks.back()->insertCode("fixed(10,bzip2);");
+            kernel.addTask(*tasks.back(), "");
+        }
+        return tasks;
+    }
+} // namespace
+
+TEST(Scheduler, SortKeyFrozenWhileQueued) {
+    auto &simulation = Simulation::getInstance();
+    NiceMock<KernelMock> kernel;
+    auto tasks = createTasks(kernel, 2);
+
+    FPProbe fp;
+    fp.addTask(tasks[0].get(), "2");
+
+    EDFProbe edf;
+    edf.addTask(tasks[1].get(), "");
+
+    simulation.initSingleRun();
+    fp.insert(tasks[0].get());
+    edf.insert(tasks[1].get());
+
+    // Neither a priority nor a deadline can change under the queue
+    EXPECT_THROW(fp.find(tasks[0].get())->changePriority(1), RTSchedExc);
+    EXPECT_THROW(edf.find(tasks[1].get())->changePriority(50), RTSchedExc);
+    EXPECT_EQ(fp.getPriority(tasks[0].get()), 2);
+    EXPECT_EQ(edf.getPriority(tasks[1].get()), tasks[1]->getDeadline());
+
+    // Out of the queue they can
+    fp.extract(tasks[0].get());
+    edf.extract(tasks[1].get());
+    EXPECT_NO_THROW(fp.find(tasks[0].get())->changePriority(1));
+    EXPECT_NO_THROW(edf.find(tasks[1].get())->changePriority(50));
+    EXPECT_EQ(fp.getPriority(tasks[0].get()), 1);
+    EXPECT_EQ(edf.getPriority(tasks[1].get()), 50);
+
+    simulation.endSingleRun();
+}
+
+TEST(Scheduler, SortKeyRefreshedOnInsert) {
+    auto &simulation = Simulation::getInstance();
+    NiceMock<KernelMock> kernel;
+    auto tasks = createTasks(kernel, 3);
+
+    FPProbe sched;
+    for (int i = 0; i < 3; ++i)
+        sched.addTask(tasks[i].get(), std::to_string(i + 1));
+
+    simulation.initSingleRun();
+    for (auto &t : tasks)
+        sched.insert(t.get());
+
+    EXPECT_EQ(sched.getFirst(), tasks[0].get());
+    EXPECT_EQ(sched.getSortKey(tasks[0].get()).priority, 1);
+
+    // The highest priority task drops below the others
+    sched.extract(tasks[0].get());
+    sched.find(tasks[0].get())->changePriority(5);
+    sched.insert(tasks[0].get());
+
+    EXPECT_EQ(sched.getSortKey(tasks[0].get()).priority, 5);
+    EXPECT_EQ(sched.getTaskN(0), tasks[1].get());
+    EXPECT_EQ(sched.getTaskN(1), tasks[2].get());
+    EXPECT_EQ(sched.getTaskN(2), tasks[0].get());
+
+    // And back to the top
+    sched.extract(tasks[0].get());
+    sched.find(tasks[0].get())->changePriority(0);
+    sched.insert(tasks[0].get());
+
+    EXPECT_EQ(sched.getTaskN(0), tasks[0].get());
+    EXPECT_EQ(sched.getTaskN(1), tasks[1].get());
+    EXPECT_EQ(sched.getTaskN(2), tasks[2].get());
+
+    simulation.endSingleRun();
+}
+
+TEST(Scheduler, SortKeyTieBreak) {
+    auto &simulation = Simulation::getInstance();
+    NiceMock<KernelMock> kernel;
+    auto tasks = createTasks(kernel, 4);
+
+    FPProbe sched;
+    for (auto &t : tasks)
+        sched.addTask(t.get(), "1");
+
+    // All tasks have the same priority:
+    //
+    // | Task  | Insertion Time |
+    // | :---: | :------------: |
+    // |   3   |       0        |
+    // |   1   |       5        |
+    // |   2   |       5*       |
+    // |   0   |       7        |
+    //
+    // * inserted before 1, but 1 has a lower task number
+    simulation.initSingleRun();
+
+    simulation.run_to(0);
+    sched.insert(tasks[3].get());
+
+    simulation.run_to(5);
+    sched.insert(tasks[2].get());
+    sched.insert(tasks[1].get());
+
+    simulation.run_to(7);
+    sched.insert(tasks[0].get());
+
+    EXPECT_EQ(sched.getSortKey(tasks[0].get()).insertTime, 7);
+
+    std::vector<Task *> expected = {tasks[3].get(), tasks[1].get(),
+                                    tasks[2].get(), tasks[0].get()};
+    for (unsigned n = 0; n < expected.size(); ++n)
+        EXPECT_EQ(sched.getTaskN(n), expected[n]);
+
+    // A task extracted and inserted again goes after the others
+    simulation.run_to(9);
+    sched.extract(tasks[3].get());
+    sched.insert(tasks[3].get());
+
+    expected = {tasks[1].get(), tasks[2].get(), tasks[0].get(),
+                tasks[3].get()};
+    for (unsigned n = 0; n < expected.size(); ++n)
+        EXPECT_EQ(sched.getTaskN(n), expected[n]);
+
+    simulation.endSingleRun();
+}
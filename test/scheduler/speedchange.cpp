@@ -0,0 +1,76 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <metasim/simul.hpp>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/kernel.hpp>
+#include <rtsim/scheduler/fifosched.hpp>
+#include <rtsim/task.hpp>
+
+#include "../mocks/island.hpp"
+
+using MetaSim::Simulation;
+using RTSim::CPU;
+using RTSim::FIFOScheduler;
+using RTSim::RTKernel;
+using RTSim::Task;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+TEST(Scheduler, SpeedChange) {
+    // | OPP | Speed |
+    // | :-: | :---: |
+    // |  0  |  0.5  |
+    // |  1  |   1   |
+    auto island = createTBIsland(
+        "speedchange", {{500, 1}, {1000, 1}}, {"idle", "bzip2"},
+        [](const std::string &, size_t i) {
+            return TBPoint{1, 0.5 + 0.5 * i};
+        });
+    CPU c("speedchange_cpu", nullptr);
+    c.setIsland(island.get());
+
+    FIFOScheduler sched;
+    RTKernel kernel(&sched, "speedchange_kernel", &c);
+
+    Task t(nullptr, 100, 0, "speedchange_t");
+    t.insertCode("fixed(10,bzip2);");
+    kernel.addTask(t, "");
+
+    auto &simulation = Simulation::getInstance();
+    simulation.initSingleRun();
+
+    simulation.run_to(0);
+    t.activate(simulation.getTime());
+
+    // | Interval | OPP | Speed | Cycles executed |
+    // | :------: | :-: | :---: | :-------------: |
+    // |  [0, 4)  |  1  |   1   |        4        |
+    // | [4, 10)  |  0  |  0.5  |        3        |
+    // | [10, 13) |  1  |   1   |        3        |
+    simulation.run_to(4);
+    EXPECT_EQ(c.getInstr(), t.getInstrQueue().front().get());
+    island->setOPP(0);
+
+    // The end moved from 10 to 16, switching to the same OPP is a no-op
+    simulation.run_to(10);
+    island->setOPP(0);
+    EXPECT_TRUE(t.isActive());
+    island->setOPP(1);
+
+    simulation.run_to(12);
+    EXPECT_TRUE(t.isActive());
+
+    simulation.run_to(14);
+    EXPECT_FALSE(t.isActive());
+    EXPECT_EQ(t.endEvt.getLastTime(), 13);
+    EXPECT_EQ(c.getInstr(), nullptr);
+
+    // Idle CPUs have nothing to refresh
+    island->setOPP(0);
+    simulation.run_to(20);
+    EXPECT_FALSE(t.isActive());
+}
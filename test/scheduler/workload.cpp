@@ -0,0 +1,154 @@
+#include <memory>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <rtsim/cpu.hpp>
+#include <rtsim/powermodel.hpp>
+#include <rtsim/stateless_cpumodel_tb.hpp>
+#include <rtsim/system_descriptor.hpp>
+#include <rtsim/workload.hpp>
+
+#include "../mocks/island.hpp"
+
+using RTSim::CPU;
+using RTSim::CPUIsland;
+using RTSim::CPUMDescriptor;
+using RTSim::CPUModel;
+using RTSim::CPUModelBPParams;
+using RTSim::CPUModelTBApproxParams;
+using RTSim::CPUModelTBParams;
+using RTSim::ModelType;
+using RTSim::TBCPUModel;
+using RTSim::OPP;
+using RTSim::WorkloadId;
+
+using RTSim::Mocks::createTBIsland;
+using RTSim::Mocks::TBPoint;
+
+TEST(Scheduler, WorkloadId) {
+    EXPECT_EQ(WorkloadId(), WorkloadId::IDLE);
+    EXPECT_EQ(WorkloadId("idle"), WorkloadId::IDLE);
+    EXPECT_EQ(WorkloadId(""), WorkloadId::IDLE);
+    EXPECT_EQ(WorkloadId("busy"), WorkloadId::BUSY);
+    EXPECT_EQ(WorkloadId::IDLE.getName(), "idle");
+
+    WorkloadId a("workload_test_a");
+    WorkloadId b("workload_test_b");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(WorkloadId(std::string("workload_test_a")), a);
+    EXPECT_EQ(a.getName(), "workload_test_a");
+    EXPECT_LT(b.index(), WorkloadId::count());
+}
+
+TEST(Scheduler, WorkloadIdLookup) {
+    // | Workload | Power | Speed |
+    // | :------: | :---: | :---: |
+    // |   idle   |   1   |  0.5  |
+    // |  bzip2   |   3   |   1   |
+    auto island = createTBIsland(
+        "workload", {{1000, 1}}, {"idle", "bzip2"},
+        [](const std::string &wl, size_t) {
+            return wl == "idle" ? TBPoint{1, 0.5} : TBPoint{3, 1};
+        });
+    CPU c("workload_cpu", nullptr);
+    c.setIsland(island.get());
+
+    const WorkloadId bzip2("bzip2");
+    EXPECT_FALSE(c.busy());
+    EXPECT_EQ(c.getSpeed(), 0.5);
+
+    c.setWorkload(bzip2);
+    EXPECT_TRUE(c.busy());
+    EXPECT_EQ(c.getWorkloadId(), bzip2);
+    EXPECT_EQ(c.getWorkload(), "bzip2");
+    EXPECT_EQ(c.getSpeed(), 1);
+    EXPECT_EQ(c.getPower(), 1 + 3);
+    EXPECT_EQ(c.getPowerByOPP(0, "bzip2"), c.getPowerByOPP(0, bzip2));
+
+    // Unknown workload classes fall back to the idle table
+    c.setWorkload(WorkloadId("workload_test_unknown"));
+    EXPECT_TRUE(c.busy());
+    EXPECT_EQ(c.getSpeed(), 0.5);
+
+    c.setWorkload(WorkloadId::IDLE);
+    EXPECT_FALSE(c.busy());
+    EXPECT_EQ(c.getPower(), 1);
+}
+
+TEST(Scheduler, CPUIslandModelTable) {
+    std::vector<OPP> opps = {{500, 0.9}, {1000, 1.0}, {1500, 1.1}};
+
+    // BP model, with parameters for idle and bzip2
+    CPUMDescriptor bp;
+    bp.type = CPUModelBPParams::key;
+    CPUModelBPParams::Params params;
+    params.power = {0.1, 0.2, 0.3, 1e-9};
+    params.speed = {0.5, 100, 0.1, 2000};
+    bp.params.push_back(std::make_unique<CPUModelBPParams>("idle", params));
+    params.power.k = 2e-9;
+    params.speed.b = 50;
+    bp.params.push_back(std::make_unique<CPUModelBPParams>("bzip2", params));
+
+    // Approximated TB model, with two points for bzip2 only; the middle
+    // OPP is interpolated
+    CPUMDescriptor tb;
+    tb.type = CPUModelTBApproxParams::key;
+    for (size_t i : {0, 2}) {
+        CPUModelTBParams p;
+        p.workload = "bzip2";
+        p.freq = opps[i].frequency;
+        p.volt = opps[i].voltage;
+        p.power = 1 + i;
+        p.speed = 0.5 + i * 0.25;
+        tb.params.push_back(std::make_unique<CPUModelTBApproxParams>(p));
+    }
+
+    for (const CPUMDescriptor *d : {&bp, &tb}) {
+        CPUModel *model = CPUModel::create(*d, *d, opps.back(), 1500).release();
+        CPUIsland island({}, CPUIsland::Type::GENERIC, "table", opps, model);
+
+        // Interned after the island, compiled when first looked up
+        WorkloadId late("workload_test_late");
+        for (WorkloadId wl : {WorkloadId::IDLE, WorkloadId("bzip2"), late}) {
+            for (size_t i = 0; i < opps.size(); ++i) {
+                EXPECT_EQ(island.lookupPower(i, wl),
+                          model->lookupPower(opps[i], wl));
+                EXPECT_EQ(island.lookupSpeed(i, wl),
+                          model->lookupSpeed(opps[i], wl));
+            }
+        }
+    }
+}
+
+namespace {
+    // Gives access to the parameters of a table-based model
+    class TBPowerProbe : public TBCPUModel<ModelType::Power> {
+    public:
+        using TableBasedModel::setParams;
+    };
+} // namespace
+
+TEST(Scheduler, CPUIslandModelFrozen) {
+    std::vector<OPP> opps = {{500, 0.9}, {1000, 1.0}};
+
+    TBPowerProbe probe;
+    probe.setParams(opps[0], "bzip2", 1);
+    probe.setParams(opps[1], "bzip2", 2);
+    EXPECT_EQ(probe.lookupValue(opps[1], WorkloadId("bzip2")), 2);
+
+    // Once frozen, the values cannot change anymore
+    probe.freeze();
+    EXPECT_THROW(probe.setParams(opps[1], "bzip2", 3), std::logic_error);
+    EXPECT_EQ(probe.lookupValue(opps[1], WorkloadId("bzip2")), 2);
+
+    // The island freezes its model, since it caches its values
+    CPUMDescriptor d;
+    d.type = CPUModelTBParams::key;
+    CPUModel *model = CPUModel::create(d, d, opps.back(), 1000).release();
+    EXPECT_FALSE(model->isFrozen());
+
+    CPUIsland island({}, CPUIsland::Type::GENERIC, "frozen", opps, model);
+    EXPECT_TRUE(model->isFrozen());
+    EXPECT_TRUE(island.getCPUModel()->isFrozen());
+}
@@ -0,0 +1,59 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <rtsim/thermalmodel.hpp>
+
+using RTSim::ThermalModel;
+
+namespace {
+    // Advances the model by steps of 10 ms up to 1 s, reading the
+    // temperatures at each step; the input changes at 0.5 s
+    template <class Model>
+    std::vector<double> simulate(Model &model) {
+        const std::vector<double> T0 = {25, 25};
+        const std::vector<double> P0 = {1, 1};
+        const std::vector<double> P1 = {2, 0};
+
+        model.initial(T0).input(P0, 25);
+        for (int i = 1; i <= 100; ++i) {
+            model.advance(i * 0.01);
+            if (i == 50)
+                model.input(P1, 25);
+            model.curtemp();
+        }
+        return model.curtemp();
+    }
+} // namespace
+
+TEST(Thermal, ThermalModel) {
+    // Two cores with C = 1 and Re = 2, the diagonal of R is ignored
+    const std::vector<double> R = {0, 1, 1, 0};
+
+    // With the same power on both cores there is no flow between them:
+    // T(t) = Te + P * Re * (1 - exp(-t / (Re * C)))
+    ThermalModel<2> lazy(1, 2, R.data());
+    lazy.initial(std::vector<double>{25, 25})
+        .input(std::vector<double>{1, 1}, 25);
+    for (int i = 1; i <= 100; ++i)
+        lazy.advance(i * 0.01);
+    for (double T : lazy.curtemp())
+        EXPECT_NEAR(T, 25 + 2 * (1 - std::exp(-0.5)), 1e-9);
+
+    // Fixed and dynamic size, with the cache and splitting the intervals
+    // in powers of two of the quantum give the same temperatures
+    ThermalModel<2> fixed(1, 2, R);
+    ThermalModel<> dynamic(1, 2, R);
+    ThermalModel<2> split(1, 2, R);
+    split.cacheSize(0).quantum(0.01);
+    EXPECT_EQ(dynamic.cpus(), 2);
+
+    std::vector<double> expected = simulate(fixed);
+    EXPECT_GT(expected[0], expected[1]);
+    for (const auto &T : {simulate(dynamic), simulate(split)}) {
+        ASSERT_EQ(T.size(), expected.size());
+        for (size_t i = 0; i < T.size(); ++i)
+            EXPECT_NEAR(T[i], expected[i], 1e-9);
+    }
+}